@@ -0,0 +1,52 @@
+#include "bench_common.hpp"
+#include <benchmark/benchmark.h>
+
+namespace {
+
+// Operands below a prime modulus of state.range(0) bits.
+struct BigIntOperands {
+    BigInt modulus, a, b;
+
+    explicit BigIntOperands(size_t bits)
+        : modulus(BigInt::nextPrime(BigInt(1UL).leftShift(bits - 1) + BigInt(1UL), 0)), a(randomBelow(modulus)),
+          b(randomBelow(modulus)) {}
+};
+
+void BM_BigIntAdd(benchmark::State& state) {
+    const BigIntOperands in(state.range(0));
+    for (auto _ : state) benchmark::DoNotOptimize(in.a + in.b);
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_BigIntMul(benchmark::State& state) {
+    const BigIntOperands in(state.range(0));
+    for (auto _ : state) benchmark::DoNotOptimize(in.a * in.b);
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_BigIntMulMod(benchmark::State& state) {
+    const BigIntOperands in(state.range(0));
+    for (auto _ : state) benchmark::DoNotOptimize(mulMod(in.a, in.b, in.modulus));
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_BigIntModInverse(benchmark::State& state) {
+    const BigIntOperands in(state.range(0));
+    const BigInt a = in.a + BigInt(1UL);
+    for (auto _ : state) benchmark::DoNotOptimize(a.modInverse(in.modulus));
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_BigIntModPow(benchmark::State& state) {
+    const BigIntOperands in(state.range(0));
+    for (auto _ : state) benchmark::DoNotOptimize(in.a.modPow(in.b, in.modulus));
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK(BM_BigIntAdd)->Arg(256)->Arg(521)->Arg(1024);
+BENCHMARK(BM_BigIntMul)->Arg(256)->Arg(521)->Arg(1024);
+BENCHMARK(BM_BigIntMulMod)->Arg(256)->Arg(521)->Arg(1024);
+BENCHMARK(BM_BigIntModInverse)->Arg(256)->Arg(521)->Arg(1024);
+BENCHMARK(BM_BigIntModPow)->Arg(256)->Arg(521)->Arg(1024);
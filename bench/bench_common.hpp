@@ -0,0 +1,88 @@
+/**
+ * @file bench_common.hpp
+ * @brief Deterministic inputs shared by the benchmarks.
+ *
+ * Every benchmark draws its operands from a fixed-seed generator, so runs on
+ * different commits measure the same work and their JSON results compare.
+ */
+
+#ifndef BENCH_COMMON_HPP
+#define BENCH_COMMON_HPP
+
+#include "../include/bigint.hpp"
+#include "../include/curves.hpp"
+#include "../include/jacobian.hpp"
+#include <gmp.h>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+/**
+ * @brief Get the generator all benchmark inputs come from.
+ * @return A Mersenne Twister with a fixed seed.
+ */
+inline std::mt19937_64& benchRng() {
+    static std::mt19937_64 rng(0x5eed);
+    return rng;
+}
+
+/**
+ * @brief Random limbs.
+ * @param n Number of limbs.
+ * @return n uniformly random 64-bit limbs.
+ */
+inline std::vector<mp_limb_t> randomLimbs(size_t n) {
+    std::vector<mp_limb_t> limbs(n);
+    for (size_t i = 0; i < n; ++i) limbs[i] = benchRng()();
+    return limbs;
+}
+
+/**
+ * @brief A random number below a modulus.
+ * @param modulus The bound, positive.
+ * @return A value in [0, modulus), close to uniform.
+ */
+inline BigInt randomBelow(const BigInt& modulus) {
+    const std::vector<mp_limb_t> limbs = randomLimbs((modulus.bitSize() + 63) / 64 + 1);
+    return BigInt::fromLimbs(limbs.data(), limbs.size()) % modulus;
+}
+
+/**
+ * @brief A random element of a fixed-width field.
+ * @tparam F The field type.
+ * @param field The field.
+ * @return field.fromBigInt() of a random value below the modulus.
+ */
+template <class F>
+typename F::Element randomElement(const F& field) {
+    return field.fromBigInt(randomBelow(field.getMod()));
+}
+
+/**
+ * @brief The affine points G, 2G, ..., count G of a curve, built once and kept for later benchmarks.
+ * @tparam C The curve trait, Curve<Tag>.
+ * @param count Number of points needed.
+ * @return A table of at least count distinct points.
+ */
+template <class C>
+const std::vector<AffinePoint<typename C::Field> >& curvePoints(size_t count) {
+    typedef typename C::Field Field;
+    static std::vector<AffinePoint<Field> > points;
+    if (points.size() >= count) return points;
+
+    const JacobianCurve<Field>& curve = C::arithmetic();
+    AffinePoint<Field> G;
+    mpn_copyi(G.x.limbs, C::GX, C::LIMBS);
+    mpn_copyi(G.y.limbs, C::GY, C::LIMBS);
+    G.infinity = false;
+
+    std::vector<JacobianPoint<Field> > jacobian(count);
+    curve.fromAffine(jacobian[0], G);
+    for (size_t i = 1; i < count; ++i) curve.madd(jacobian[i], jacobian[i - 1], G);
+    points.resize(count);
+    curve.toAffineBatch(points.data(), jacobian.data(), count);
+    return points;
+}
+
+#endif // BENCH_COMMON_HPP
@@ -0,0 +1,125 @@
+#include "bench_common.hpp"
+#include "../include/ecc.hpp"
+#include <benchmark/benchmark.h>
+
+namespace {
+
+Ecc_Point generator(CurveId id) { return Ecc_Point::multiplyGenerator(BigInt(1UL), id); }
+
+Ecc_Point randomPoint(CurveId id) {
+    return Ecc_Point::multiplyGenerator(randomBelow(CurveContext::instance(id).params().n), id);
+}
+
+BigInt randomScalar(CurveId id) { return randomBelow(CurveContext::instance(id).params().n); }
+
+// Jacobian formulas, the inner loop of every scalar multiplication and MSM.
+template <class C>
+void BM_JacobianAdd(benchmark::State& state) {
+    const JacobianCurve<typename C::Field>& curve = C::arithmetic();
+    const std::vector<AffinePoint<typename C::Field> >& points = curvePoints<C>(2);
+    JacobianPoint<typename C::Field> R, Q;
+    curve.fromAffine(R, points[0]);
+    curve.fromAffine(Q, points[1]);
+    curve.dbl(Q, Q);
+    for (auto _ : state) {
+        curve.add(R, R, Q);
+        benchmark::DoNotOptimize(R);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <class C>
+void BM_JacobianMixedAdd(benchmark::State& state) {
+    const JacobianCurve<typename C::Field>& curve = C::arithmetic();
+    const std::vector<AffinePoint<typename C::Field> >& points = curvePoints<C>(2);
+    JacobianPoint<typename C::Field> R;
+    curve.fromAffine(R, points[1]);
+    for (auto _ : state) {
+        curve.madd(R, R, points[0]);
+        benchmark::DoNotOptimize(R);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <class C>
+void BM_JacobianDouble(benchmark::State& state) {
+    const JacobianCurve<typename C::Field>& curve = C::arithmetic();
+    JacobianPoint<typename C::Field> R;
+    curve.fromAffine(R, curvePoints<C>(1)[0]);
+    for (auto _ : state) {
+        curve.dbl(R, R);
+        benchmark::DoNotOptimize(R);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Affine Ecc_Point operations, including the conversions and the inversion they pay for.
+void BM_PointAdd(benchmark::State& state, CurveId id) {
+    const Ecc_Point P = randomPoint(id), Q = randomPoint(id);
+    for (auto _ : state) benchmark::DoNotOptimize(P + Q);
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_PointDouble(benchmark::State& state, CurveId id) {
+    const Ecc_Point P = randomPoint(id);
+    for (auto _ : state) benchmark::DoNotOptimize(P + P);
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_ScalarMul(benchmark::State& state, CurveId id) {
+    const Ecc_Point P = randomPoint(id);
+    const BigInt k = randomScalar(id);
+    for (auto _ : state) benchmark::DoNotOptimize(P * k);
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_ScalarMulConstantTime(benchmark::State& state, CurveId id) {
+    const Ecc_Point P = randomPoint(id);
+    const BigInt k = randomScalar(id);
+    for (auto _ : state) benchmark::DoNotOptimize(P.multiply(k, ScalarMulMode::ConstantTime));
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_GeneratorMul(benchmark::State& state, CurveId id) {
+    const BigInt k = randomScalar(id);
+    for (auto _ : state) benchmark::DoNotOptimize(Ecc_Point::multiplyGenerator(k, id));
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_GeneratorMulConstantTime(benchmark::State& state, CurveId id) {
+    const BigInt k = randomScalar(id);
+    for (auto _ : state) benchmark::DoNotOptimize(Ecc_Point::multiplyGenerator(k, id, ScalarMulMode::ConstantTime));
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_DoubleScalarMul(benchmark::State& state, CurveId id) {
+    const Ecc_Point G = generator(id), Q = randomPoint(id);
+    const BigInt k1 = randomScalar(id), k2 = randomScalar(id);
+    for (auto _ : state) benchmark::DoNotOptimize(doubleScalarMul(k1, G, k2, Q));
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_JacobianAdd, Curve<P256>);
+BENCHMARK_TEMPLATE(BM_JacobianAdd, Curve<Secp256k1>);
+BENCHMARK_TEMPLATE(BM_JacobianAdd, Curve<P521>);
+BENCHMARK_TEMPLATE(BM_JacobianMixedAdd, Curve<P256>);
+BENCHMARK_TEMPLATE(BM_JacobianMixedAdd, Curve<Secp256k1>);
+BENCHMARK_TEMPLATE(BM_JacobianMixedAdd, Curve<P521>);
+BENCHMARK_TEMPLATE(BM_JacobianDouble, Curve<P256>);
+BENCHMARK_TEMPLATE(BM_JacobianDouble, Curve<Secp256k1>);
+BENCHMARK_TEMPLATE(BM_JacobianDouble, Curve<P521>);
+
+#define CURVE_BENCHMARK(fn)                                                                                            \
+    BENCHMARK_CAPTURE(fn, P256, CurveId::P256);                                                                        \
+    BENCHMARK_CAPTURE(fn, Secp256k1, CurveId::Secp256k1);                                                              \
+    BENCHMARK_CAPTURE(fn, P521, CurveId::P521)
+
+CURVE_BENCHMARK(BM_PointAdd);
+CURVE_BENCHMARK(BM_PointDouble);
+CURVE_BENCHMARK(BM_ScalarMul);
+CURVE_BENCHMARK(BM_ScalarMulConstantTime);
+CURVE_BENCHMARK(BM_GeneratorMul);
+CURVE_BENCHMARK(BM_GeneratorMulConstantTime);
+CURVE_BENCHMARK(BM_DoubleScalarMul);
@@ -0,0 +1,68 @@
+#include "bench_common.hpp"
+#include "../include/pairing.hpp"
+#include <benchmark/benchmark.h>
+#include <string>
+
+namespace {
+
+typedef PairingCurve<BN254>::Field Bn254Field;
+
+const Bn254Field& bn254Field() { return PairingCurve<BN254>::engine().field(); }
+
+template <class F>
+void BM_FieldMul(benchmark::State& state, const F& (*field)()) {
+    const F& f = field();
+    typename F::Element a = randomElement(f), b = randomElement(f);
+    for (auto _ : state) {
+        f.mul(a, a, b);
+        benchmark::DoNotOptimize(a);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <class F>
+void BM_FieldSqr(benchmark::State& state, const F& (*field)()) {
+    const F& f = field();
+    typename F::Element a = randomElement(f);
+    for (auto _ : state) {
+        f.sqr(a, a);
+        benchmark::DoNotOptimize(a);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <class F>
+void BM_FieldInv(benchmark::State& state, const F& (*field)()) {
+    const F& f = field();
+    typename F::Element a = randomElement(f);
+    for (auto _ : state) {
+        f.inv(a, a);
+        benchmark::DoNotOptimize(a);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <class F>
+void BM_FieldInvFermat(benchmark::State& state, const F& (*field)()) {
+    const F& f = field();
+    typename F::Element a = randomElement(f);
+    for (auto _ : state) {
+        f.invFermat(a, a);
+        benchmark::DoNotOptimize(a);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// One set of benchmarks per field, named BM_Field<Op>/<field>.
+template <class F>
+void registerField(const std::string& name, const F& (*field)()) {
+    benchmark::RegisterBenchmark(("BM_FieldMul/" + name).c_str(), BM_FieldMul<F>, field);
+    benchmark::RegisterBenchmark(("BM_FieldSqr/" + name).c_str(), BM_FieldSqr<F>, field);
+    benchmark::RegisterBenchmark(("BM_FieldInv/" + name).c_str(), BM_FieldInv<F>, field);
+    benchmark::RegisterBenchmark(("BM_FieldInvFermat/" + name).c_str(), BM_FieldInvFermat<F>, field);
+}
+
+const bool registered = (registerField("P256", &Curve<P256>::field), registerField("Secp256k1", &Curve<Secp256k1>::field),
+                         registerField("P521", &Curve<P521>::field), registerField("BN254Montgomery", &bn254Field), true);
+
+} // namespace
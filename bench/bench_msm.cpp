@@ -0,0 +1,57 @@
+#include "bench_common.hpp"
+#include "../include/ecc.hpp"
+#include "../include/msm.hpp"
+#include "../include/thread_pool.hpp"
+#include <benchmark/benchmark.h>
+
+namespace {
+
+// Pippenger over 2^range(0) points straight from the affine table; range(1) selects the shared pool.
+template <class C>
+void BM_Msm(benchmark::State& state) {
+    typedef typename C::Field Field;
+    const size_t count = static_cast<size_t>(1) << state.range(0);
+    ThreadPool* pool = state.range(1) ? &ThreadPool::shared() : nullptr;
+    const std::vector<AffinePoint<Field> >& points = curvePoints<C>(count);
+    const std::vector<mp_limb_t> scalars = randomLimbs(count * C::LIMBS);
+    JacobianPoint<Field> R;
+    for (auto _ : state) {
+        pippengerMsm(C::arithmetic(), R, points.data(), scalars.data(), count, C::LIMBS, 64 * C::LIMBS, 0, pool);
+        benchmark::DoNotOptimize(R);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+// The Ecc_Point front end, including the conversion of points and scalars.
+void BM_MultiScalarMul(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(1) << state.range(0);
+    const BigInt& n = CurveContext::instance(CurveId::P256).params().n;
+    std::vector<Ecc_Point> points;
+    std::vector<BigInt> scalars;
+    for (size_t i = 0; i < count; ++i) {
+        points.push_back(Ecc_Point::multiplyGenerator(randomBelow(n), CurveId::P256));
+        scalars.push_back(randomBelow(n));
+    }
+    for (auto _ : state) benchmark::DoNotOptimize(multiScalarMul(points, scalars, 1));
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+void msmSizes(benchmark::internal::Benchmark* b, int maxLog) {
+    for (int log = 10; log <= maxLog; log += 2) {
+        b->Args({log, 0});
+        b->Args({log, 1});
+    }
+    b->Unit(benchmark::kMillisecond);
+}
+
+void msmSizes256(benchmark::internal::Benchmark* b) { msmSizes(b, 20); }
+
+// 2^20 points of P-521 take a quarter of a gigabyte to build; stop one size earlier.
+void msmSizes521(benchmark::internal::Benchmark* b) { msmSizes(b, 18); }
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_Msm, Curve<P256>)->Apply(msmSizes256);
+BENCHMARK_TEMPLATE(BM_Msm, Curve<Secp256k1>)->Apply(msmSizes256);
+BENCHMARK_TEMPLATE(BM_Msm, Curve<P521>)->Apply(msmSizes521);
+BENCHMARK(BM_MultiScalarMul)->DenseRange(10, 14, 2)->Unit(benchmark::kMillisecond);
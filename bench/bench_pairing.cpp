@@ -0,0 +1,68 @@
+#include "bench_common.hpp"
+#include "../include/pairing.hpp"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+namespace {
+
+template <class Tag>
+struct PairingInputs {
+    typedef PairingEngine<typename PairingCurve<Tag>::Field> Engine;
+
+    const Engine& engine;
+    typename Engine::G1 P;
+    typename Engine::G2 Q;
+
+    PairingInputs() : engine(PairingCurve<Tag>::engine()) {
+        engine.mul(P, engine.g1Generator(), randomBelow(engine.order()));
+        engine.mul(Q, engine.g2Generator(), randomBelow(engine.order()));
+    }
+};
+
+template <class Tag>
+void BM_Pairing(benchmark::State& state) {
+    const PairingInputs<Tag> in;
+    typename PairingInputs<Tag>::Engine::GT out;
+    for (auto _ : state) {
+        in.engine.pairing(out, in.P, in.Q);
+        benchmark::DoNotOptimize(out);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <class Tag>
+void BM_FinalExponentiation(benchmark::State& state) {
+    const PairingInputs<Tag> in;
+    const typename PairingInputs<Tag>::Engine::Prepared Q = in.engine.prepare(in.Q);
+    typename PairingInputs<Tag>::Engine::GT f, out;
+    in.engine.millerLoop(f, &in.P, &Q, 1);
+    for (auto _ : state) {
+        in.engine.finalExponentiation(out, f);
+        benchmark::DoNotOptimize(out);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// range(0) pairs with prepared G2 points, one shared Miller loop and final exponentiation.
+template <class Tag>
+void BM_MultiPairing(benchmark::State& state) {
+    const PairingInputs<Tag> in;
+    const size_t count = state.range(0);
+    const std::vector<typename PairingInputs<Tag>::Engine::G1> P(count, in.P);
+    const std::vector<typename PairingInputs<Tag>::Engine::Prepared> Q(count, in.engine.prepare(in.Q));
+    typename PairingInputs<Tag>::Engine::GT out;
+    for (auto _ : state) {
+        in.engine.multiPairing(out, P.data(), Q.data(), count);
+        benchmark::DoNotOptimize(out);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_Pairing, BN254)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_Pairing, BLS12_381)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_FinalExponentiation, BN254)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_FinalExponentiation, BLS12_381)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_MultiPairing, BN254)->Arg(4)->Arg(16)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_MultiPairing, BLS12_381)->Arg(4)->Arg(16)->Unit(benchmark::kMicrosecond);
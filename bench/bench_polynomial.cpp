@@ -0,0 +1,83 @@
+#include "bench_common.hpp"
+#include "../include/field.hpp"
+#include "../include/interpolation.hpp"
+#include "../include/ntt.hpp"
+#include "../include/pairing.hpp"
+#include "../include/polynomial.hpp"
+#include "../include/thread_pool.hpp"
+#include <benchmark/benchmark.h>
+#include <string>
+
+namespace {
+
+// The BN254 group order, the scalar field of SNARKs over BN254; it has roots of unity of order 2^28.
+const BigInt& scalarModulus() { return PairingCurve<BN254>::engine().order(); }
+
+Polynomial randomPolynomial(size_t size) {
+    std::vector<BigInt> coefficients;
+    for (size_t i = 0; i < size; ++i) coefficients.push_back(randomBelow(scalarModulus()));
+    return Polynomial(coefficients, scalarModulus());
+}
+
+std::vector<BigInt> randomValues(size_t count) {
+    std::vector<BigInt> values;
+    for (size_t i = 0; i < count; ++i) values.push_back(randomBelow(scalarModulus()));
+    return values;
+}
+
+// The product of two polynomials of 2^range(0) coefficients, on a single thread.
+void BM_MultiplyPolynomials(benchmark::State& state) {
+    const size_t size = static_cast<size_t>(1) << state.range(0);
+    const Polynomial a = randomPolynomial(size), b = randomPolynomial(size);
+    Polynomial result(static_cast<size_t>(0), scalarModulus());
+    for (auto _ : state) {
+        multiplyPolynomials(result, a, b, 1);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// A forward transform of 2^range(0) Montgomery elements; range(1) selects the shared pool.
+void BM_NttForward(benchmark::State& state) {
+    typedef MontgomeryField<4> Field;
+    const size_t size = static_cast<size_t>(1) << state.range(0);
+    ThreadPool* pool = state.range(1) ? &ThreadPool::shared() : nullptr;
+    const Field field(scalarModulus());
+    const NttDomain<Field> domain(field, size);
+    std::vector<Field::Element> values(size);
+    for (size_t i = 0; i < size; ++i) values[i] = randomElement(field);
+    for (auto _ : state) {
+        domain.forward(values.data(), pool);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Lagrange evaluation of the polynomial through range(0) points at one more point.
+void BM_Interpolate(benchmark::State& state) {
+    const size_t count = state.range(0);
+    const std::string mod = scalarModulus().toString();
+    std::vector<Data> points;
+    for (size_t i = 0; i < count; ++i) {
+        points.push_back(Data(std::to_string(i + 1), randomBelow(scalarModulus()).toString(), mod));
+    }
+    const BigInt xi = randomBelow(scalarModulus());
+    for (auto _ : state) benchmark::DoNotOptimize(interpolate(points, xi, mod));
+    state.SetItemsProcessed(state.iterations());
+}
+
+// The coefficients of the polynomial through 2^range(0) points, with the subproduct tree prebuilt.
+void BM_InterpolatorInterpolate(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(1) << state.range(0);
+    const Interpolator interpolator(randomValues(count), scalarModulus(), 1);
+    const std::vector<BigInt> ys = randomValues(count);
+    for (auto _ : state) benchmark::DoNotOptimize(interpolator.interpolate(ys));
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK(BM_MultiplyPolynomials)->DenseRange(4, 16, 2)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_NttForward)->ArgsProduct({benchmark::CreateDenseRange(10, 20, 2), {0, 1}})->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Interpolate)->RangeMultiplier(4)->Range(16, 1024)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_InterpolatorInterpolate)->DenseRange(8, 14, 2)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,30 @@
+#include "../include/bigint.hpp"
+#include "../include/interpolation.hpp"
+#include <iostream>
+#include <vector>
+
+int main() {
+    std::vector<Data> points = {
+        Data("1", "1", "101"),   // 1^2 = 1
+        Data("2", "4", "101"),   // 2^2 = 4
+        Data("3", "9", "101"),   // 3^2 = 9
+        Data("4", "16", "101"),  // 4^2 = 16
+        Data("5", "25", "101")   // 5^2 = 25
+    };
+
+    BigInt xi("6", 10);  // Expecting 6^2 = 36
+    BigInt interpolatedValue = interpolate(points, xi, "101");
+    std::cout << "Interpolated Value at x=6: ";
+    interpolatedValue.print();
+
+    std::vector<BigInt> xs, ys;
+    for (const Data& point : points) {
+        xs.push_back(point.x);
+        ys.push_back(point.y);
+    }
+    Interpolator interpolator(xs, BigInt("101", 10));
+    std::cout << "Interpolating polynomial: ";
+    interpolator.interpolate(ys).print();
+
+    return 0;
+}
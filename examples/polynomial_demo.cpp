@@ -0,0 +1,60 @@
+#include "../include/bigint.hpp"
+#include "../include/polynomial.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+
+int main() {
+    std::vector<std::string> coeffs1 = {"1", "-2", "3","15"};
+    Polynomial poly1(coeffs1, "7");
+
+    std::cout << "Polynomial 1: ";
+    poly1.print();
+
+    std::vector<std::string> coeffs2 = {"-3", "4", "2"};
+    Polynomial poly2(coeffs2, "7");
+
+    std::cout << "Polynomial 2: ";
+    poly2.print();
+
+    Polynomial result({}, "7");
+
+    addPolynomials(result, poly1, poly2);
+
+    std::cout << "Result of addition: ";
+    result.print();
+
+    subtractPolynomials(result, poly1, poly2);
+
+    std::cout << "Result of substraction: ";
+    result.print();
+
+    Polynomial result1({}, "7");
+
+    multiplyPolynomials(result1, poly1, poly2);
+
+    std::cout << "Result of multiplication: ";
+    result1.print();
+
+
+    std::vector<std::string> coeffs = {"1", "2", "3"};
+    Polynomial poly(coeffs, "7"); // Modulus is 7
+
+    // Define scalars for multiplication and division
+    BigInt scalarMult("2", 10);
+    BigInt scalarDiv("3", 10);
+
+    // Test multiplication by scalar
+    Polynomial resultMult({}, "7");
+    multiplyPolynomialByScalar(resultMult, poly, scalarMult);
+    std::cout << "Result of multiplication by scalar: ";
+    resultMult.print();
+
+    // Test division by scalar
+    Polynomial resultDiv({}, "7");
+    dividePolynomialByScalar(resultDiv, poly, scalarDiv);
+    std::cout << "Result of division by scalar: ";
+    resultDiv.print();
+
+    return 0;
+}
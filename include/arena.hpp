@@ -0,0 +1,87 @@
+/**
+ * @file arena.hpp
+ * @brief Scoped bump allocation for the limbs of GMP integers.
+ *
+ * While a BigIntArena is alive on a thread, every GMP allocation made by that
+ * thread is carved out of 256 KiB chunks by bumping a pointer; the most recent
+ * block is grown in place and freeing it rewinds the pointer. Other frees only
+ * count down the live blocks of a chunk, which is recycled as a whole once the
+ * arena has moved past it and its last block is gone. The temporaries of a
+ * batch of operations thus cost a few atomic increments instead of malloc/free
+ * pairs on a shared heap. No library function opens an arena by itself;
+ * callers open one around a proof or a batch, on each thread that does the work.
+ *
+ * The allocation functions are installed process-wide with
+ * mp_set_memory_functions() by the first arena (or by install()) and stay
+ * installed. Threads without an arena fall through to the previous functions
+ * after one range check. Values may outlive the arena they were allocated in,
+ * they just keep their chunk alive; they may also be freed on another thread.
+ * Memory obtained from GMP directly, e.g. the string of mpz_get_str(), must be
+ * released with the free function of mp_get_memory_functions(), as GMP requires.
+ */
+
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <cstddef>
+
+/**
+ * @class BigIntArena
+ * @brief Routes the GMP allocations of the current thread into chunks for its lifetime.
+ *
+ * Arenas nest: the innermost one on a thread serves the allocations. They must
+ * be destroyed on the thread that created them, in reverse order of creation.
+ */
+class BigIntArena {
+public:
+    /**
+     * @brief Size of the chunks blocks are bumped from; larger blocks go to the heap.
+     */
+    static const size_t CHUNK_BYTES = 1 << 18;
+
+    /**
+     * @brief Starts serving the GMP allocations of the calling thread.
+     */
+    BigIntArena();
+
+    /**
+     * @brief Returns the allocations of the calling thread to the enclosing arena or the heap.
+     */
+    ~BigIntArena();
+
+    /**
+     * @brief Get the bytes handed out by this arena so far.
+     * @return The total size of the blocks allocated in chunks.
+     */
+    size_t bytesAllocated() const { return bytes; }
+
+    /**
+     * @brief Installs the GMP allocation functions ahead of time.
+     *
+     * mp_set_memory_functions() is not synchronized with other threads calling
+     * into GMP, so a program that creates its first arena while other threads
+     * are busy should call this at startup.
+     *
+     * @return False if the address range for the chunks could not be reserved;
+     *         arenas then leave every allocation to the heap.
+     */
+    static bool install();
+
+private:
+    BigIntArena(const BigIntArena&) = delete;
+    BigIntArena& operator=(const BigIntArena&) = delete;
+
+    friend struct ArenaHooks;
+
+    void* allocate(size_t size);
+    bool grow(void* block, size_t oldSize, size_t newSize);
+    void rewind(void* block, size_t size);
+    bool nextChunk();
+
+    BigIntArena* previous; ///< Enclosing arena of the thread.
+    size_t chunk;          ///< Chunk being bumped, or the chunk count if none.
+    size_t offset;         ///< First free byte in the chunk.
+    size_t bytes;
+};
+
+#endif // ARENA_HPP
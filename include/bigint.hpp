@@ -41,6 +41,12 @@ public:
      */
     BigInt(const BigInt &other);
 
+    /**
+     * @brief Move constructor. Takes over the storage of other, leaving it zero.
+     * @param other The BigInt to move from.
+     */
+    BigInt(BigInt &&other) noexcept;
+
     /**
      * @brief Constructor to initialize a BigInt from a GMP mpz_t.
      * @param bi The GMP mpz_t to initialize from.
@@ -57,35 +63,112 @@ public:
      * @param other The BigInt to add.
      * @return The result of the addition.
      */
-    BigInt operator+(const BigInt &other) const;
+    BigInt operator+(const BigInt &other) const &;
+
+    /**
+     * @brief Addition reusing the storage of this dying value.
+     * @param other The BigInt to add.
+     * @return The result of the addition.
+     */
+    BigInt operator+(const BigInt &other) &&;
+
+    /**
+     * @brief Addition reusing the storage of a dying right operand.
+     * @param other The BigInt to add.
+     * @return The result of the addition.
+     */
+    BigInt operator+(BigInt &&other) const &;
+
+    /**
+     * @brief Addition of two dying values, reusing the storage of this one.
+     * @param other The BigInt to add.
+     * @return The result of the addition.
+     */
+    BigInt operator+(BigInt &&other) &&;
 
     /**
      * @brief Subtraction operator.
      * @param other The BigInt to subtract.
      * @return The result of the subtraction.
      */
-    BigInt operator-(const BigInt &other) const;
+    BigInt operator-(const BigInt &other) const &;
+
+    /**
+     * @brief Subtraction reusing the storage of this dying value.
+     * @param other The BigInt to subtract.
+     * @return The result of the subtraction.
+     */
+    BigInt operator-(const BigInt &other) &&;
+
+    /**
+     * @brief Subtraction reusing the storage of a dying right operand.
+     * @param other The BigInt to subtract.
+     * @return The result of the subtraction.
+     */
+    BigInt operator-(BigInt &&other) const &;
+
+    /**
+     * @brief Subtraction of two dying values, reusing the storage of this one.
+     * @param other The BigInt to subtract.
+     * @return The result of the subtraction.
+     */
+    BigInt operator-(BigInt &&other) &&;
 
     /**
      * @brief Multiplication operator.
      * @param other The BigInt to multiply by.
      * @return The result of the multiplication.
      */
-    BigInt operator*(const BigInt &other) const;
+    BigInt operator*(const BigInt &other) const &;
+
+    /**
+     * @brief Multiplication reusing the storage of this dying value.
+     * @param other The BigInt to multiply by.
+     * @return The result of the multiplication.
+     */
+    BigInt operator*(const BigInt &other) &&;
+
+    /**
+     * @brief Multiplication reusing the storage of a dying right operand.
+     * @param other The BigInt to multiply by.
+     * @return The result of the multiplication.
+     */
+    BigInt operator*(BigInt &&other) const &;
+
+    /**
+     * @brief Multiplication of two dying values, reusing the storage of this one.
+     * @param other The BigInt to multiply by.
+     * @return The result of the multiplication.
+     */
+    BigInt operator*(BigInt &&other) &&;
 
     /**
      * @brief Division operator.
      * @param other The BigInt to divide by.
      * @return The result of the division.
      */
-    BigInt operator/(const BigInt &other) const;
+    BigInt operator/(const BigInt &other) const &;
+
+    /**
+     * @brief Division reusing the storage of this dying value.
+     * @param other The BigInt to divide by.
+     * @return The result of the division.
+     */
+    BigInt operator/(const BigInt &other) &&;
 
     /**
      * @brief Modulus operator.
      * @param other The BigInt to take modulus with.
      * @return The result of the modulus operation.
      */
-    BigInt operator%(const BigInt &other) const;
+    BigInt operator%(const BigInt &other) const &;
+
+    /**
+     * @brief Modulus reusing the storage of this dying value, e.g. in (a * b) % m.
+     * @param other The BigInt to take modulus with.
+     * @return The result of the modulus operation.
+     */
+    BigInt operator%(const BigInt &other) &&;
 
     /**
      * @brief Assignment operator.
@@ -94,6 +177,19 @@ public:
      */
     BigInt& operator=(const BigInt &other);
 
+    /**
+     * @brief Move assignment operator. Swaps the storage with other.
+     * @param other The BigInt to move from.
+     * @return Reference to this BigInt after assignment.
+     */
+    BigInt& operator=(BigInt &&other) noexcept;
+
+    /**
+     * @brief Exchange the values of two BigInts without copying.
+     * @param other The BigInt to swap with.
+     */
+    void swap(BigInt &other) noexcept;
+
     /**
      * @brief Addition assignment operator.
      * @param other The BigInt to add.
@@ -129,6 +225,22 @@ public:
      */
     BigInt& operator%=(const BigInt &other);
 
+    /**
+     * @brief Fused multiply-add, this += a * b without a temporary.
+     * @param a The first factor.
+     * @param b The second factor.
+     * @return Reference to this BigInt after the update.
+     */
+    BigInt& addmul(const BigInt &a, const BigInt &b);
+
+    /**
+     * @brief Fused multiply-subtract, this -= a * b without a temporary.
+     * @param a The first factor.
+     * @param b The second factor.
+     * @return Reference to this BigInt after the update.
+     */
+    BigInt& submul(const BigInt &a, const BigInt &b);
+
     /**
      * @brief Equality operator.
      * @param other The BigInt to compare with.
@@ -220,6 +332,35 @@ public:
      */
     BigInt modInverse(const BigInt& modulus) const;
 
+    /**
+     * @brief Modular exponentiation by sliding windows.
+     * @param exponent The exponent; a negative exponent raises the modular inverse.
+     * @param modulus The modulus, positive.
+     * @return The BigInt to the power exponent, modulo modulus, in [0, modulus).
+     * @throw std::invalid_argument If the modulus is not positive.
+     * @throw std::runtime_error If the exponent is negative and the BigInt is not invertible.
+     */
+    BigInt modPow(const BigInt& exponent, const BigInt& modulus) const;
+
+    /**
+     * @brief Modular exponentiation by fixed windows in data-independent time.
+     *
+     * Every window of the exponent costs the same sequence of operations and the
+     * table lookups touch every entry, so the running time and memory accesses
+     * only depend on the operand sizes. Use it when the exponent is secret.
+     *
+     * Fixed public exponents such as p - 2 and (p + 1) / 4 are recoded once per
+     * field by FixedExponent and the addition chains of the fixed-width fields
+     * (see field.hpp); for BigInt operands modPow() is already faster than
+     * replaying such a plan outside GMP.
+     *
+     * @param exponent The exponent, non-negative.
+     * @param modulus The modulus, odd and positive.
+     * @return The BigInt to the power exponent, modulo modulus, in [0, modulus).
+     * @throw std::invalid_argument If the exponent is negative or the modulus is not odd and positive.
+     */
+    BigInt modPowSecure(const BigInt& exponent, const BigInt& modulus) const;
+
     /**
      * @brief Print the absolute value of the BigInt.
      */
@@ -281,8 +422,105 @@ public:
      */
     BigInt rightShift(unsigned long int shiftBy) const;
 
+    /**
+     * @brief Test a single bit of the BigInt.
+     * @param index The bit position, 0 being the least significant bit.
+     * @return True if the bit is set, false otherwise.
+     */
+    bool testBit(unsigned long int index) const;
+
+    /**
+     * @brief Export the absolute value into a fixed-width little-endian limb buffer.
+     *
+     * Limbs above the size of the value are written as zero. The caller must make
+     * sure the value fits in n limbs; higher limbs are silently dropped.
+     *
+     * @param out Destination buffer of at least n limbs.
+     * @param n Number of limbs to write.
+     */
+    void toLimbs(mp_limb_t* out, size_t n) const;
+
+    /**
+     * @brief Construct a non-negative BigInt from a little-endian limb buffer.
+     * @param limbs Source limbs, least significant first.
+     * @param n Number of limbs to read.
+     * @return The BigInt holding the value of the limbs.
+     */
+    static BigInt fromLimbs(const mp_limb_t* limbs, size_t n);
+
+    /**
+     * @brief Export the absolute value as fixed-width little-endian bytes.
+     *
+     * Bytes above the size of the value are written as zero, so every value
+     * of a given bound takes the same space on disk.
+     *
+     * @param out Destination buffer of at least n bytes.
+     * @param n Number of bytes to write.
+     * @throw std::invalid_argument If the value does not fit in n bytes.
+     */
+    void toBytes(unsigned char* out, size_t n) const;
+
+    /**
+     * @brief Construct a non-negative BigInt from little-endian bytes.
+     * @param bytes Source bytes, least significant first.
+     * @param n Number of bytes to read.
+     * @return The BigInt holding the value of the bytes.
+     */
+    static BigInt fromBytes(const unsigned char* bytes, size_t n);
+
 private:
+    friend BigInt addMod(const BigInt& a, const BigInt& b, const BigInt& modulus);
+    friend BigInt subMod(const BigInt& a, const BigInt& b, const BigInt& modulus);
+    friend BigInt mulMod(const BigInt& a, const BigInt& b, const BigInt& modulus);
+
     mpz_t value; // The GMP mpz_t representing the BigInt.
 };
 
+/**
+ * @brief Modular addition in one result allocation.
+ *
+ * Canonical inputs are reduced by at most one subtraction instead of a division.
+ *
+ * @param a The first operand.
+ * @param b The second operand.
+ * @param modulus The modulus, positive.
+ * @return (a + b) mod modulus in [0, modulus).
+ */
+BigInt addMod(const BigInt& a, const BigInt& b, const BigInt& modulus);
+
+/**
+ * @brief Modular subtraction in one result allocation.
+ *
+ * Canonical inputs are reduced by at most one addition instead of a division.
+ *
+ * @param a The first operand.
+ * @param b The operand to subtract.
+ * @param modulus The modulus, positive.
+ * @return (a - b) mod modulus in [0, modulus).
+ */
+BigInt subMod(const BigInt& a, const BigInt& b, const BigInt& modulus);
+
+/**
+ * @brief Modular multiplication in one result allocation.
+ * @param a The first factor.
+ * @param b The second factor.
+ * @param modulus The modulus, positive.
+ * @return (a * b) mod modulus in [0, modulus).
+ */
+BigInt mulMod(const BigInt& a, const BigInt& b, const BigInt& modulus);
+
+/**
+ * @brief Invert many values modulo the same modulus with a single modular inverse.
+ *
+ * Uses Montgomery's simultaneous inversion trick: the values are multiplied
+ * into running prefix products, the total is inverted once and the individual
+ * inverses are peeled off walking backwards, for 1 inversion and 3(n - 1)
+ * modular multiplications.
+ *
+ * @param values The values to invert; replaced by their inverses in [0, modulus).
+ * @param modulus The modulus.
+ * @throw std::runtime_error If one of the values is not invertible.
+ */
+void batchInvert(std::vector<BigInt>& values, const BigInt& modulus);
+
 #endif // BIGINT_HPP
@@ -0,0 +1,243 @@
+/**
+ * @file curves.hpp
+ * @brief Compile-time curve traits and the runtime curve dispatcher.
+ *
+ * Each supported curve is a specialization of Curve<Tag> carrying its
+ * parameters as constexpr limb arrays and its own fast reduction routine.
+ * Code that is generic over the curve is written once as a template and
+ * instantiated for every curve; visitCurve() picks the instantiation at
+ * runtime from a CurveId, so several curves can be served by one binary.
+ */
+
+#ifndef CURVES_HPP
+#define CURVES_HPP
+
+#include "field.hpp"
+#include "jacobian.hpp"
+#include "projective.hpp"
+#include <gmp.h>
+#include <cstddef>
+#include <stdexcept>
+
+/**
+ * @enum CurveId
+ * @brief Runtime identifier of a supported elliptic curve.
+ */
+enum class CurveId {
+    P256,      ///< NIST P-256 (secp256r1).
+    Secp256k1, ///< SEC secp256k1.
+    P521       ///< NIST P-521 (secp521r1).
+};
+
+/// Limbs of the widest supported base field element (P-521).
+const size_t CURVE_MAX_LIMBS = 9;
+
+struct P256 {};      ///< Tag type of NIST P-256.
+struct Secp256k1 {}; ///< Tag type of secp256k1.
+struct P521 {};      ///< Tag type of NIST P-521.
+
+/**
+ * @struct Curve
+ * @brief Compile-time description of a short Weierstrass curve y^2 = x^3 + ax + b.
+ *
+ * Every specialization provides:
+ * - ID, LIMBS and the constexpr limb arrays P, A, B, GX, GY and N (least significant limb first);
+ * - reduce(r, t), reducing a 2 * LIMBS product t into r in [0, p);
+ * - invPower(r, a) and sqrtPower(r, a), raising a to p - 2 and (p + 1) / 4 with fixed addition chains;
+ * - the Field type and the shared field(), arithmetic() and completeArithmetic() singletons.
+ *
+ * @tparam Tag One of P256, Secp256k1 or P521.
+ */
+template <class Tag>
+struct Curve;
+
+/**
+ * @brief NIST P-256, p = 2^256 - 2^224 + 2^192 + 2^96 - 1, reduced with the Solinas method.
+ */
+template <>
+struct Curve<P256> {
+    static const CurveId ID = CurveId::P256; ///< Runtime identifier.
+    static const size_t LIMBS = 4;           ///< Limbs per field element.
+    static constexpr mp_limb_t P[LIMBS] = {0xffffffffffffffffULL, 0x00000000ffffffffULL, 0x0000000000000000ULL, 0xffffffff00000001ULL};
+    static constexpr mp_limb_t A[LIMBS] = {0xfffffffffffffffcULL, 0x00000000ffffffffULL, 0x0000000000000000ULL, 0xffffffff00000001ULL};
+    static constexpr mp_limb_t B[LIMBS] = {0x3bce3c3e27d2604bULL, 0x651d06b0cc53b0f6ULL, 0xb3ebbd55769886bcULL, 0x5ac635d8aa3a93e7ULL};
+    static constexpr mp_limb_t GX[LIMBS] = {0xf4a13945d898c296ULL, 0x77037d812deb33a0ULL, 0xf8bce6e563a440f2ULL, 0x6b17d1f2e12c4247ULL};
+    static constexpr mp_limb_t GY[LIMBS] = {0xcbb6406837bf51f5ULL, 0x2bce33576b315eceULL, 0x8ee7eb4a7c0f9e16ULL, 0x4fe342e2fe1a7f9bULL};
+    static constexpr mp_limb_t N[LIMBS] = {0xf3b9cac2fc632551ULL, 0xbce6faada7179e84ULL, 0xffffffffffffffffULL, 0xffffffff00000000ULL};
+
+    typedef ReducedField<Curve<P256> > Field; ///< Base field type.
+
+    /**
+     * @brief Solinas reduction of a 512-bit product modulo p.
+     * @param r Destination of LIMBS limbs.
+     * @param t The 2 * LIMBS limb product; it is not modified.
+     */
+    static void reduce(mp_limb_t* r, const mp_limb_t* t);
+
+    /**
+     * @brief a^(p - 2) with p - 2 = 2^256 - 2^224 + 2^192 + 2^96 - 3: 255 squarings and 12 multiplications.
+     * @param r Destination; may alias a.
+     * @param a The base.
+     */
+    static void invPower(FieldElement<LIMBS>& r, const FieldElement<LIMBS>& a);
+
+    /**
+     * @brief a^((p + 1) / 4) with (p + 1) / 4 = 2^254 - 2^222 + 2^190 + 2^94: 253 squarings and 7 multiplications.
+     * @param r Destination; may alias a.
+     * @param a The base.
+     */
+    static void sqrtPower(FieldElement<LIMBS>& r, const FieldElement<LIMBS>& a);
+
+    /**
+     * @brief Get the shared base field.
+     * @return The field modulo p.
+     */
+    static const Field& field();
+
+    /**
+     * @brief Get the shared Jacobian point formulas.
+     * @return The point arithmetic over field().
+     */
+    static const JacobianCurve<Field>& arithmetic();
+
+    /**
+     * @brief Get the shared complete projective point formulas.
+     * @return The branch-free point arithmetic over field().
+     */
+    static const ProjectiveCurve<Field>& completeArithmetic();
+};
+
+/**
+ * @brief secp256k1, p = 2^256 - 2^32 - 977, reduced by folding the high half times 2^32 + 977.
+ */
+template <>
+struct Curve<Secp256k1> {
+    static const CurveId ID = CurveId::Secp256k1; ///< Runtime identifier.
+    static const size_t LIMBS = 4;                ///< Limbs per field element.
+    static constexpr mp_limb_t P[LIMBS] = {0xfffffffefffffc2fULL, 0xffffffffffffffffULL, 0xffffffffffffffffULL, 0xffffffffffffffffULL};
+    static constexpr mp_limb_t A[LIMBS] = {0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL};
+    static constexpr mp_limb_t B[LIMBS] = {0x0000000000000007ULL, 0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL};
+    static constexpr mp_limb_t GX[LIMBS] = {0x59f2815b16f81798ULL, 0x029bfcdb2dce28d9ULL, 0x55a06295ce870b07ULL, 0x79be667ef9dcbbacULL};
+    static constexpr mp_limb_t GY[LIMBS] = {0x9c47d08ffb10d4b8ULL, 0xfd17b448a6855419ULL, 0x5da4fbfc0e1108a8ULL, 0x483ada7726a3c465ULL};
+    static constexpr mp_limb_t N[LIMBS] = {0xbfd25e8cd0364141ULL, 0xbaaedce6af48a03bULL, 0xfffffffffffffffeULL, 0xffffffffffffffffULL};
+
+    typedef ReducedField<Curve<Secp256k1> > Field; ///< Base field type.
+
+    /**
+     * @brief Reduction of a 512-bit product using 2^256 = 2^32 + 977 mod p.
+     * @param r Destination of LIMBS limbs.
+     * @param t The 2 * LIMBS limb product; it is not modified.
+     */
+    static void reduce(mp_limb_t* r, const mp_limb_t* t);
+
+    /**
+     * @brief a^(p - 2) by the chain over blocks of 1, 2, 22 and 223 ones: 255 squarings and 15 multiplications.
+     * @param r Destination; may alias a.
+     * @param a The base.
+     */
+    static void invPower(FieldElement<LIMBS>& r, const FieldElement<LIMBS>& a);
+
+    /**
+     * @brief a^((p + 1) / 4) by the chain over blocks of 2, 22 and 223 ones: 253 squarings and 13 multiplications.
+     * @param r Destination; may alias a.
+     * @param a The base.
+     */
+    static void sqrtPower(FieldElement<LIMBS>& r, const FieldElement<LIMBS>& a);
+
+    /**
+     * @brief Get the shared base field.
+     * @return The field modulo p.
+     */
+    static const Field& field();
+
+    /**
+     * @brief Get the shared Jacobian point formulas.
+     * @return The point arithmetic over field().
+     */
+    static const JacobianCurve<Field>& arithmetic();
+
+    /**
+     * @brief Get the shared complete projective point formulas.
+     * @return The branch-free point arithmetic over field().
+     */
+    static const ProjectiveCurve<Field>& completeArithmetic();
+};
+
+/**
+ * @brief NIST P-521, p = 2^521 - 1, reduced by the Mersenne fold.
+ */
+template <>
+struct Curve<P521> {
+    static const CurveId ID = CurveId::P521; ///< Runtime identifier.
+    static const size_t LIMBS = 9;           ///< Limbs per field element.
+    static constexpr mp_limb_t P[LIMBS] = {0xffffffffffffffffULL, 0xffffffffffffffffULL, 0xffffffffffffffffULL, 0xffffffffffffffffULL, 0xffffffffffffffffULL, 0xffffffffffffffffULL, 0xffffffffffffffffULL, 0xffffffffffffffffULL, 0x00000000000001ffULL};
+    static constexpr mp_limb_t A[LIMBS] = {0xfffffffffffffffcULL, 0xffffffffffffffffULL, 0xffffffffffffffffULL, 0xffffffffffffffffULL, 0xffffffffffffffffULL, 0xffffffffffffffffULL, 0xffffffffffffffffULL, 0xffffffffffffffffULL, 0x00000000000001ffULL};
+    static constexpr mp_limb_t B[LIMBS] = {0xef451fd46b503f00ULL, 0x3573df883d2c34f1ULL, 0x1652c0bd3bb1bf07ULL, 0x56193951ec7e937bULL, 0xb8b489918ef109e1ULL, 0xa2da725b99b315f3ULL, 0x929a21a0b68540eeULL, 0x953eb9618e1c9a1fULL, 0x0000000000000051ULL};
+    static constexpr mp_limb_t GX[LIMBS] = {0xf97e7e31c2e5bd66ULL, 0x3348b3c1856a429bULL, 0xfe1dc127a2ffa8deULL, 0xa14b5e77efe75928ULL, 0xf828af606b4d3dbaULL, 0x9c648139053fb521ULL, 0x9e3ecb662395b442ULL, 0x858e06b70404e9cdULL, 0x00000000000000c6ULL};
+    static constexpr mp_limb_t GY[LIMBS] = {0x88be94769fd16650ULL, 0x353c7086a272c240ULL, 0xc550b9013fad0761ULL, 0x97ee72995ef42640ULL, 0x17afbd17273e662cULL, 0x98f54449579b4468ULL, 0x5c8a5fb42c7d1bd9ULL, 0x39296a789a3bc004ULL, 0x0000000000000118ULL};
+    static constexpr mp_limb_t N[LIMBS] = {0xbb6fb71e91386409ULL, 0x3bb5c9b8899c47aeULL, 0x7fcc0148f709a5d0ULL, 0x51868783bf2f966bULL, 0xfffffffffffffffaULL, 0xffffffffffffffffULL, 0xffffffffffffffffULL, 0xffffffffffffffffULL, 0x00000000000001ffULL};
+
+    typedef ReducedField<Curve<P521> > Field; ///< Base field type.
+
+    /**
+     * @brief Reduction of a 1042-bit product using 2^521 = 1 mod p.
+     * @param r Destination of LIMBS limbs.
+     * @param t The 2 * LIMBS limb product; it is not modified.
+     */
+    static void reduce(mp_limb_t* r, const mp_limb_t* t);
+
+    /**
+     * @brief a^(p - 2) with p - 2 = 2^521 - 3: 520 squarings and 13 multiplications.
+     * @param r Destination; may alias a.
+     * @param a The base.
+     */
+    static void invPower(FieldElement<LIMBS>& r, const FieldElement<LIMBS>& a);
+
+    /**
+     * @brief a^((p + 1) / 4) with (p + 1) / 4 = 2^519: 519 squarings.
+     * @param r Destination; may alias a.
+     * @param a The base.
+     */
+    static void sqrtPower(FieldElement<LIMBS>& r, const FieldElement<LIMBS>& a);
+
+    /**
+     * @brief Get the shared base field.
+     * @return The field modulo p.
+     */
+    static const Field& field();
+
+    /**
+     * @brief Get the shared Jacobian point formulas.
+     * @return The point arithmetic over field().
+     */
+    static const JacobianCurve<Field>& arithmetic();
+
+    /**
+     * @brief Get the shared complete projective point formulas.
+     * @return The branch-free point arithmetic over field().
+     */
+    static const ProjectiveCurve<Field>& completeArithmetic();
+};
+
+/**
+ * @brief Runs a visitor on the Curve<Tag> trait matching a runtime curve identifier.
+ *
+ * The visitor provides a result_type typedef and a member template
+ * run<C>() which is instantiated once per supported curve.
+ *
+ * @param id The curve to dispatch to.
+ * @param visitor The visitor to run.
+ * @return The visitor's result for the selected curve.
+ * @throw std::invalid_argument If the identifier is not a supported curve.
+ */
+template <class Visitor>
+typename Visitor::result_type visitCurve(CurveId id, Visitor& visitor) {
+    switch (id) {
+        case CurveId::P256:      return visitor.template run<Curve<P256> >();
+        case CurveId::Secp256k1: return visitor.template run<Curve<Secp256k1> >();
+        case CurveId::P521:      return visitor.template run<Curve<P521> >();
+    }
+    throw std::invalid_argument("Unsupported elliptic curve.");
+}
+
+#endif // CURVES_HPP
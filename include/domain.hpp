@@ -0,0 +1,231 @@
+/**
+ * @file domain.hpp
+ * @brief Polynomials on an NTT evaluation domain, in coefficient or evaluation form.
+ *
+ * An EvaluationDomain is a coset g * <w> of the n-th roots of unity of an
+ * NTT-friendly prime field. A DomainPolynomial of degree below n is held in
+ * coefficient form, in evaluation form over the domain, or both: products are
+ * taken pointwise in evaluation form, sums and scalings in whichever form the
+ * operands share, and the missing form is produced by one transform the first
+ * time it is needed and kept from then on. A chain such as a * b + c * d - e
+ * thus transforms every input forward once and the result back once, instead
+ * of three transforms per product.
+ */
+
+#ifndef DOMAIN_HPP
+#define DOMAIN_HPP
+
+#include "bigint.hpp"
+#include "limbs.hpp"
+#include "polynomial.hpp"
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/**
+ * @class EvaluationDomain
+ * @brief The points g * w^i, i < n, with w a primitive n-th root of unity.
+ *
+ * The twiddle factors and coset powers are computed once and shared by all
+ * copies of the domain, so it is cheap to pass by value.
+ */
+class EvaluationDomain {
+public:
+    /**
+     * @brief Precomputes the transforms of a domain.
+     * @param size The number of points n, a power of two dividing mod - 1.
+     * @param modulus The prime modulus, below 2^512.
+     * @param shift The coset generator g; 1 for the subgroup itself.
+     * @param threads Number of threads for the transforms, 1 to run serially, or 0 to use the shared pool.
+     * @throw std::invalid_argument If the modulus has no root of unity of that order, is too wide,
+     *        or the shift is zero.
+     */
+    EvaluationDomain(size_t size, const BigInt& modulus, const BigInt& shift = BigInt(1UL), unsigned threads = 0);
+
+    /**
+     * @brief Get the number of points.
+     * @return n.
+     */
+    size_t size() const { return n; }
+
+    /**
+     * @brief Get the modulus of the field.
+     * @return The prime modulus.
+     */
+    const BigInt& getMod() const { return mod; }
+
+    /**
+     * @brief Get the coset generator.
+     * @return g, reduced.
+     */
+    const BigInt& getShift() const { return shift; }
+
+    /**
+     * @brief Get the root of unity generating the subgroup.
+     * @return w, so that point i is g * w^i.
+     */
+    const BigInt& root() const { return omega; }
+
+    /**
+     * @brief Check if two domains have the same points.
+     * @param other The domain to compare with.
+     * @return True if size, modulus and shift agree.
+     */
+    bool operator==(const EvaluationDomain& other) const;
+
+    /**
+     * @brief Check if two domains differ.
+     * @param other The domain to compare with.
+     * @return True if size, modulus or shift differ.
+     */
+    bool operator!=(const EvaluationDomain& other) const { return !(*this == other); }
+
+private:
+    friend class DomainPolynomial;
+
+    struct Transform;
+    struct TransformFactory;
+    template <size_t N> struct FieldTransform;
+
+    // n coefficients to the values at the points, stored at the bit-reversed point index, and back.
+    void forward(mp_limb_t* values) const;
+    void inverse(mp_limb_t* values) const;
+
+    size_t n;
+    unsigned logN;
+    BigInt mod;
+    BigInt shift;
+    BigInt omega;
+    unsigned threads;
+    std::shared_ptr<const Transform> transform;
+};
+
+/**
+ * @enum PolynomialForm
+ * @brief Representation of a DomainPolynomial.
+ */
+enum class PolynomialForm {
+    Coefficients, ///< Coefficients in the monomial basis, lowest degree first.
+    Evaluations   ///< Values at the points of the domain.
+};
+
+/**
+ * @class DomainPolynomial
+ * @brief A polynomial of degree below the domain size, kept in one or both forms.
+ *
+ * Every polynomial carries a bound on its number of coefficients, derived
+ * from its inputs: products are only defined while the bound of the result
+ * stays within the domain, so the pointwise product never wraps around.
+ * The cached forms are filled in by const accessors; a polynomial that is
+ * read by several threads at once should have both forms computed first.
+ */
+class DomainPolynomial {
+public:
+    /**
+     * @brief Holds a polynomial in coefficient form.
+     * @param poly The coefficients, at most domain.size() of them.
+     * @param domain The evaluation domain.
+     * @throw std::invalid_argument If the moduli differ or poly has more coefficients than the domain points.
+     */
+    DomainPolynomial(const Polynomial& poly, const EvaluationDomain& domain);
+
+    /**
+     * @brief Holds a polynomial given by its values at the points of a domain.
+     * @param values The value at point i for every i < domain.size(); they are reduced first.
+     * @param domain The evaluation domain.
+     * @return The polynomial of degree below domain.size() through the values.
+     * @throw std::invalid_argument If the number of values differs from the domain size.
+     */
+    static DomainPolynomial fromEvaluations(const std::vector<BigInt>& values, const EvaluationDomain& domain);
+
+    /**
+     * @brief Check which forms are available without a transform.
+     * @param form The form to check.
+     * @return True if the polynomial is held in that form.
+     */
+    bool hasForm(PolynomialForm form) const { return form == PolynomialForm::Coefficients ? hasCoefficients : hasEvaluations; }
+
+    /**
+     * @brief Get the bound on the number of coefficients.
+     * @return The size of coefficients(); degree + 1 at most.
+     */
+    size_t bound() const { return sizeBound; }
+
+    /**
+     * @brief Get the domain of the polynomial.
+     * @return The evaluation domain.
+     */
+    const EvaluationDomain& getDomain() const { return domain; }
+
+    /**
+     * @brief Get the coefficient form, transforming back on first use.
+     * @return bound() coefficients, lowest degree first, for division, degrees and the like.
+     */
+    const Polynomial& coefficients() const;
+
+    /**
+     * @brief Get the value at one point of the domain, transforming forward on first use.
+     * @param i The index of the point g * w^i.
+     * @return The value there.
+     */
+    BigInt evaluation(size_t i) const;
+
+    /**
+     * @brief Get the values at all points, transforming forward on first use.
+     * @return The value at point i for every i < domain size.
+     */
+    std::vector<BigInt> evaluations() const;
+
+    /**
+     * @brief Adds two polynomials, in evaluation form unless both are only held as coefficients.
+     * @param result Reference to DomainPolynomial where the sum will be stored; it may alias an operand.
+     * @param a The first polynomial.
+     * @param b The second polynomial.
+     * @throw std::invalid_argument If the domains differ.
+     */
+    friend void addPolynomials(DomainPolynomial &result, const DomainPolynomial &a, const DomainPolynomial &b);
+
+    /**
+     * @brief Subtracts two polynomials, in evaluation form unless both are only held as coefficients.
+     * @param result Reference to DomainPolynomial where the difference will be stored; it may alias an operand.
+     * @param a The polynomial to subtract from.
+     * @param b The polynomial to subtract.
+     * @throw std::invalid_argument If the domains differ.
+     */
+    friend void subtractPolynomials(DomainPolynomial &result, const DomainPolynomial &a, const DomainPolynomial &b);
+
+    /**
+     * @brief Multiplies two polynomials pointwise in evaluation form.
+     * @param result Reference to DomainPolynomial where the product will be stored; it may alias an operand.
+     * @param a The first factor.
+     * @param b The second factor.
+     * @throw std::invalid_argument If the domains differ or the product has more coefficients than the domain points.
+     */
+    friend void multiplyPolynomials(DomainPolynomial &result, const DomainPolynomial &a, const DomainPolynomial &b);
+
+    /**
+     * @brief Multiplies a polynomial by a scalar in every form it is held in.
+     * @param result Reference to DomainPolynomial where the result will be stored; it may alias poly.
+     * @param poly The polynomial.
+     * @param scalar The scalar; it is reduced modulo the modulus.
+     */
+    friend void multiplyPolynomialByScalar(DomainPolynomial &result, const DomainPolynomial &poly, const BigInt &scalar);
+
+private:
+    DomainPolynomial(const EvaluationDomain& domain, size_t bound);
+
+    void ensureCoefficients() const;
+    void ensureEvaluations() const;
+
+    // The sum or difference of a and b in the form both share, or in evaluation form.
+    static DomainPolynomial combine(const DomainPolynomial& a, const DomainPolynomial& b, bool subtract);
+
+    EvaluationDomain domain;
+    size_t sizeBound; ///< Coefficients that may be non-zero.
+    mutable Polynomial coeffs; ///< sizeBound coefficients, valid if hasCoefficients.
+    mutable LimbBuffer evals;  ///< Values at the points, at the bit-reversed index, valid if hasEvaluations.
+    mutable bool hasCoefficients;
+    mutable bool hasEvaluations;
+};
+
+#endif // DOMAIN_HPP
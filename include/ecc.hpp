@@ -2,11 +2,11 @@
 #define ECC_HPP
 
 #include "bigint.hpp"
+#include "curves.hpp"
+#include <gmp.h>
+#include <cstring>
 #include <iostream>
-
-#define USE_CURVE_P256
-// #define USE_CURVE_SECP256K1
-// #define USE_CURVE_P521
+#include <vector>
 
 /**
  * @struct CurveParameters
@@ -26,6 +26,63 @@ struct CurveParameters {
     BigInt n;  ///< Order of the group generated by the generator point.
 };
 
+/**
+ * @class CurveContext
+ * @brief Immutable, process-wide context of one supported elliptic curve.
+ *
+ * There is one context per CurveId, built once on first use from the typed
+ * constants of the matching Curve<Tag> trait. Points only hold a pointer to
+ * it, so constructing or copying an Ecc_Point never touches the curve
+ * parameters, and points of different curves can live in the same process.
+ */
+class CurveContext {
+public:
+    /**
+     * @brief Get the shared context of a curve.
+     * @param id The curve to look up (default is P-256).
+     * @return Reference to the context, constructed on the first call.
+     * @throw std::invalid_argument If the identifier is not a supported curve.
+     */
+    static const CurveContext& instance(CurveId id = CurveId::P256);
+
+    /**
+     * @brief Get the identifier of the curve.
+     * @return The runtime curve identifier used for dispatch.
+     */
+    CurveId id() const { return curveId; }
+
+    /**
+     * @brief Get the curve parameters.
+     * @return The parameters a, b, p, Gx, Gy and n.
+     */
+    const CurveParameters& params() const { return curveParams; }
+
+    /**
+     * @brief Get the width of the curve's base field elements.
+     * @return The number of limbs of a coordinate, Curve<Tag>::LIMBS.
+     */
+    size_t limbs() const { return fieldLimbs; }
+
+private:
+    CurveContext(CurveId id, const CurveParameters& params, size_t limbs)
+        : curveId(id), curveParams(params), fieldLimbs(limbs) {}
+    CurveContext(const CurveContext&) = delete;
+    CurveContext& operator=(const CurveContext&) = delete;
+
+    CurveId curveId;             ///< Runtime identifier of the curve.
+    CurveParameters curveParams; ///< Curve parameters as BigInts.
+    size_t fieldLimbs;           ///< Limbs per coordinate.
+};
+
+/**
+ * @enum ScalarMulMode
+ * @brief Choice of algorithm for scalar multiplications with secret scalars.
+ */
+enum class ScalarMulMode {
+    Fast,        ///< Variable-time wNAF and fixed-base tables; the fastest choice for public scalars.
+    ConstantTime ///< Montgomery ladder and masked table scans over complete formulas; no branch or memory access depends on the scalar.
+};
+
 /**
  * @class Ecc_Point
  * @brief Represents a point on an elliptic curve.
@@ -33,75 +90,124 @@ struct CurveParameters {
  * The Ecc_Point class encapsulates a point on an elliptic curve defined over a finite field.
  * It provides functionalities for elliptic curve arithmetic like point addition,
  * negation, and scalar multiplication.
+ *
+ * The coordinates are stored inline as elements of the curve's base field,
+ * Curve<Tag>::Field, in fixed arrays of CURVE_MAX_LIMBS limbs of which the
+ * first getCurve().limbs() are used and the rest are zero. The arithmetic
+ * reads and writes them directly, so a point is copied without allocating
+ * and BigInt values are only built by getX() and getY().
  */
 class Ecc_Point {
 public:
     bool isInfinity;
     /**
-     * @brief Default constructor to initialize an Ecc_Point with BigInt coordinates. Initializes with base points as x and y coordinate.
-     * @param x The x-coordinate of the Ecc_Point.
-     * @param y The y-coordinate of the Ecc_Point.
+     * @brief Default constructor. Creates the point at infinity of P-256.
      */
-    Ecc_Point() : xCoord(BigInt(static_cast<unsigned long int>(0))), yCoord(BigInt(static_cast<unsigned long int>(0))), isInfinity(true) {}
-    
+    Ecc_Point() : isInfinity(true), curve(&CurveContext::instance()), xField(), yField() {}
+
+    /**
+     * @brief Creates the point at infinity of a given curve.
+     * @param id The curve the point belongs to.
+     */
+    explicit Ecc_Point(CurveId id) : isInfinity(true), curve(&CurveContext::instance(id)), xField(), yField() {}
+
     /**
      * @brief Constructor to initialize an Ecc_Point with BigInt coordinates.
-     * @param x The x-coordinate of the Ecc_Point.
-     * @param y The y-coordinate of the Ecc_Point.
+     * @param x The x-coordinate of the Ecc_Point, reduced modulo p.
+     * @param y The y-coordinate of the Ecc_Point, reduced modulo p.
+     * @param id The curve the point belongs to (default is P-256).
      */
-    Ecc_Point(const BigInt& x, const BigInt& y) : xCoord(x), yCoord(y), isInfinity(false) {
-        setCurveParameters();
+    Ecc_Point(const BigInt& x, const BigInt& y, CurveId id = CurveId::P256);
+
+    /**
+     * @brief Creates a finite point from coordinates in the curve field's representation.
+     *
+     * Nothing is checked: the coordinates must be below p, as the elements of
+     * Curve<Tag>::Field are. This is how the arithmetic hands its results back.
+     *
+     * @param x getCurve().limbs() limbs of the x-coordinate.
+     * @param y getCurve().limbs() limbs of the y-coordinate.
+     * @param id The curve the point belongs to.
+     * @return The point (x, y).
+     */
+    static Ecc_Point fromLimbs(const mp_limb_t* x, const mp_limb_t* y, CurveId id) {
+        Ecc_Point P(id);
+        const size_t n = P.curve->limbs();
+        std::memcpy(P.xField, x, n * sizeof(mp_limb_t));
+        std::memcpy(P.yField, y, n * sizeof(mp_limb_t));
+        P.isInfinity = false;
+        return P;
     }
 
+    /**
+     * @brief Get the generator point of a curve.
+     * @param id The curve (default is P-256).
+     * @return The point (Gx, Gy).
+     */
+    static Ecc_Point generator(CurveId id = CurveId::P256);
+
     /**
      * @brief Copy constructor.
      * @param other The Ecc_Point to copy.
      */
-    Ecc_Point(const Ecc_Point& other) 
-    : xCoord(other.xCoord), yCoord(other.yCoord), isInfinity(other.isInfinity), curveParams(other.curveParams) {}
+    Ecc_Point(const Ecc_Point& other) = default;
 
     /**
      * @brief Assignment operator.
      * @param other The Ecc_Point to assign.
      * @return Reference to this Ecc_Point after assignment.
      */
-    Ecc_Point& operator=(const Ecc_Point& other) {
-        if (this != &other) {
-            xCoord = other.xCoord;
-            yCoord = other.yCoord;
-            isInfinity = other.isInfinity;
-            curveParams = other.curveParams;
-        }
-        return *this;
-    }
+    Ecc_Point& operator=(const Ecc_Point& other) = default;
 
     /**
      * @brief Get the x-coordinate of the Ecc_Point.
-     * @return The x-coordinate.
+     * @return The x-coordinate, 0 for the point at infinity.
      */
-    const BigInt& getX() const { return xCoord; }
+    BigInt getX() const { return BigInt::fromLimbs(xField, curve->limbs()); }
 
     /**
      * @brief Get the y-coordinate of the Ecc_Point.
-     * @return The y-coordinate.
+     * @return The y-coordinate, 0 for the point at infinity.
      */
-    const BigInt& getY() const { return yCoord; }
+    BigInt getY() const { return BigInt::fromLimbs(yField, curve->limbs()); }
 
+    /**
+     * @brief Get the limbs of the x-coordinate in the curve field's representation.
+     * @return CURVE_MAX_LIMBS limbs, of which getCurve().limbs() are significant.
+     */
+    const mp_limb_t* xLimbs() const { return xField; }
+
+    /**
+     * @brief Get the limbs of the y-coordinate in the curve field's representation.
+     * @return CURVE_MAX_LIMBS limbs, of which getCurve().limbs() are significant.
+     */
+    const mp_limb_t* yLimbs() const { return yField; }
+
+    /**
+     * @brief Get the prime of the field the point is defined over.
+     * @return The prime p of the curve.
+     */
     const BigInt& getP() const {
-        return curveParams.p;
+        return curve->params().p;
     }
 
+    /**
+     * @brief Get the curve context the point belongs to.
+     * @return The shared, immutable curve context.
+     */
+    const CurveContext& getCurve() const { return *curve; }
+
     /**
      * @brief Set the x-coordinate of the Ecc_Point.
-     * @param x The new x-coordinate.
+     * @param x The new x-coordinate, reduced modulo p.
      */
-    void setX(const BigInt& x) { xCoord = x; }
+    void setX(const BigInt& x);
 
     /**
      * @brief Set the y-coordinate of the Ecc_Point.
-     * @param y The new y-coordinate.
+     * @param y The new y-coordinate, reduced modulo p.
      */
-    void setY(const BigInt& y) { yCoord = y; }
+    void setY(const BigInt& y);
 
     /**
      * @brief Prints the coordinates of the Ecc_Point.
@@ -115,11 +221,85 @@ public:
             std::cout << "Point at Infinity" << std::endl;
         } else {
             std::cout << "Ecc_Point Coordinates:" << std::endl;
-            std::cout << "x = " << xCoord.toString(16) << std::endl;
-            std::cout << "y = " << yCoord.toString(16) << std::endl;
+            std::cout << "x = " << getX().toString(16) << std::endl;
+            std::cout << "y = " << getY().toString(16) << std::endl;
         }
     }
     
+    /**
+     * @brief Get the size of a SEC1 encoding on a curve.
+     * @param id The curve.
+     * @param compressed True for the compressed form 02/03 || x, false for 04 || x || y.
+     * @return The number of bytes of the encoding of a finite point.
+     */
+    static size_t encodedSize(CurveId id, bool compressed = true);
+
+    /**
+     * @brief Encodes the point in SEC1 binary form.
+     *
+     * Coordinates are written big-endian in encodedSize() - 1 (or half of
+     * it) bytes straight from the field elements, without going through text.
+     * The point at infinity is the single byte 00.
+     *
+     * @param compressed True for 02/03 || x, the tag carrying the parity of y; false for 04 || x || y.
+     * @return The encoding.
+     */
+    std::vector<unsigned char> toBytes(bool compressed = true) const;
+
+    /**
+     * @brief Decodes a SEC1 encoding, compressed or not.
+     *
+     * A compressed point is recovered with the square root y = (x^3 + ax + b)^((p + 1) / 4),
+     * computed by the curve's fixed addition chain; an uncompressed one is checked to lie on the curve.
+     *
+     * @param data The encoding.
+     * @param size Its length in bytes.
+     * @param id The curve (default is P-256).
+     * @return The point.
+     * @throw std::invalid_argument If the encoding is malformed, a coordinate is not below p or the point is not on the curve.
+     */
+    static Ecc_Point fromBytes(const unsigned char* data, size_t size, CurveId id = CurveId::P256);
+
+    /**
+     * @brief Decodes a SEC1 encoding, compressed or not.
+     * @param bytes The encoding.
+     * @param id The curve (default is P-256).
+     * @return The point.
+     * @throw std::invalid_argument If the encoding is malformed, a coordinate is not below p or the point is not on the curve.
+     */
+    static Ecc_Point fromBytes(const std::vector<unsigned char>& bytes, CurveId id = CurveId::P256) {
+        return fromBytes(bytes.data(), bytes.size(), id);
+    }
+
+    /**
+     * @brief Get the size of the fixed-width raw encoding on a curve.
+     * @param id The curve.
+     * @return Twice the number of bytes of a coordinate.
+     */
+    static size_t rawSize(CurveId id);
+
+    /**
+     * @brief Encodes the point as x || y, each little-endian in half of rawSize() bytes.
+     *
+     * Every point of a curve takes the same space and the bytes are the
+     * coordinate limbs as they sit in memory, so large files of points can
+     * be written and read without any conversion. The point at infinity is
+     * all zeros, which is not on any supported curve since b is non-zero.
+     *
+     * @return The encoding.
+     */
+    std::vector<unsigned char> toRawBytes() const;
+
+    /**
+     * @brief Decodes the raw encoding of toRawBytes().
+     * @param data The encoding.
+     * @param size Its length in bytes, rawSize(id).
+     * @param id The curve (default is P-256).
+     * @return The point.
+     * @throw std::invalid_argument If the size is wrong, a coordinate is not below p or the point is not on the curve.
+     */
+    static Ecc_Point fromRawBytes(const unsigned char* data, size_t size, CurveId id = CurveId::P256);
+
     /**
      * @brief Overloads the + operator for adding two Ecc_Points.
      *
@@ -137,6 +317,7 @@ public:
      *
      * @param other The Ecc_Point to add to this point.
      * @return Ecc_Point representing the sum of this point and the other point.
+     * @throw std::invalid_argument If the points belong to different curves.
      */
     Ecc_Point operator+(const Ecc_Point& other) const;
 
@@ -161,14 +342,63 @@ public:
      * It computes kP for a point P on the curve and a scalar k. This operation is
      * equivalent to adding P to itself k times.
      *
-     * The scalar multiplication is performed using the "double-and-add" method, which
-     * is efficient and reduces the number of elliptic curve operations needed.
+     * The scalar is recoded into a width-5 non-adjacent form and processed with a
+     * precomputed table of odd multiples of P, in Jacobian coordinates. See multiply()
+     * to choose a different window width. When P is the curve generator the
+     * precomputed fixed-base table is used instead (see multiplyGenerator()).
      *
      * @param scalar The BigInt scalar to multiply this point by.
      * @return Ecc_Point resulting from the scalar multiplication of this point by the scalar.
      */
     Ecc_Point operator*(const BigInt& scalar) const;
 
+    /**
+     * @brief Scalar multiplication with a configurable wNAF window width.
+     *
+     * Wider windows need fewer point additions (about bits / (w + 1)) but a larger
+     * table of 2^(w-2) precomputed odd multiples.
+     *
+     * @param scalar The non-negative scalar; zero or negative scalars give the point at infinity.
+     * @param windowWidth The window width, from 2 to 8.
+     * @return The point scalar * P.
+     * @throw std::invalid_argument If the window width is out of range.
+     */
+    Ecc_Point multiply(const BigInt& scalar, unsigned windowWidth) const;
+
+    /**
+     * @brief Scalar multiplication with a selectable timing behaviour.
+     *
+     * In ConstantTime mode the scalar is reduced modulo the group order n and
+     * processed as a fixed-width limb array with the Montgomery ladder: every
+     * bit of n's size costs one complete addition and one doubling, whatever
+     * the scalar. The reduction itself goes through BigInt, so secret scalars
+     * should already be below n.
+     *
+     * @param scalar The non-negative scalar; negative scalars give the point at infinity.
+     * @param mode ScalarMulMode::Fast for operator*, or ScalarMulMode::ConstantTime.
+     * @return The point scalar * P.
+     */
+    Ecc_Point multiply(const BigInt& scalar, ScalarMulMode mode) const;
+
+    /**
+     * @brief Multiplies the curve generator G by a scalar using a precomputed table.
+     *
+     * The table of multiples of G is built once per curve on first use and turns
+     * G * k into about bits / 5 mixed additions without a single doubling. The
+     * scalar is reduced modulo the group order n first.
+     *
+     * In ConstantTime mode every row of the table is visited and scanned in
+     * full with masked moves, and the entries are added with complete mixed
+     * formulas, so the running time is the same for every scalar below n.
+     *
+     * @param scalar The non-negative scalar; zero or negative scalars give the point at infinity.
+     * @param id The curve (default is P-256).
+     * @param mode ScalarMulMode::Fast (the default), or ScalarMulMode::ConstantTime for secret scalars.
+     * @return The point scalar * G.
+     */
+    static Ecc_Point multiplyGenerator(const BigInt& scalar, CurveId id = CurveId::P256,
+                                       ScalarMulMode mode = ScalarMulMode::Fast);
+
 
     /**
      * @brief Overloads the == operator to compare two Ecc_Points.
@@ -187,51 +417,9 @@ public:
 
 
 private:
-    CurveParameters curveParams;
-    BigInt xCoord; ///< The x-coordinate of the Ecc_Point.
-    BigInt yCoord; ///< The y-coordinate of the Ecc_Point.
-
-
-     /**
-     * @brief Sets the parameters of the elliptic curve based on the selected curve type.
-     *
-     * This function initializes the curve parameters (a, b, p, Gx, Gy, n) of the Ecc_Point
-     * object based on a predefined set of well-known elliptic curves. The specific curve
-     * is selected using preprocessor directives at compile time. This function is invoked
-     * during the construction of an Ecc_Point object to ensure it is configured with the
-     * correct parameters for the chosen elliptic curve.
-     *
-     * @note The curve parameters must be predefined and correctly set for the specified
-     *       elliptic curve. If no curve is defined, a compile-time error is generated.
-     */
-
-    void setCurveParameters() {
-        #ifdef USE_CURVE_P256
-            curveParams.a = BigInt("ffffffff00000001000000000000000000000000fffffffffffffffffffffffc",16);
-            curveParams.b = BigInt("5ac635d8aa3a93e7b3ebbd55769886bc651d06b0cc53b0f63bce3c3e27d2604b",16);
-            curveParams.p = BigInt("ffffffff00000001000000000000000000000000ffffffffffffffffffffffff",16);
-            curveParams.Gx = BigInt("6b17d1f2e12c4247f8bce6e563a440f277037d812deb33a0f4a13945d898c296",16);
-            curveParams.Gy = BigInt("4fe342e2fe1a7f9b8ee7eb4a7c0f9e162bce33576b315ececbb6406837bf51f5",16);
-            curveParams.n = BigInt("ffffffff00000000ffffffffffffffffbce6faada7179e84f3b9cac2fc632551",16);
-        #elif defined USE_CURVE_SECP256K1
-            curveParams.a = BigInt("0",16);
-            curveParams.b = BigInt("7",16);
-            curveParams.p = BigInt("fffffffffffffffffffffffffffffffffffffffffffffffffffffffefffffc2f",16);
-            curveParams.Gx = BigInt("79be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798",16);
-            curveParams.Gy = BigInt("483ada7726a3c4655da4fbfc0e1108a8fd17b448a68554199c47d08ffb10d4b8",16);
-            curveParams.n = BigInt("fffffffffffffffffffffffe26f2fc170f69466a74defd8d",16);
-        #elif defined USE_CURVE_P521
-            curveParams.a = BigInt("01fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffc",16);
-            curveParams.b = BigInt("0051953eb9618e1c9a1f929a21a0b68540eea2da725b99b315f3b8b489918ef109e156193951ec7e937b1652c0bd3bb1bf073573df883d2c34f1ef451fd46b503f00",16);
-            curveParams.p = BigInt("01ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff",16);
-            curveParams.Gx = BigInt("00c6858e06b70404e9cd9e3ecb662395b4429c648139053fb521f828af606b4d3dbaa14b5e77efe75928fe1dc127a2ffa8de3348b3c1856a429bf97e7e31c2e5bd66",16);
-            curveParams.Gy = BigInt("011839296a789a3bc0045c8a5fb42c7d1bd998f54449579b446817afbd17273e662c97ee72995ef42640c550b9013fad0761353c7086a272c24088be94769fd16650",16);
-            curveParams.n = BigInt("01fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffa51868783bf2f966b7fcc0148f709a5d03bb5c9b8899c47aebb6fb71e91386409",16);
-        #else
-            #error "No elliptic curve defined"
-        #endif
-    }
-
+    const CurveContext* curve;        ///< The shared curve context, never null.
+    mp_limb_t xField[CURVE_MAX_LIMBS]; ///< The x-coordinate as a base field element, zero-padded.
+    mp_limb_t yField[CURVE_MAX_LIMBS]; ///< The y-coordinate as a base field element, zero-padded.
 
     /**
      * @brief Doubles this Ecc_Point on the elliptic curve.
@@ -241,7 +429,7 @@ private:
      * The doubling is done using the formulas: λ = (3x² + a) / 2y, x' = λ² - 2x,
      * and y' = λ(x - x') - y, where 'a' is the curve parameter and operations are
      * performed under modulo p arithmetic, with p being the prime order of the field.
-     * The point P is represented by the member variables xCoord and yCoord.
+     * The point P is represented by the member variables xField and yField.
      *
      * @note Assumes the point is not at infinity and y-coordinate is not zero. 
      * Additional handling is required for these special cases.
@@ -251,4 +439,113 @@ private:
     Ecc_Point doublePoint() const;
 };
 
+/**
+ * @brief Multi-scalar multiplication sum_i scalars[i] * points[i].
+ *
+ * Uses Pippenger's bucket method (see msm.hpp) with a window width chosen from
+ * the number of points, which is far cheaper than summing individual scalar
+ * multiplications once there are more than a handful of points. Scalars are
+ * reduced modulo the group order n, so negative scalars are allowed.
+ *
+ * The windows and point ranges are spread over a thread pool with one bucket
+ * array per task, so the accumulation takes no locks.
+ *
+ * @param points The points, all on the same curve.
+ * @param scalars One scalar per point.
+ * @param threads Number of threads, 1 to run serially, or 0 (the default) to use
+ *        the shared pool with one thread per hardware thread.
+ * @return The sum; the point at infinity of P-256 if there are no points.
+ * @throw std::invalid_argument If the sizes differ or the points belong to different curves.
+ */
+Ecc_Point multiScalarMul(const std::vector<Ecc_Point>& points, const std::vector<BigInt>& scalars, unsigned threads = 0);
+
+/**
+ * @brief Computes k1 * P1 + k2 * P2 with one shared chain of doublings.
+ *
+ * Both scalars are recoded into wNAF and processed together (Straus-Shamir
+ * trick), which costs little more than a single scalar multiplication. A
+ * curve generator among the two points uses a wider table of odd multiples
+ * that is precomputed once per curve, so the ECDSA check u1 * G + u2 * Q
+ * needs only one table to be built per call. Scalars are reduced modulo the
+ * group order n, so negative scalars are allowed.
+ *
+ * @param k1 The first scalar.
+ * @param P1 The first point.
+ * @param k2 The second scalar.
+ * @param P2 The second point, on the same curve as P1.
+ * @return The sum.
+ * @throw std::invalid_argument If the points belong to different curves.
+ */
+Ecc_Point doubleScalarMul(const BigInt& k1, const Ecc_Point& P1, const BigInt& k2, const Ecc_Point& P2);
+
+/**
+ * @struct SignatureCheck
+ * @brief One verification equation u1 * G + u2 * Q = R, G being the curve generator.
+ *
+ * ECDSA verification has this form with u1 = e / s, u2 = r / s and R the
+ * signature's nonce point; a Schnorr signature (R, s) on challenge e has
+ * u1 = s and u2 = -e.
+ */
+struct SignatureCheck {
+    BigInt u1;   ///< Scalar of the generator.
+    BigInt u2;   ///< Scalar of the public key.
+    Ecc_Point Q; ///< The public key.
+    Ecc_Point R; ///< The point the combination must equal.
+};
+
+/**
+ * @brief Checks many verification equations with a single multi-scalar multiplication.
+ *
+ * Every equation is weighted by a random odd 128-bit z_i and the weighted
+ * equations are summed: (sum_i z_i u1_i) G + sum_i z_i u2_i Q_i - sum_i z_i R_i
+ * is the point at infinity if all equations hold. The weights are read from
+ * the operating system's cryptographic random source on every call (getrandom()
+ * on Linux, std::random_device elsewhere), so they are independent of the
+ * checks; if an equation fails, the sum then fails to vanish with probability
+ * at least 1 - 2^-127 over the 2^127 choices of its weight, even for checks
+ * chosen by an adversary. The sum is one Pippenger MSM over
+ * 2n + 1 points instead of n double-scalar multiplications. A false result
+ * does not tell which equation failed; check them one by one with
+ * doubleScalarMul() to find out.
+ *
+ * @param checks The equations, all on the same curve.
+ * @param threads Number of threads for the MSM, 1 to run serially, or 0 to use the shared pool.
+ * @return True if all equations hold (or there are none), false if at least one fails.
+ * @throw std::invalid_argument If the points belong to different curves.
+ * @throw std::runtime_error If the random source cannot be read.
+ */
+bool batchVerify(const std::vector<SignatureCheck>& checks, unsigned threads = 0);
+
+/**
+ * @brief Decodes many compressed points stored back to back.
+ *
+ * The curve is dispatched once for the whole batch and the square roots,
+ * which dominate the cost, are spread over a thread pool; no intermediate
+ * text or per-point buffer is involved.
+ *
+ * @param data count compressed encodings of Ecc_Point::encodedSize(id) bytes each, infinity not allowed.
+ * @param id The curve (default is P-256).
+ * @param threads Number of threads, 1 to run serially, or 0 to use the shared pool.
+ * @return The points, in order.
+ * @throw std::invalid_argument If the size is not a multiple of the encoding size or an encoding is invalid.
+ */
+std::vector<Ecc_Point> decompressPoints(const std::vector<unsigned char>& data, CurveId id = CurveId::P256,
+                                        unsigned threads = 0);
+
+/**
+ * @brief Adds many independent pairs of points, out[i] = a[i] + b[i].
+ *
+ * Every affine addition needs one field inversion; here all of them are
+ * shared through Montgomery's simultaneous inversion trick, so the whole
+ * batch costs 1 inversion and 3(n - 1) extra multiplications instead of n
+ * inversions. Doublings, inverse pairs and the point at infinity are handled
+ * like in Ecc_Point::operator+.
+ *
+ * @param a First summands, all on the same curve.
+ * @param b Second summands, on the same curve as a.
+ * @param out Replaced by the n sums.
+ * @throw std::invalid_argument If the sizes differ or the points belong to different curves.
+ */
+void batchAdd(const std::vector<Ecc_Point>& a, const std::vector<Ecc_Point>& b, std::vector<Ecc_Point>& out);
+
 #endif // ECC_HPP
@@ -0,0 +1,661 @@
+/**
+ * @file field.hpp
+ * @brief Fixed-width prime field arithmetic.
+ *
+ * Field elements are plain arrays of GMP limbs that live on the stack, so the
+ * arithmetic below never touches the heap. All operations are built on the
+ * mpn_* layer of GMP.
+ */
+
+#ifndef FIELD_HPP
+#define FIELD_HPP
+
+#include "bigint.hpp"
+#include "instrument.hpp"
+#include "safegcd.hpp"
+#include <gmp.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+static_assert(GMP_NUMB_BITS == 64, "FieldElement assumes 64-bit GMP limbs without nails.");
+
+/**
+ * @struct FieldElement
+ * @brief A fixed-width field element of N 64-bit limbs, least significant limb first.
+ *
+ * The element carries no modulus; its meaning is given by the field object that
+ * produced it (see MontgomeryField). 4 limbs cover P-256 and secp256k1, 9 limbs
+ * cover P-521.
+ *
+ * @tparam N Number of limbs.
+ */
+template <size_t N>
+struct FieldElement {
+    mp_limb_t limbs[N]; ///< Limbs of the element, least significant first.
+
+    /**
+     * @brief Check if all limbs are zero.
+     * @return True if the element is zero, false otherwise.
+     */
+    bool isZero() const {
+        mp_limb_t acc = 0;
+        for (size_t i = 0; i < N; ++i) acc |= limbs[i];
+        return acc == 0;
+    }
+
+    /**
+     * @brief Limb-wise equality operator.
+     * @param other The element to compare with.
+     * @return True if equal, false otherwise.
+     */
+    bool operator==(const FieldElement& other) const {
+        mp_limb_t acc = 0;
+        for (size_t i = 0; i < N; ++i) acc |= limbs[i] ^ other.limbs[i];
+        return acc == 0;
+    }
+
+    /**
+     * @brief Limb-wise inequality operator.
+     * @param other The element to compare with.
+     * @return True if not equal, false otherwise.
+     */
+    bool operator!=(const FieldElement& other) const { return !(*this == other); }
+};
+
+/**
+ * @brief Copies a into r if flag is 1, with no branch on flag.
+ * @param r Destination.
+ * @param a The element to copy.
+ * @param flag 0 or 1.
+ */
+template <size_t N>
+void conditionalMove(FieldElement<N>& r, const FieldElement<N>& a, mp_limb_t flag) {
+    const mp_limb_t mask = -flag;
+    for (size_t i = 0; i < N; ++i) r.limbs[i] ^= (r.limbs[i] ^ a.limbs[i]) & mask;
+}
+
+/**
+ * @brief Swaps a and b if flag is 1, with no branch on flag.
+ * @param a First element.
+ * @param b Second element.
+ * @param flag 0 or 1.
+ */
+template <size_t N>
+void conditionalSwap(FieldElement<N>& a, FieldElement<N>& b, mp_limb_t flag) {
+    mpn_cnd_swap(flag, a.limbs, b.limbs, N);
+}
+
+/**
+ * @class FixedExponent
+ * @brief A sliding-window recoding of an exponent, computed once and reused for every base.
+ *
+ * The exponent is cut into odd windows of at most windowWidth() bits separated
+ * by runs of zeros. Raising a base to it costs about one squaring per bit plus
+ * one multiplication per window, against a precomputed table of the odd powers
+ * a, a^3, .., a^(2^w - 1). The steps only depend on the exponent, so fixed
+ * public exponents such as p - 2 or (p + 1) / 4 are recoded once per field and
+ * the operations performed never depend on the base.
+ */
+class FixedExponent {
+public:
+    static const unsigned MAX_WIDTH = 5; ///< Widest window, a table of 16 odd powers.
+
+    /**
+     * @struct Step
+     * @brief Square the accumulator squarings times, then multiply by a^digit unless digit is 0.
+     */
+    struct Step {
+        uint32_t squarings; ///< Squarings before the multiplication.
+        uint32_t digit;     ///< Odd window value, or 0 for trailing zeros.
+    };
+
+    /**
+     * @brief The exponent zero.
+     */
+    FixedExponent() : width(1) {}
+
+    /**
+     * @brief Recodes an exponent, choosing the window width from its length.
+     * @param e Exponent limbs, least significant first.
+     * @param n Number of exponent limbs.
+     */
+    FixedExponent(const mp_limb_t* e, size_t n) {
+        size_t bits = 64 * n;
+        while (bits > 0 && !bit(e, bits - 1)) --bits;
+        width = bits > 384 ? 5 : bits > 96 ? 4 : bits > 24 ? 3 : bits > 6 ? 2 : 1;
+
+        uint32_t zeros = 0;
+        for (size_t i = bits; i-- > 0;) {
+            if (!bit(e, i)) {
+                ++zeros;
+                continue;
+            }
+            // the longest odd window e[i .. j] with at most width bits
+            size_t j = i + 1 > width ? i + 1 - width : 0;
+            while (!bit(e, j)) ++j;
+            uint32_t digit = 0;
+            for (size_t k = i + 1; k-- > j;) digit = 2 * digit + bit(e, k);
+            Step step = {zeros + static_cast<uint32_t>(i - j + 1), digit};
+            recoded.push_back(step);
+            zeros = 0;
+            i = j;
+        }
+        if (zeros > 0) {
+            Step step = {zeros, 0};
+            recoded.push_back(step);
+        }
+    }
+
+    /**
+     * @brief Get the window width.
+     * @return The width w; the table holds 2^(w - 1) odd powers.
+     */
+    unsigned windowWidth() const { return width; }
+
+    /**
+     * @brief Get the recoded steps, most significant window first.
+     * @return The steps; empty for the exponent zero.
+     */
+    const std::vector<Step>& steps() const { return recoded; }
+
+private:
+    static unsigned bit(const mp_limb_t* e, size_t i) { return (e[i / 64] >> (i % 64)) & 1; }
+
+    unsigned width;            ///< Window width in bits.
+    std::vector<Step> recoded; ///< The windows, most significant first.
+};
+
+/**
+ * @class PrimeFieldBase
+ * @brief Operations shared by every fixed-width prime field representation.
+ *
+ * Addition, subtraction, negation, exponentiation, Fermat inversion and square
+ * roots only depend on the modulus limbs and on the representation's own mul()
+ * and sqr(), so they are implemented once here and reused by MontgomeryField and
+ * ReducedField. Each of those adds inv(), the constant-time divstep inversion
+ * adjusted to its representation.
+ *
+ * @tparam N Number of limbs; p must be smaller than 2^(64 * N).
+ * @tparam Derived The concrete field type providing mul() and sqr().
+ */
+template <size_t N, class Derived>
+class PrimeFieldBase {
+public:
+    typedef FieldElement<N> Element; ///< Element type handled by this field.
+    static const size_t LIMBS = N;   ///< Number of limbs per element.
+
+    /**
+     * @brief Get the modulus of the field.
+     * @return The modulus p.
+     */
+    const BigInt& getMod() const { return mod; }
+
+    /**
+     * @brief Get the limbs of the modulus.
+     * @return Pointer to N limbs of p.
+     */
+    const mp_limb_t* modLimbs() const { return p; }
+
+    /**
+     * @brief The additive identity.
+     * @return Zero in the field's representation.
+     */
+    const Element& zero() const { return zeroM; }
+
+    /**
+     * @brief The multiplicative identity.
+     * @return One in the field's representation.
+     */
+    const Element& one() const { return oneM; }
+
+    /**
+     * @brief Modular addition r = a + b.
+     * @param r Destination; may alias a or b.
+     * @param a First operand.
+     * @param b Second operand.
+     */
+    void add(Element& r, const Element& a, const Element& b) const {
+        mp_limb_t cy = mpn_add_n(r.limbs, a.limbs, b.limbs, N);
+        reduceOnce(r.limbs, cy);
+    }
+
+    /**
+     * @brief Modular subtraction r = a - b.
+     * @param r Destination; may alias a or b.
+     * @param a The element to subtract from.
+     * @param b The element to subtract.
+     */
+    void sub(Element& r, const Element& a, const Element& b) const {
+        mp_limb_t bw = mpn_sub_n(r.limbs, a.limbs, b.limbs, N);
+        mpn_cnd_add_n(bw, r.limbs, r.limbs, p, N);
+    }
+
+    /**
+     * @brief Modular negation r = -a.
+     * @param r Destination; may alias a.
+     * @param a The element to negate.
+     */
+    void neg(Element& r, const Element& a) const { sub(r, zeroM, a); }
+
+    /**
+     * @brief Exponentiation r = a^e by sliding windows.
+     * @param r Destination; may alias a.
+     * @param a The base.
+     * @param e Exponent limbs, least significant first.
+     * @param n Number of exponent limbs.
+     */
+    void pow(Element& r, const Element& a, const mp_limb_t* e, size_t n) const {
+        powFixed(r, a, FixedExponent(e, n));
+    }
+
+    /**
+     * @brief Exponentiation r = a^e by an exponent recoded in advance.
+     * @param r Destination; may alias a.
+     * @param a The base.
+     * @param e The recoded exponent.
+     */
+    void powFixed(Element& r, const Element& a, const FixedExponent& e) const {
+        const Derived& self = static_cast<const Derived&>(*this);
+        Element table[1 << (FixedExponent::MAX_WIDTH - 1)];
+        const size_t entries = static_cast<size_t>(1) << (e.windowWidth() - 1);
+        table[0] = a;
+        if (entries > 1) {
+            Element a2;
+            self.sqr(a2, a);
+            for (size_t i = 1; i < entries; ++i) self.mul(table[i], table[i - 1], a2);
+        }
+
+        Element acc = oneM;
+        bool started = false;
+        for (const FixedExponent::Step& step : e.steps()) {
+            if (!started) {
+                // the first window sets the accumulator directly; steps start with a non-zero digit
+                acc = table[step.digit >> 1];
+                started = true;
+                continue;
+            }
+            for (uint32_t i = 0; i < step.squarings; ++i) self.sqr(acc, acc);
+            if (step.digit) self.mul(acc, acc, table[step.digit >> 1]);
+        }
+        r = acc;
+    }
+
+    /**
+     * @brief Modular inversion r = a^-1 via Fermat's little theorem, a^(p - 2) by sliding windows.
+     *
+     * The derived fields' inv() by divsteps is several times faster; this is the
+     * reference it is checked against, and the only choice for code that must
+     * avoid the __int128 arithmetic of the divsteps.
+     *
+     * @param r Destination; may alias a.
+     * @param a The element to invert; the inverse of zero is zero.
+     */
+    void invFermat(Element& r, const Element& a) const {
+        INSTRUMENT_COUNT(FieldInv);
+        powFixed(r, a, pMinus2);
+    }
+
+    /**
+     * @brief Square root for p = 3 mod 4, computed as a^((p + 1) / 4).
+     * @param r Destination, receives a root of a if there is one; may alias a.
+     * @param a The element.
+     * @return True if a is a square, false otherwise.
+     * @throw std::invalid_argument If p is not 3 mod 4.
+     */
+    bool sqrt(Element& r, const Element& a) const {
+        if ((p[0] & 3) != 3) {
+            throw std::invalid_argument("Square roots need a modulus p = 3 mod 4.");
+        }
+        Element root, check;
+        powFixed(root, a, sqrtExponent);
+        static_cast<const Derived&>(*this).sqr(check, root);
+        const bool square = check == a;
+        r = root;
+        return square;
+    }
+
+protected:
+    BigInt mod;                  ///< The modulus as a BigInt.
+    mp_limb_t p[N];              ///< The modulus limbs.
+    FixedExponent pMinus2;       ///< p - 2, the Fermat inversion exponent.
+    FixedExponent sqrtExponent;  ///< (p + 1) / 4 if p = 3 mod 4.
+    SafegcdInverter<N> inverter; ///< Constant-time inversion modulo p.
+    Element oneM;                ///< One in the field's representation.
+    Element zeroM;               ///< Zero.
+
+    /**
+     * @brief Stores the modulus and the constants derived from it.
+     * @param modulus The odd prime modulus p.
+     * @throw std::invalid_argument If the modulus is even or does not fit in N limbs.
+     */
+    explicit PrimeFieldBase(const BigInt& modulus) : mod(checkedModulus(modulus)), inverter(p) {
+        mp_limb_t e[N];
+        mpn_sub_1(e, p, N, 2);
+        pMinus2 = FixedExponent(e, N);
+        if ((p[0] & 3) == 3) {
+            mpn_rshift(e, p, N, 2);
+            mpn_add_1(e, e, N, 1);
+            sqrtExponent = FixedExponent(e, N);
+        }
+        std::memset(zeroM.limbs, 0, sizeof(zeroM.limbs));
+    }
+
+    /**
+     * @brief Constant-time inversion of the canonical limbs of a value, r = a^-1 mod p.
+     * @param r Destination limbs; may alias a.
+     * @param a The canonical value, below p.
+     */
+    void gcdInverse(mp_limb_t* r, const mp_limb_t* a) const { inverter.invert(r, a); }
+
+    /**
+     * @brief Validates the modulus and stores its limbs, ahead of the members built from them.
+     * @param modulus The modulus.
+     * @return The modulus.
+     * @throw std::invalid_argument If the modulus is even or does not fit in N limbs.
+     */
+    const BigInt& checkedModulus(const BigInt& modulus) {
+        if (modulus.bitSize() > 64 * N || !modulus.testBit(0)) {
+            throw std::invalid_argument("Field modulus must be odd and fit in the limb count.");
+        }
+        modulus.toLimbs(p, N);
+        return modulus;
+    }
+
+    /**
+     * @brief Subtracts p once if the N-limb value plus carry is not below p.
+     * @param r The value to reduce in place.
+     * @param cy Carry out of the limb above r.
+     */
+    void reduceOnce(mp_limb_t* r, mp_limb_t cy) const {
+        mp_limb_t s[N];
+        mp_limb_t bw = mpn_sub_n(s, r, p, N);
+        mp_limb_t mask = -static_cast<mp_limb_t>(cy | (bw ^ 1));
+        for (size_t i = 0; i < N; ++i) r[i] = (s[i] & mask) | (r[i] & ~mask);
+    }
+};
+
+/**
+ * @class MontgomeryField
+ * @brief Arithmetic modulo an odd prime p on N-limb elements kept in Montgomery form.
+ *
+ * An element x is stored as x * R mod p with R = 2^(64 * N). Construction
+ * precomputes -p^-1 mod 2^64, R mod p and R^2 mod p once, so every operation
+ * afterwards runs on fixed-size stack buffers only.
+ *
+ * @tparam N Number of limbs; p must be smaller than 2^(64 * N).
+ */
+template <size_t N>
+class MontgomeryField : public PrimeFieldBase<N, MontgomeryField<N> > {
+    typedef PrimeFieldBase<N, MontgomeryField<N> > Base;
+
+public:
+    typedef typename Base::Element Element; ///< Element type handled by this field.
+
+    /**
+     * @brief Constructs the field for a given odd modulus.
+     * @param modulus The odd prime modulus p.
+     * @throw std::invalid_argument If the modulus is even or does not fit in N limbs.
+     */
+    explicit MontgomeryField(const BigInt& modulus) : Base(modulus) {
+        // Newton iteration for p^-1 mod 2^64, each step doubles the correct bits.
+        mp_limb_t inv = this->p[0];
+        for (int i = 0; i < 5; ++i) inv *= 2 - this->p[0] * inv;
+        pInv = -inv;
+
+        BigInt r = BigInt(static_cast<unsigned long int>(1)).leftShift(64 * N) % modulus;
+        r.toLimbs(this->oneM.limbs, N);
+        const BigInt rSquared = (r * r) % modulus;
+        rSquared.toLimbs(r2.limbs, N);
+        ((rSquared * r) % modulus).toLimbs(r3.limbs, N);
+    }
+
+    /**
+     * @brief Converts a BigInt into a field element in Montgomery form.
+     * @param x The value to convert; it is reduced modulo p first.
+     * @return x * R mod p.
+     */
+    Element fromBigInt(const BigInt& x) const {
+        Element r;
+        (x % this->mod).toLimbs(r.limbs, N);
+        mul(r, r, r2);
+        return r;
+    }
+
+    /**
+     * @brief Converts a field element back into a canonical BigInt.
+     * @param a The element in Montgomery form.
+     * @return The value a * R^-1 mod p in [0, p).
+     */
+    BigInt toBigInt(const Element& a) const {
+        Element r;
+        fromMontgomery(r, a);
+        return BigInt::fromLimbs(r.limbs, N);
+    }
+
+    /**
+     * @brief Enters Montgomery form from the canonical limbs of a value.
+     * @param r Destination, receives a * R mod p; may alias a.
+     * @param a The canonical value, below p.
+     */
+    void toMontgomery(Element& r, const Element& a) const { mul(r, a, r2); }
+
+    /**
+     * @brief Strips the Montgomery factor, leaving the canonical limbs of the value.
+     * @param r Destination, receives a * R^-1 mod p.
+     * @param a The element in Montgomery form.
+     */
+    void fromMontgomery(Element& r, const Element& a) const {
+        mp_limb_t t[2 * N];
+        std::memcpy(t, a.limbs, sizeof(a.limbs));
+        std::memset(t + N, 0, sizeof(a.limbs));
+        redc(r.limbs, t);
+    }
+
+    /**
+     * @brief Montgomery multiplication r = a * b * R^-1.
+     * @param r Destination; may alias a or b.
+     * @param a First operand.
+     * @param b Second operand.
+     */
+    void mul(Element& r, const Element& a, const Element& b) const {
+        INSTRUMENT_COUNT(FieldMul);
+        mp_limb_t t[2 * N];
+        mpn_mul_n(t, a.limbs, b.limbs, N);
+        redc(r.limbs, t);
+    }
+
+    /**
+     * @brief Montgomery squaring r = a * a * R^-1.
+     * @param r Destination; may alias a.
+     * @param a The element to square.
+     */
+    void sqr(Element& r, const Element& a) const {
+        INSTRUMENT_COUNT(FieldSqr);
+        mp_limb_t t[2 * N];
+        mpn_sqr(t, a.limbs, N);
+        redc(r.limbs, t);
+    }
+
+    /**
+     * @brief Constant-time modular inversion r = a^-1 by Bernstein-Yang divsteps.
+     *
+     * The divsteps invert the stored value a R into a^-1 R^-1; one Montgomery
+     * multiplication by R^3 brings that back to a^-1 R.
+     *
+     * @param r Destination; may alias a.
+     * @param a The element to invert; the inverse of zero is zero.
+     */
+    void inv(Element& r, const Element& a) const {
+        INSTRUMENT_COUNT(FieldInv);
+        this->gcdInverse(r.limbs, a.limbs);
+        mul(r, r, r3);
+    }
+
+private:
+    mp_limb_t pInv; ///< -p^-1 mod 2^64.
+    Element r2;     ///< R^2 mod p, used to enter Montgomery form.
+    Element r3;     ///< R^3 mod p, used to correct inverses.
+
+    /**
+     * @brief Montgomery reduction of a 2N-limb value t < p * R into r = t * R^-1 mod p.
+     *
+     * The carries of each row are collected and added to the high half in one
+     * pass, which is valid because row i only touches limbs i .. i + N.
+     *
+     * @param r Destination of N limbs.
+     * @param t The 2N-limb product; it is clobbered.
+     */
+    void redc(mp_limb_t* r, mp_limb_t* t) const {
+        mp_limb_t c[N];
+        for (size_t i = 0; i < N; ++i) {
+            c[i] = mpn_addmul_1(t + i, this->p, N, t[i] * pInv);
+        }
+        mp_limb_t cy = mpn_add_n(r, t + N, c, N);
+        this->reduceOnce(r, cy);
+    }
+};
+
+/**
+ * @class ReducedField
+ * @brief Arithmetic modulo a special prime with a dedicated reduction routine.
+ *
+ * Elements are kept in canonical form (no Montgomery factor). Products are
+ * reduced by the curve's own folding routine, which for Solinas and Mersenne
+ * style primes is much cheaper than a generic Montgomery reduction.
+ *
+ * @tparam C A curve trait providing LIMBS, the modulus limbs P,
+ *           a static reduce(r, t) mapping a 2 * LIMBS product to [0, p),
+ *           a static invPower(r, a) computing a^(p - 2) and, for sqrt(),
+ *           a static sqrtPower(r, a) computing a^((p + 1) / 4).
+ */
+template <class C>
+class ReducedField : public PrimeFieldBase<C::LIMBS, ReducedField<C> > {
+    typedef PrimeFieldBase<C::LIMBS, ReducedField<C> > Base;
+
+public:
+    typedef typename Base::Element Element; ///< Element type handled by this field.
+
+    /**
+     * @brief Constructs the field from the curve trait's modulus.
+     */
+    ReducedField() : Base(BigInt::fromLimbs(C::P, C::LIMBS)) {
+        std::memset(this->oneM.limbs, 0, sizeof(this->oneM.limbs));
+        this->oneM.limbs[0] = 1;
+    }
+
+    /**
+     * @brief Converts a BigInt into a field element.
+     * @param x The value to convert; it is reduced modulo p first.
+     * @return x mod p.
+     */
+    Element fromBigInt(const BigInt& x) const {
+        Element r;
+        (x % this->mod).toLimbs(r.limbs, C::LIMBS);
+        return r;
+    }
+
+    /**
+     * @brief Converts a field element into a BigInt.
+     * @param a The element.
+     * @return The value of a in [0, p).
+     */
+    BigInt toBigInt(const Element& a) const {
+        return BigInt::fromLimbs(a.limbs, C::LIMBS);
+    }
+
+    /**
+     * @brief Modular multiplication r = a * b.
+     * @param r Destination; may alias a or b.
+     * @param a First operand.
+     * @param b Second operand.
+     */
+    void mul(Element& r, const Element& a, const Element& b) const {
+        INSTRUMENT_COUNT(FieldMul);
+        mp_limb_t t[2 * C::LIMBS];
+        mpn_mul_n(t, a.limbs, b.limbs, C::LIMBS);
+        C::reduce(r.limbs, t);
+    }
+
+    /**
+     * @brief Modular squaring r = a * a.
+     * @param r Destination; may alias a.
+     * @param a The element to square.
+     */
+    void sqr(Element& r, const Element& a) const {
+        INSTRUMENT_COUNT(FieldSqr);
+        mp_limb_t t[2 * C::LIMBS];
+        mpn_sqr(t, a.limbs, C::LIMBS);
+        C::reduce(r.limbs, t);
+    }
+
+    /**
+     * @brief Constant-time modular inversion r = a^-1 by Bernstein-Yang divsteps.
+     * @param r Destination; may alias a.
+     * @param a The element to invert; the inverse of zero is zero.
+     */
+    void inv(Element& r, const Element& a) const {
+        INSTRUMENT_COUNT(FieldInv);
+        this->gcdInverse(r.limbs, a.limbs);
+    }
+
+    /**
+     * @brief Modular inversion r = a^-1 = a^(p - 2) by the curve's addition chain.
+     * @param r Destination; may alias a.
+     * @param a The element to invert; the inverse of zero is zero.
+     */
+    void invFermat(Element& r, const Element& a) const {
+        INSTRUMENT_COUNT(FieldInv);
+        C::invPower(r, a);
+    }
+
+    /**
+     * @brief Square root for p = 3 mod 4, computed as a^((p + 1) / 4) by the curve's addition chain.
+     * @param r Destination, receives a root of a if there is one; may alias a.
+     * @param a The element.
+     * @return True if a is a square, false otherwise.
+     */
+    bool sqrt(Element& r, const Element& a) const {
+        Element root, check;
+        C::sqrtPower(root, a);
+        sqr(check, root);
+        const bool square = check == a;
+        r = root;
+        return square;
+    }
+};
+
+/**
+ * @brief Largest limb count visitMontgomeryField() instantiates, i.e. moduli below 2^512.
+ */
+const size_t MONTGOMERY_MAX_LIMBS = 8;
+
+/**
+ * @brief Runs a visitor on the MontgomeryField width matching a runtime limb count.
+ *
+ * The visitor provides a result_type typedef and a member template
+ * run<N>() which is instantiated once per width from 1 to MONTGOMERY_MAX_LIMBS.
+ *
+ * @param limbs Number of limbs of the modulus.
+ * @param visitor The visitor to run.
+ * @return The visitor's result for the selected width.
+ * @throw std::invalid_argument If the limb count is 0 or above MONTGOMERY_MAX_LIMBS.
+ */
+template <class Visitor>
+typename Visitor::result_type visitMontgomeryField(size_t limbs, Visitor& visitor) {
+    switch (limbs) {
+        case 1: return visitor.template run<1>();
+        case 2: return visitor.template run<2>();
+        case 3: return visitor.template run<3>();
+        case 4: return visitor.template run<4>();
+        case 5: return visitor.template run<5>();
+        case 6: return visitor.template run<6>();
+        case 7: return visitor.template run<7>();
+        case 8: return visitor.template run<8>();
+    }
+    throw std::invalid_argument("Unsupported modulus size.");
+}
+
+#endif // FIELD_HPP
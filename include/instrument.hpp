@@ -0,0 +1,236 @@
+/**
+ * @file instrument.hpp
+ * @brief Opt-in operation counters and phase timers for the arithmetic hot paths.
+ *
+ * Building with ZKSNARKS_INSTRUMENTATION defined (the CMake option of the same
+ * name) turns on:
+ * - thread-local counters bumped by BigInt multiplications, reductions and
+ *   inversions, field multiplications, squarings and inversions, and point
+ *   additions and doublings;
+ * - the count and size of GMP allocations, through mp_set_memory_functions();
+ * - scoped timers around Ecc_Point::operator*, multiplyPolynomials() and
+ *   interpolation. Each timer also charges the counters of its thread to
+ *   its phase.
+ * Without the define, the INSTRUMENT_* macros expand to nothing and the hot
+ * paths are unchanged; the Instrumentation functions still link and report
+ * zeros.
+ *
+ * A counter is a relaxed atomic and only its own thread writes it, so an
+ * increment is a load and a store, with no locked instruction. snapshot()
+ * sums the counters of all live threads and of the threads that have exited.
+ * A phase only sees the work of the thread that entered it; work handed to
+ * a ThreadPool shows up in the totals, not under the phase.
+ */
+
+#ifndef INSTRUMENT_HPP
+#define INSTRUMENT_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+/**
+ * @enum Counter
+ * @brief The operations that are counted.
+ */
+enum class Counter {
+    BigIntMul,         ///< BigInt products: operator*, operator*= and mulMod().
+    BigIntMod,         ///< BigInt reductions: operator%, operator%= and mulMod().
+    BigIntInvert,      ///< BigInt modular inversions: invert() and modInverse().
+    FieldMul,          ///< Fixed-width field multiplications.
+    FieldSqr,          ///< Fixed-width field squarings.
+    FieldInv,          ///< Fixed-width field inversions, by divsteps or by Fermat.
+    PointAdd,          ///< Point additions, affine, Jacobian or projective, mixed or not.
+    PointDouble,       ///< Point doublings.
+    GmpAllocations,    ///< Calls to the GMP allocate and reallocate functions.
+    GmpAllocatedBytes  ///< Bytes requested by those calls.
+};
+
+const size_t COUNTER_COUNT = 10; ///< Number of Counter values.
+
+/**
+ * @enum Phase
+ * @brief The operations that are timed.
+ */
+enum class Phase {
+    ScalarMul,           ///< Ecc_Point::operator*.
+    MultiplyPolynomials, ///< multiplyPolynomials().
+    Interpolate          ///< interpolate() and Interpolator::interpolate().
+};
+
+const size_t PHASE_COUNT = 3; ///< Number of Phase values.
+
+/**
+ * @struct PhaseStats
+ * @brief Totals of one phase.
+ */
+struct PhaseStats {
+    uint64_t calls;                   ///< Outermost entries; nested entries of the same phase are not counted.
+    uint64_t nanoseconds;             ///< Wall-clock time inside the phase.
+    uint64_t counters[COUNTER_COUNT]; ///< Counter increments made by the entering thread inside the phase.
+};
+
+/**
+ * @struct InstrumentationSnapshot
+ * @brief Totals over all threads.
+ */
+struct InstrumentationSnapshot {
+    uint64_t counters[COUNTER_COUNT]; ///< Counter totals, indexed by Counter.
+    PhaseStats phases[PHASE_COUNT];   ///< Phase totals, indexed by Phase.
+};
+
+/**
+ * @class ThreadInstrumentation
+ * @brief The counters and phase totals of one thread.
+ *
+ * The block registers itself on first use and folds its totals into the
+ * process totals when the thread exits.
+ */
+class ThreadInstrumentation {
+public:
+    /**
+     * @brief Get the block of the calling thread.
+     * @return The thread-local block, created on first use.
+     */
+    static ThreadInstrumentation& local() {
+        static thread_local ThreadInstrumentation block;
+        return block;
+    }
+
+    /**
+     * @brief Adds to a counter of this thread.
+     * @param c The counter.
+     * @param n The increment.
+     */
+    void add(Counter c, uint64_t n) {
+        std::atomic<uint64_t>& v = counters[static_cast<size_t>(c)];
+        v.store(v.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    ThreadInstrumentation(const ThreadInstrumentation&) = delete;
+    ThreadInstrumentation& operator=(const ThreadInstrumentation&) = delete;
+
+private:
+    friend class Instrumentation;
+    friend class ScopedPhaseTimer;
+
+    ThreadInstrumentation();
+    ~ThreadInstrumentation();
+
+    std::atomic<uint64_t> counters[COUNTER_COUNT];                   ///< Counter totals.
+    std::atomic<uint64_t> phaseCalls[PHASE_COUNT];                   ///< Outermost phase entries.
+    std::atomic<uint64_t> phaseNanoseconds[PHASE_COUNT];             ///< Time inside each phase.
+    std::atomic<uint64_t> phaseCounters[PHASE_COUNT][COUNTER_COUNT]; ///< Counter increments inside each phase.
+    unsigned depth[PHASE_COUNT];                                     ///< Nesting depth of each phase.
+};
+
+/**
+ * @class ScopedPhaseTimer
+ * @brief Charges the time and the counter increments of a scope to a phase.
+ *
+ * Only the outermost timer of a phase on a thread records anything, so a
+ * phase that calls itself, e.g. recursive polynomial products, is not
+ * counted twice.
+ */
+class ScopedPhaseTimer {
+public:
+    /**
+     * @brief Enters a phase.
+     * @param phase The phase.
+     */
+    explicit ScopedPhaseTimer(Phase phase);
+
+    /**
+     * @brief Leaves the phase and adds its time and counter increments.
+     */
+    ~ScopedPhaseTimer();
+
+    ScopedPhaseTimer(const ScopedPhaseTimer&) = delete;
+    ScopedPhaseTimer& operator=(const ScopedPhaseTimer&) = delete;
+
+private:
+    ThreadInstrumentation& block;                 ///< The block of the entering thread.
+    size_t index;                                 ///< The phase.
+    bool outermost;                               ///< True if this timer records.
+    std::chrono::steady_clock::time_point start;  ///< Entry time.
+    uint64_t startCounters[COUNTER_COUNT];        ///< Counters at entry.
+};
+
+/**
+ * @class Instrumentation
+ * @brief Process-wide access to the counters and phase totals.
+ */
+class Instrumentation {
+public:
+    /**
+     * @brief Check whether the library was built with instrumentation.
+     * @return True if ZKSNARKS_INSTRUMENTATION was defined.
+     */
+    static bool enabled();
+
+    /**
+     * @brief Sums the counters and phase totals of all threads.
+     * @return The totals since start-up or the last reset().
+     */
+    static InstrumentationSnapshot snapshot();
+
+    /**
+     * @brief Zeroes all counters and phase totals.
+     *
+     * Increments that other threads make during the reset may survive it, so
+     * call it while no instrumented work is running.
+     */
+    static void reset();
+
+    /**
+     * @brief Writes the counter totals and a per-phase summary.
+     *
+     * Instrumented builds also print this report to stderr at exit.
+     *
+     * @param os The stream to write to.
+     */
+    static void report(std::ostream& os);
+
+    /**
+     * @brief Get the name of a counter.
+     * @param c The counter.
+     * @return A short name such as "field.mul".
+     */
+    static const char* name(Counter c);
+
+    /**
+     * @brief Get the name of a phase.
+     * @param p The phase.
+     * @return A short name such as "multiplyPolynomials".
+     */
+    static const char* name(Phase p);
+
+    /**
+     * @brief Routes GMP allocations through counting wrappers of the current functions.
+     *
+     * Instrumented builds call this during static initialization. A
+     * BigIntArena installed later counts the blocks it serves and passes
+     * the rest to the wrappers, so every allocation is counted once.
+     * Calling it again has no effect.
+     */
+    static void installGmpHooks();
+};
+
+#ifdef ZKSNARKS_INSTRUMENTATION
+#define INSTRUMENT_CONCAT2(a, b) a##b
+#define INSTRUMENT_CONCAT(a, b) INSTRUMENT_CONCAT2(a, b)
+/// Adds n to a Counter of the calling thread.
+#define INSTRUMENT_ADD(counter, n) ThreadInstrumentation::local().add(Counter::counter, (n))
+/// Adds 1 to a Counter of the calling thread.
+#define INSTRUMENT_COUNT(counter) INSTRUMENT_ADD(counter, 1)
+/// Charges the rest of the enclosing scope to a Phase.
+#define INSTRUMENT_PHASE(phase) ScopedPhaseTimer INSTRUMENT_CONCAT(instrumentPhase, __LINE__)(Phase::phase)
+#else
+#define INSTRUMENT_ADD(counter, n) ((void)0)
+#define INSTRUMENT_COUNT(counter) ((void)0)
+#define INSTRUMENT_PHASE(phase) ((void)0)
+#endif
+
+#endif // INSTRUMENT_HPP
@@ -0,0 +1,264 @@
+/**
+ * @file interpolation.hpp
+ * @brief Lagrange interpolation and multipoint evaluation over Z/modZ.
+ *
+ * interpolate() evaluates the interpolating polynomial of a few points at one
+ * position in O(n^2). Interpolator handles large point sets in O(M(n) log n),
+ * M(n) being the cost of a polynomial multiplication: it builds the subproduct
+ * tree of the x-coordinates once, then reduces a polynomial down the tree to
+ * evaluate it at every point, or combines weighted values up the tree to
+ * recover the coefficients of the interpolating polynomial. LagrangeDomain
+ * keeps the barycentric weights of a point set to evaluate the interpolating
+ * polynomial of many value sets at many positions in O(n) each.
+ */
+
+#ifndef INTERPOLATION_HPP
+#define INTERPOLATION_HPP
+
+#include "bigint.hpp"
+#include "limbs.hpp"
+#include "polynomial.hpp"
+#include "vecmod.hpp"
+#include <string>
+#include <vector>
+
+/**
+ * @struct Data
+ * @brief A point (x, y) with both coordinates reduced modulo the field modulus.
+ */
+struct Data {
+    BigInt x, y;
+
+    /**
+     * @brief Parses a point.
+     * @param xStr The x-coordinate in decimal.
+     * @param yStr The y-coordinate in decimal.
+     * @param modStr The modulus in decimal.
+     */
+    Data(const std::string& xStr, const std::string& yStr, const std::string& modStr);
+};
+
+/**
+ * @brief Evaluates the interpolating polynomial of a set of points at one position.
+ * @param f The points, with distinct x-coordinates.
+ * @param xi The position to evaluate at.
+ * @param modStr The modulus in decimal.
+ * @return The value of the polynomial of degree below f.size() through all points, at xi.
+ * @throw std::runtime_error If two x-coordinates coincide modulo the modulus.
+ */
+BigInt interpolate(const std::vector<Data>& f, const BigInt& xi, const std::string& modStr);
+
+/**
+ * @class Interpolator
+ * @brief Subproduct tree over a fixed set of x-coordinates.
+ *
+ * The leaves hold the products of (X - x_i) over groups of consecutive points
+ * and every inner node the product of its two children, so the root is the
+ * vanishing polynomial of the whole set. Evaluating reduces a polynomial
+ * modulo each node from the root down, two products per node thanks to the
+ * power series inverses of the reversed nodes kept with the tree, and
+ * finishes the leaf groups with interleaved Horner steps; interpolating scales the values by the weights
+ * 1 / M'(x_i), found once in the constructor with one batch inversion, and
+ * merges f = f_left * M_right + f_right * M_left from the leaves up.
+ */
+class Interpolator {
+public:
+    /**
+     * @brief Builds the tree over the given x-coordinates.
+     * @param xs The x-coordinates, distinct modulo the modulus; they are reduced first.
+     * @param modulus The field modulus, a prime for interpolation to be well defined.
+     * @param threads Number of threads, 1 to run serially, or 0 to use the shared pool.
+     * @throw std::invalid_argument If two x-coordinates coincide or their differences are not invertible.
+     */
+    Interpolator(const std::vector<BigInt>& xs, const BigInt& modulus, unsigned threads = 0);
+
+    /**
+     * @brief Builds the tree over the x-coordinates of a set of points.
+     * @param points The points, with distinct x-coordinates.
+     * @param modulus The field modulus.
+     * @param threads Number of threads, 1 to run serially, or 0 to use the shared pool.
+     * @throw std::invalid_argument If two x-coordinates coincide or their differences are not invertible.
+     */
+    Interpolator(const std::vector<Data>& points, const BigInt& modulus, unsigned threads = 0);
+
+    /**
+     * @brief Get the number of points.
+     * @return The number of x-coordinates.
+     */
+    size_t size() const { return count; }
+
+    /**
+     * @brief Get the vanishing polynomial of the point set.
+     * @return prod_i (X - x_i), size() + 1 coefficients.
+     */
+    const Polynomial& vanishing() const { return tree.back().front(); }
+
+    /**
+     * @brief Evaluates a polynomial at every x-coordinate.
+     * @param f The polynomial, over the same modulus.
+     * @return f(x_i) in the order of the x-coordinates.
+     * @throw std::invalid_argument If the modulus of f differs.
+     */
+    std::vector<BigInt> evaluate(const Polynomial& f) const;
+
+    /**
+     * @brief Computes the polynomial taking given values at the x-coordinates.
+     * @param ys The values, one per x-coordinate; they are reduced first.
+     * @return The unique polynomial of degree below size() with f(x_i) = ys[i], size() coefficients.
+     * @throw std::invalid_argument If the number of values differs from size().
+     */
+    Polynomial interpolate(const std::vector<BigInt>& ys) const;
+
+    /**
+     * @brief Computes the polynomial through a set of points.
+     * @param points The points, with the x-coordinates the tree was built for, in the same order.
+     * @return The unique polynomial of degree below size() through all points.
+     * @throw std::invalid_argument If the number of points differs from size().
+     */
+    Polynomial interpolate(const std::vector<Data>& points) const;
+
+private:
+    friend class LagrangeDomain;
+    friend std::vector<BigInt> multipointEvaluate(const Polynomial& f, const std::vector<BigInt>& points);
+    friend std::vector<Polynomial> batchInterpolate(const Interpolator& interpolator,
+                                                    const std::vector<std::vector<BigInt> >& columns, unsigned threads,
+                                                    size_t grain);
+
+    // Builds the tree, and the interpolation weights if weighted is set.
+    Interpolator(const std::vector<BigInt>& xs, const BigInt& modulus, unsigned threads, bool weighted);
+
+    void evaluateLimbs(const Polynomial& f, mp_limb_t* values) const;
+
+    // interpolate() with the threads of the merges given explicitly.
+    Polynomial interpolate(const std::vector<BigInt>& ys, unsigned threads) const;
+
+    BigInt mod;
+    VecModulus vecMod;
+    unsigned threads;
+    size_t width;
+    size_t count;
+    LimbBuffer points;  ///< The reduced x-coordinates, count * width limbs.
+    LimbBuffer weights; ///< 1 / M'(x_i) for every point, empty for evaluation only.
+    std::vector<std::vector<Polynomial> > tree; ///< tree[0] the leaf groups, tree.back() the root.
+    std::vector<std::vector<Polynomial> > inverses; ///< 1 / rev(node) below the root, to the precision its divisions need.
+};
+
+/**
+ * @brief Evaluates a polynomial at many points with a subproduct tree.
+ * @param f The polynomial.
+ * @param points The evaluation points.
+ * @return f at every point, in order.
+ */
+std::vector<BigInt> multipointEvaluate(const Polynomial& f, const std::vector<BigInt>& points);
+
+/**
+ * @brief Interpolates many columns of values over the x-coordinates of one tree.
+ *
+ * With more columns than grain, whole columns are spread over the pool and
+ * each is interpolated on a single thread; otherwise the columns run one
+ * after the other with the threads of the interpolator.
+ *
+ * @param interpolator The tree over the shared x-coordinates.
+ * @param columns The values of every column, size() each.
+ * @param threads Number of threads, 1 to run serially, or 0 to use the shared pool.
+ * @param grain Columns per task (default is 1).
+ * @return The interpolating polynomial of every column.
+ * @throw std::invalid_argument If a column has the wrong number of values.
+ */
+std::vector<Polynomial> batchInterpolate(const Interpolator& interpolator, const std::vector<std::vector<BigInt> >& columns,
+                                         unsigned threads = 0, size_t grain = 1);
+
+/**
+ * @brief Evaluates the interpolating polynomials of many point sets at one point, as interpolate() does for one.
+ * @param columns The point sets; each needs distinct x-coordinates.
+ * @param xi The point at which to evaluate.
+ * @param modStr The modulus in decimal.
+ * @param threads Number of threads, 1 to run serially, or 0 to use the shared pool.
+ * @param grain Point sets per task (default is 1); at most grain sets are evaluated serially.
+ * @return The value at xi for every point set.
+ */
+std::vector<BigInt> batchInterpolate(const std::vector<std::vector<Data> >& columns, const BigInt& xi,
+                                     const std::string& modStr, unsigned threads = 0, size_t grain = 1);
+
+/**
+ * @class LagrangeDomain
+ * @brief Barycentric weights of a fixed set of x-coordinates.
+ *
+ * With M = prod_i (X - x_i) and w_i = 1 / M'(x_i), the polynomial of degree
+ * below n through (x_i, y_i) takes at z the value M(z) * sum_i w_i y_i / (z - x_i).
+ * The weights are computed once, so every position costs O(n) products and
+ * one batch inversion of the differences z - x_i. For the n-th roots of unity
+ * M = X^n - 1 and w_i = x_i / n, which need no inversion at all.
+ */
+class LagrangeDomain {
+public:
+    /**
+     * @brief Computes the weights of arbitrary x-coordinates.
+     *
+     * Small sets multiply out their differences directly, larger ones go
+     * through the subproduct tree of Interpolator.
+     *
+     * @param xs The x-coordinates, distinct modulo the modulus; they are reduced first.
+     * @param modulus The field modulus, a prime.
+     * @param threads Number of threads for large sets, 1 to run serially, or 0 to use the shared pool.
+     * @throw std::invalid_argument If two x-coordinates coincide or their differences are not invertible.
+     */
+    LagrangeDomain(const std::vector<BigInt>& xs, const BigInt& modulus, unsigned threads = 0);
+
+    /**
+     * @brief Uses the powers 1, omega, ..., omega^(n - 1) as x-coordinates, with closed form weights.
+     * @param n The number of points.
+     * @param omega A primitive n-th root of unity.
+     * @param modulus The field modulus, a prime.
+     * @throw std::invalid_argument If n is zero or omega is not a primitive n-th root of unity.
+     */
+    LagrangeDomain(size_t n, const BigInt& omega, const BigInt& modulus);
+
+    /**
+     * @brief Get the number of points.
+     * @return The number of x-coordinates.
+     */
+    size_t size() const { return points.size(); }
+
+    /**
+     * @brief Get one x-coordinate.
+     * @param i The index of the point.
+     * @return x_i, reduced.
+     */
+    const BigInt& point(size_t i) const { return points[i]; }
+
+    /**
+     * @brief Get one barycentric weight.
+     * @param i The index of the point.
+     * @return w_i = 1 / prod_{j != i} (x_i - x_j).
+     */
+    const BigInt& weight(size_t i) const { return weights[i]; }
+
+    /**
+     * @brief Evaluates every Lagrange basis polynomial at one position.
+     * @param z The position.
+     * @return L_i(z) for every point, L_i being 1 at x_i and 0 at the other points.
+     */
+    std::vector<BigInt> basis(const BigInt& z) const;
+
+    /**
+     * @brief Evaluates the interpolating polynomial of a value set at one position.
+     * @param ys The values, one per x-coordinate.
+     * @param z The position.
+     * @return sum_i ys[i] * L_i(z).
+     * @throw std::invalid_argument If the number of values differs from size().
+     */
+    BigInt evaluate(const std::vector<BigInt>& ys, const BigInt& z) const;
+
+private:
+    // Sets terms[i] to w_i / (z - x_i) and returns M(z), or returns the index of the
+    // point z coincides with, leaving terms empty.
+    size_t prepare(const BigInt& z, std::vector<BigInt>& terms, BigInt& vanishingAtZ) const;
+
+    BigInt mod;
+    std::vector<BigInt> points;
+    std::vector<BigInt> weights;
+    bool rootsOfUnity; ///< Set if points[i] = omega^i, so that M(z) = z^n - 1.
+};
+
+#endif // INTERPOLATION_HPP
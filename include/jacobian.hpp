@@ -0,0 +1,449 @@
+/**
+ * @file jacobian.hpp
+ * @brief Inversion-free elliptic curve arithmetic in Jacobian coordinates.
+ *
+ * A Jacobian point (X, Y, Z) represents the affine point (X / Z^2, Y / Z^3) on
+ * y^2 = x^3 + ax + b. Addition, mixed addition and doubling need no field
+ * inversion, so a scalar multiplication converts back to affine only once.
+ */
+
+#ifndef JACOBIAN_HPP
+#define JACOBIAN_HPP
+
+#include "field.hpp"
+#include <vector>
+
+/**
+ * @struct AffinePoint
+ * @brief An affine point over a fixed-width field.
+ * @tparam F The field type, e.g. MontgomeryField<4>.
+ */
+template <class F>
+struct AffinePoint {
+    typename F::Element x; ///< x-coordinate.
+    typename F::Element y; ///< y-coordinate.
+    bool infinity;         ///< True for the point at infinity.
+};
+
+/**
+ * @struct JacobianPoint
+ * @brief A point in Jacobian coordinates; Z = 0 encodes the point at infinity.
+ * @tparam F The field type, e.g. MontgomeryField<4>.
+ */
+template <class F>
+struct JacobianPoint {
+    typename F::Element X; ///< X-coordinate, x = X / Z^2.
+    typename F::Element Y; ///< Y-coordinate, y = Y / Z^3.
+    typename F::Element Z; ///< Z-coordinate.
+
+    /**
+     * @brief Check if the point is the point at infinity.
+     * @return True if Z is zero, false otherwise.
+     */
+    bool isInfinity() const { return Z.isZero(); }
+};
+
+/**
+ * @class JacobianCurve
+ * @brief Point formulas for a short Weierstrass curve in Jacobian coordinates.
+ *
+ * The doubling formula is picked once from the value of 'a': a = -3 (NIST
+ * curves) and a = 0 (secp256k1) have cheaper dedicated formulas, every other
+ * curve uses the generic one. Formulas follow the Explicit-Formulas Database
+ * (dbl-2001-b, dbl-2009-l, dbl-2007-bl, add-2007-bl, madd-2007-bl).
+ *
+ * @tparam F The field type, e.g. MontgomeryField<4>.
+ */
+template <class F>
+class JacobianCurve {
+public:
+    typedef typename F::Element Element;  ///< Field element type.
+    typedef AffinePoint<F> Affine;        ///< Affine point type.
+    typedef JacobianPoint<F> Jacobian;    ///< Jacobian point type.
+
+    /**
+     * @brief Constructs the curve arithmetic for a field and coefficient a.
+     * @param field The base field; it must outlive this object.
+     * @param a The curve coefficient a, in the field's representation.
+     */
+    JacobianCurve(const F& field, const Element& a) : F_(field), a_(a) {
+        Element minus3;
+        F_.add(minus3, F_.one(), F_.one());
+        F_.add(minus3, minus3, F_.one());
+        F_.neg(minus3, minus3);
+        aKind = a.isZero() ? A_ZERO : (a == minus3 ? A_MINUS_3 : A_GENERIC);
+    }
+
+    /**
+     * @brief Get the base field.
+     * @return The field this curve is defined over.
+     */
+    const F& field() const { return F_; }
+
+    /**
+     * @brief Get the curve coefficient a.
+     * @return a in the field's representation.
+     */
+    const Element& a() const { return a_; }
+
+    /**
+     * @brief Set R to the point at infinity.
+     * @param R The point to clear.
+     */
+    void setInfinity(Jacobian& R) const {
+        R.X = F_.one();
+        R.Y = F_.one();
+        R.Z = F_.zero();
+    }
+
+    /**
+     * @brief Lift an affine point to Jacobian coordinates with Z = 1.
+     * @param R Destination.
+     * @param P The affine point.
+     */
+    void fromAffine(Jacobian& R, const Affine& P) const {
+        if (P.infinity) {
+            setInfinity(R);
+            return;
+        }
+        R.X = P.x;
+        R.Y = P.y;
+        R.Z = F_.one();
+    }
+
+    /**
+     * @brief Convert back to affine coordinates; costs one field inversion.
+     * @param R Destination.
+     * @param P The Jacobian point.
+     */
+    void toAffine(Affine& R, const Jacobian& P) const {
+        if (P.isInfinity()) {
+            R.x = F_.zero();
+            R.y = F_.zero();
+            R.infinity = true;
+            return;
+        }
+        Element zInv, zInv2;
+        F_.inv(zInv, P.Z);
+        F_.sqr(zInv2, zInv);
+        F_.mul(R.x, P.X, zInv2);
+        F_.mul(zInv2, zInv2, zInv);
+        F_.mul(R.y, P.Y, zInv2);
+        R.infinity = false;
+    }
+
+    /**
+     * @brief Convert many points back to affine with a single shared field inversion.
+     *
+     * Uses Montgomery's simultaneous inversion trick: the Z-coordinates are
+     * multiplied into running prefix products, the total is inverted once and
+     * the individual inverses are peeled off walking backwards.
+     *
+     * @param out Destination array of n affine points.
+     * @param in Source array of n Jacobian points; points at infinity are allowed.
+     * @param n Number of points.
+     */
+    void toAffineBatch(Affine* out, const Jacobian* in, size_t n) const {
+        std::vector<Element> prefix(n);
+        Element acc = F_.one();
+        for (size_t i = 0; i < n; ++i) {
+            prefix[i] = acc;
+            if (!in[i].isInfinity()) F_.mul(acc, acc, in[i].Z);
+        }
+        F_.inv(acc, acc);
+        for (size_t i = n; i-- > 0;) {
+            if (in[i].isInfinity()) {
+                out[i].x = F_.zero();
+                out[i].y = F_.zero();
+                out[i].infinity = true;
+                continue;
+            }
+            Element zInv, zInv2;
+            F_.mul(zInv, acc, prefix[i]);
+            F_.mul(acc, acc, in[i].Z);
+            F_.sqr(zInv2, zInv);
+            F_.mul(out[i].x, in[i].X, zInv2);
+            F_.mul(zInv2, zInv2, zInv);
+            F_.mul(out[i].y, in[i].Y, zInv2);
+            out[i].infinity = false;
+        }
+    }
+
+    /**
+     * @brief Adds n independent pairs of affine points with a single shared field inversion.
+     *
+     * Each sum needs the slope lambda = num / den, with den = x2 - x1 for an
+     * addition and 2y for a doubling. All denominators are inverted together
+     * with the prefix-product trick: 1 inversion and 3(n - 1) multiplications
+     * instead of n inversions. Sums involving the point at infinity or giving
+     * it need no slope.
+     *
+     * @param out Destination array of n points; may alias P or Q.
+     * @param P First summands.
+     * @param Q Second summands.
+     * @param n Number of pairs.
+     */
+    void batchAdd(Affine* out, const Affine* P, const Affine* Q, size_t n) const {
+        enum Kind { SLOPE, COPY_P, COPY_Q, INFINITY_SUM };
+        std::vector<unsigned char> kind(n);
+        std::vector<Element> num(n), den(n), prefix(n);
+        Element acc = F_.one();
+        for (size_t i = 0; i < n; ++i) {
+            if (P[i].infinity) { kind[i] = COPY_Q; continue; }
+            if (Q[i].infinity) { kind[i] = COPY_P; continue; }
+            if (P[i].x == Q[i].x) {
+                if (P[i].y != Q[i].y || P[i].y.isZero()) { kind[i] = INFINITY_SUM; continue; }
+                // tangent slope (3x^2 + a) / 2y
+                Element t;
+                F_.sqr(t, P[i].x);
+                F_.add(num[i], t, t);
+                F_.add(num[i], num[i], t);
+                F_.add(num[i], num[i], a_);
+                F_.add(den[i], P[i].y, P[i].y);
+            } else {
+                F_.sub(num[i], Q[i].y, P[i].y);
+                F_.sub(den[i], Q[i].x, P[i].x);
+            }
+            kind[i] = SLOPE;
+            prefix[i] = acc;
+            F_.mul(acc, acc, den[i]);
+        }
+        F_.inv(acc, acc);
+
+        for (size_t i = n; i-- > 0;) {
+            switch (kind[i]) {
+                case COPY_P: out[i] = P[i]; continue;
+                case COPY_Q: out[i] = Q[i]; continue;
+                case INFINITY_SUM:
+                    out[i].x = F_.zero();
+                    out[i].y = F_.zero();
+                    out[i].infinity = true;
+                    continue;
+            }
+            Element lambda, x3, y3;
+            F_.mul(lambda, acc, prefix[i]);
+            F_.mul(acc, acc, den[i]);
+            F_.mul(lambda, lambda, num[i]);
+
+            F_.sqr(x3, lambda);
+            F_.sub(x3, x3, P[i].x);
+            F_.sub(x3, x3, Q[i].x);
+            F_.sub(y3, P[i].x, x3);
+            F_.mul(y3, y3, lambda);
+            F_.sub(out[i].y, y3, P[i].y);
+            out[i].x = x3;
+            out[i].infinity = false;
+        }
+    }
+
+    /**
+     * @brief Affine point negation R = -P.
+     * @param R Destination; may alias P.
+     * @param P The point to negate.
+     */
+    void neg(Affine& R, const Affine& P) const {
+        R.x = P.x;
+        F_.neg(R.y, P.y);
+        R.infinity = P.infinity;
+    }
+
+    /**
+     * @brief Point negation R = -P.
+     * @param R Destination; may alias P.
+     * @param P The point to negate.
+     */
+    void neg(Jacobian& R, const Jacobian& P) const {
+        R.X = P.X;
+        F_.neg(R.Y, P.Y);
+        R.Z = P.Z;
+    }
+
+    /**
+     * @brief Point doubling R = 2P.
+     * @param R Destination; may alias P.
+     * @param P The point to double.
+     */
+    void dbl(Jacobian& R, const Jacobian& P) const {
+        if (P.isInfinity()) {
+            R = P;
+            return;
+        }
+        INSTRUMENT_COUNT(PointDouble);
+        Element t0, t1, t2, t3, m, s;
+        if (aKind == A_MINUS_3) {
+            // dbl-2001-b: alpha = 3 (X - Z^2)(X + Z^2)
+            F_.sqr(t0, P.Z);          // delta
+            F_.sqr(t1, P.Y);          // gamma
+            F_.mul(s, P.X, t1);       // beta
+            F_.sub(t2, P.X, t0);
+            F_.add(t3, P.X, t0);
+            F_.mul(m, t2, t3);
+            F_.add(t2, m, m);
+            F_.add(m, t2, m);         // alpha
+            F_.add(t2, P.Y, P.Z);
+            F_.sqr(t2, t2);
+            F_.sub(t2, t2, t1);
+            F_.sub(R.Z, t2, t0);      // Z3 = (Y + Z)^2 - gamma - delta
+            F_.add(s, s, s);
+            F_.add(s, s, s);          // 4 beta
+            F_.sqr(t2, m);
+            F_.sub(t2, t2, s);
+            F_.sub(R.X, t2, s);       // X3 = alpha^2 - 8 beta
+            F_.sub(s, s, R.X);
+            F_.mul(s, m, s);
+            F_.sqr(t1, t1);
+            F_.add(t1, t1, t1);
+            F_.add(t1, t1, t1);
+            F_.add(t1, t1, t1);       // 8 gamma^2
+            F_.sub(R.Y, s, t1);
+            return;
+        }
+
+        // dbl-2009-l (a = 0) and dbl-2007-bl (generic a)
+        F_.sqr(t0, P.X);              // XX
+        F_.sqr(t1, P.Y);              // YY
+        F_.sqr(t2, t1);               // YYYY
+        F_.add(s, P.X, t1);
+        F_.sqr(s, s);
+        F_.sub(s, s, t0);
+        F_.sub(s, s, t2);
+        F_.add(s, s, s);              // S = 2((X + YY)^2 - XX - YYYY)
+        F_.add(m, t0, t0);
+        F_.add(m, m, t0);             // 3 XX
+        if (aKind == A_GENERIC) {
+            F_.sqr(t3, P.Z);
+            F_.sqr(t3, t3);
+            F_.mul(t3, t3, a_);
+            F_.add(m, m, t3);         // M = 3 XX + a Z^4
+        }
+        Element z3;
+        F_.mul(z3, P.Y, P.Z);
+        F_.add(z3, z3, z3);           // Z3 = 2 Y Z
+        F_.sqr(t3, m);
+        F_.sub(t3, t3, s);
+        F_.sub(t3, t3, s);            // X3 = M^2 - 2S
+        F_.sub(s, s, t3);
+        F_.mul(s, m, s);
+        F_.add(t2, t2, t2);
+        F_.add(t2, t2, t2);
+        F_.add(t2, t2, t2);           // 8 YYYY
+        F_.sub(R.Y, s, t2);
+        R.X = t3;
+        R.Z = z3;
+    }
+
+    /**
+     * @brief Point addition R = P + Q in Jacobian coordinates.
+     * @param R Destination; may alias P or Q.
+     * @param P First point.
+     * @param Q Second point.
+     */
+    void add(Jacobian& R, const Jacobian& P, const Jacobian& Q) const {
+        if (P.isInfinity()) { R = Q; return; }
+        if (Q.isInfinity()) { R = P; return; }
+        INSTRUMENT_COUNT(PointAdd);
+
+        // add-2007-bl
+        Element z1z1, z2z2, u1, u2, s1, s2, h, i, j, r, v;
+        F_.sqr(z1z1, P.Z);
+        F_.sqr(z2z2, Q.Z);
+        F_.mul(u1, P.X, z2z2);
+        F_.mul(u2, Q.X, z1z1);
+        F_.mul(s1, P.Y, Q.Z);
+        F_.mul(s1, s1, z2z2);
+        F_.mul(s2, Q.Y, P.Z);
+        F_.mul(s2, s2, z1z1);
+        F_.sub(h, u2, u1);
+        F_.sub(r, s2, s1);
+        if (h.isZero()) {
+            if (r.isZero()) {
+                dbl(R, P);
+            } else {
+                setInfinity(R);
+            }
+            return;
+        }
+        F_.add(r, r, r);
+        F_.add(i, h, h);
+        F_.sqr(i, i);
+        F_.mul(j, h, i);
+        F_.mul(v, u1, i);
+
+        Element z3;
+        F_.add(z3, P.Z, Q.Z);
+        F_.sqr(z3, z3);
+        F_.sub(z3, z3, z1z1);
+        F_.sub(z3, z3, z2z2);
+        F_.mul(R.Z, z3, h);
+        F_.sqr(z3, r);
+        F_.sub(z3, z3, j);
+        F_.sub(z3, z3, v);
+        F_.sub(z3, z3, v);            // X3 = r^2 - J - 2V
+        F_.sub(v, v, z3);
+        F_.mul(v, r, v);
+        F_.mul(s1, s1, j);
+        F_.add(s1, s1, s1);
+        F_.sub(R.Y, v, s1);
+        R.X = z3;
+    }
+
+    /**
+     * @brief Mixed addition R = P + Q with Q in affine coordinates.
+     * @param R Destination; may alias P.
+     * @param P The Jacobian point.
+     * @param Q The affine point.
+     */
+    void madd(Jacobian& R, const Jacobian& P, const Affine& Q) const {
+        if (Q.infinity) { R = P; return; }
+        if (P.isInfinity()) { fromAffine(R, Q); return; }
+        INSTRUMENT_COUNT(PointAdd);
+
+        // madd-2007-bl
+        Element z1z1, u2, s2, h, hh, i, j, r, v;
+        F_.sqr(z1z1, P.Z);
+        F_.mul(u2, Q.x, z1z1);
+        F_.mul(s2, Q.y, P.Z);
+        F_.mul(s2, s2, z1z1);
+        F_.sub(h, u2, P.X);
+        F_.sub(r, s2, P.Y);
+        if (h.isZero()) {
+            if (r.isZero()) {
+                dbl(R, P);
+            } else {
+                setInfinity(R);
+            }
+            return;
+        }
+        F_.add(r, r, r);
+        F_.sqr(hh, h);
+        F_.add(i, hh, hh);
+        F_.add(i, i, i);
+        F_.mul(j, h, i);
+        F_.mul(v, P.X, i);
+
+        Element x3, yj;
+        F_.sqr(x3, r);
+        F_.sub(x3, x3, j);
+        F_.sub(x3, x3, v);
+        F_.sub(x3, x3, v);            // X3 = r^2 - J - 2V
+        F_.mul(yj, P.Y, j);
+        F_.add(yj, yj, yj);
+        F_.add(i, P.Z, h);
+        F_.sqr(i, i);
+        F_.sub(i, i, z1z1);
+        F_.sub(R.Z, i, hh);           // Z3 = (Z1 + H)^2 - Z1Z1 - HH
+        F_.sub(v, v, x3);
+        F_.mul(v, r, v);
+        F_.sub(R.Y, v, yj);
+        R.X = x3;
+    }
+
+private:
+    enum AKind { A_GENERIC, A_ZERO, A_MINUS_3 };
+
+    const F& F_;   ///< The base field.
+    Element a_;    ///< Curve coefficient a.
+    AKind aKind;   ///< Which doubling formula applies.
+};
+
+#endif // JACOBIAN_HPP
@@ -0,0 +1,151 @@
+/**
+ * @file limbs.hpp
+ * @brief Dense, aligned storage for arrays of fixed-width multi-limb integers.
+ *
+ * A LimbBuffer holds a single cache-line aligned block of GMP limbs; arrays of
+ * equally sized integers are laid out in it back to back, one integer after
+ * the other, so element-wise kernels stream through memory without touching
+ * the allocator. LimbView and ConstLimbView are the non-owning accessors.
+ */
+
+#ifndef LIMBS_HPP
+#define LIMBS_HPP
+
+#include <gmp.h>
+#include <cstddef>
+
+/**
+ * @brief Alignment of LimbBuffer storage in bytes, one cache line.
+ */
+const size_t LIMB_ALIGNMENT = 64;
+
+/**
+ * @class LimbBuffer
+ * @brief An owning, zero-initialized, LIMB_ALIGNMENT aligned array of limbs.
+ */
+class LimbBuffer {
+public:
+    /**
+     * @brief Constructs an empty buffer.
+     */
+    LimbBuffer() : raw(nullptr), ptr(nullptr), n(0) {}
+
+    /**
+     * @brief Constructs a buffer of zero limbs.
+     * @param limbs Number of limbs.
+     */
+    explicit LimbBuffer(size_t limbs);
+
+    /**
+     * @brief Copy constructor.
+     * @param other The buffer to copy.
+     */
+    LimbBuffer(const LimbBuffer& other);
+
+    /**
+     * @brief Move constructor; leaves other empty.
+     * @param other The buffer to take over.
+     */
+    LimbBuffer(LimbBuffer&& other) noexcept;
+
+    /**
+     * @brief Assignment operator.
+     * @param other The buffer to copy.
+     * @return Reference to this buffer.
+     */
+    LimbBuffer& operator=(const LimbBuffer& other);
+
+    /**
+     * @brief Move assignment operator; leaves other empty.
+     * @param other The buffer to take over.
+     * @return Reference to this buffer.
+     */
+    LimbBuffer& operator=(LimbBuffer&& other) noexcept;
+
+    /**
+     * @brief Destructor.
+     */
+    ~LimbBuffer();
+
+    /**
+     * @brief Get the number of limbs.
+     * @return The size of the buffer in limbs.
+     */
+    size_t size() const { return n; }
+
+    /**
+     * @brief Get the first limb.
+     * @return Pointer to the aligned storage, or nullptr if the buffer is empty.
+     */
+    mp_limb_t* data() { return ptr; }
+
+    /**
+     * @brief Get the first limb.
+     * @return Pointer to the aligned storage, or nullptr if the buffer is empty.
+     */
+    const mp_limb_t* data() const { return ptr; }
+
+    /**
+     * @brief Exchanges the contents of two buffers without copying.
+     * @param other The buffer to swap with.
+     */
+    void swap(LimbBuffer& other) noexcept;
+
+private:
+    void* raw;      ///< Start of the allocation.
+    mp_limb_t* ptr; ///< First aligned limb inside the allocation.
+    size_t n;       ///< Number of limbs.
+};
+
+/**
+ * @class BasicLimbView
+ * @brief Non-owning view of count integers of width limbs each, stored back to back.
+ *
+ * @tparam Limb mp_limb_t for a mutable view, const mp_limb_t for a read-only one.
+ */
+template <class Limb>
+class BasicLimbView {
+public:
+    /**
+     * @brief Constructs a view.
+     * @param data First limb of the first integer.
+     * @param count Number of integers.
+     * @param width Limbs per integer.
+     */
+    BasicLimbView(Limb* data, size_t count, size_t width) : base(data), count_(count), width_(width) {}
+
+    /**
+     * @brief Get the number of integers.
+     * @return The number of integers in the view.
+     */
+    size_t size() const { return count_; }
+
+    /**
+     * @brief Get the width of every integer.
+     * @return The number of limbs per integer.
+     */
+    size_t width() const { return width_; }
+
+    /**
+     * @brief Get the first limb.
+     * @return Pointer to the start of the contiguous storage.
+     */
+    Limb* data() const { return base; }
+
+    /**
+     * @brief Access one integer.
+     * @param i Index of the integer.
+     * @return Pointer to its width limbs, least significant first.
+     */
+    Limb* operator[](size_t i) const { return base + i * width_; }
+
+private:
+    Limb* base;
+    size_t count_;
+    size_t width_;
+};
+
+typedef BasicLimbView<mp_limb_t> LimbView;            ///< Mutable view of an integer array.
+typedef BasicLimbView<const mp_limb_t> ConstLimbView; ///< Read-only view of an integer array.
+
+#endif // LIMBS_HPP
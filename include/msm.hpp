@@ -0,0 +1,187 @@
+/**
+ * @file msm.hpp
+ * @brief Multi-scalar multiplication with Pippenger's bucket method.
+ *
+ * Computes sum_i k_i * P_i for many points at once. Each scalar is split into
+ * signed c-bit digits; for every window the points are dropped into 2^(c-1)
+ * buckets by digit with mixed additions, and the buckets are combined with a
+ * running sum. The windows are finally merged with c doublings each. The cost
+ * is about (bits / c) * (n + 2^c) additions instead of n full scalar
+ * multiplications.
+ *
+ * The work is split into (window, point range) tasks on a ThreadPool. Every
+ * task owns its bucket array, so accumulation needs no locks; the partial
+ * window sums are added together at the end.
+ */
+
+#ifndef MSM_HPP
+#define MSM_HPP
+
+#include "jacobian.hpp"
+#include "thread_pool.hpp"
+#include <gmp.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/**
+ * @brief Largest supported MSM window width; digits must fit an int16_t.
+ */
+const unsigned MSM_MAX_WINDOW = 15;
+
+/**
+ * @brief Picks the Pippenger window width for a batch size.
+ *
+ * Uses c = ln(n) + 2, which balances the n bucket insertions per window
+ * against the 2^c additions of the running sum.
+ *
+ * @param n Number of points.
+ * @return The window width, between 2 and MSM_MAX_WINDOW.
+ */
+unsigned msmWindowBits(size_t n);
+
+/**
+ * @brief Recodes a batch of scalars into signed c-bit digits.
+ *
+ * Digits are in [-2^(c-1), 2^(c-1)] and stored window-major: the digit of
+ * scalar i in window j is digits[j * count + i]. One extra window absorbs
+ * the final carry.
+ *
+ * @param scalars count scalars of limbs limbs each, least significant limb first.
+ * @param count Number of scalars.
+ * @param limbs Limbs per scalar.
+ * @param bits Upper bound on the scalar size in bits.
+ * @param c Window width, from 2 to MSM_MAX_WINDOW.
+ * @return The digits.
+ * @throw std::invalid_argument If the window width is out of range.
+ */
+std::vector<int16_t> msmSignedDigits(const mp_limb_t* scalars, size_t count, size_t limbs, size_t bits, unsigned c);
+
+/**
+ * @brief Number of windows msmSignedDigits() produces.
+ * @param bits Upper bound on the scalar size in bits.
+ * @param c Window width.
+ * @return The number of windows, including the carry window.
+ */
+inline size_t msmWindowCount(size_t bits, unsigned c) { return (bits + c - 1) / c + 1; }
+
+/**
+ * @brief Bucket accumulation and running-sum reduction of a single window.
+ *
+ * @param curve The curve arithmetic.
+ * @param out Destination, sum_i digits[i] * points[i].
+ * @param points The affine points.
+ * @param digits The signed digit of every point in this window.
+ * @param count Number of points.
+ * @param c Window width.
+ */
+template <class F>
+void msmWindow(const JacobianCurve<F>& curve, JacobianPoint<F>& out, const AffinePoint<F>* points,
+               const int16_t* digits, size_t count, unsigned c) {
+    const size_t bucketCount = static_cast<size_t>(1) << (c - 1);
+    std::vector<JacobianPoint<F> > buckets(bucketCount);
+    for (size_t b = 0; b < bucketCount; ++b) curve.setInfinity(buckets[b]);
+
+    AffinePoint<F> negated;
+    for (size_t i = 0; i < count; ++i) {
+        const int d = digits[i];
+        if (d > 0) {
+            curve.madd(buckets[d - 1], buckets[d - 1], points[i]);
+        } else if (d < 0) {
+            curve.neg(negated, points[i]);
+            curve.madd(buckets[-d - 1], buckets[-d - 1], negated);
+        }
+    }
+
+    // sum_b (b + 1) * bucket[b] as a running sum from the top bucket down
+    JacobianPoint<F> running;
+    curve.setInfinity(running);
+    curve.setInfinity(out);
+    for (size_t b = bucketCount; b-- > 0;) {
+        curve.add(running, running, buckets[b]);
+        curve.add(out, out, running);
+    }
+}
+
+/**
+ * @brief Combines per-window sums W_j into sum_j 2^(cj) W_j with Horner's rule.
+ * @param curve The curve arithmetic.
+ * @param R Destination.
+ * @param windows The window sums, lowest window first.
+ * @param c Window width.
+ */
+template <class F>
+void msmCombineWindows(const JacobianCurve<F>& curve, JacobianPoint<F>& R,
+                       const std::vector<JacobianPoint<F> >& windows, unsigned c) {
+    curve.setInfinity(R);
+    for (size_t j = windows.size(); j-- > 0;) {
+        for (unsigned i = 0; i < c; ++i) curve.dbl(R, R);
+        curve.add(R, R, windows[j]);
+    }
+}
+
+/**
+ * @brief Number of point ranges each window is split into for a thread pool.
+ *
+ * Produces about two tasks per thread overall, but keeps at least 2^c points
+ * per range since every range pays for its own 2^(c-1) bucket reduction.
+ *
+ * @param count Number of points.
+ * @param windows Number of windows.
+ * @param c Window width.
+ * @param threads Number of threads.
+ * @return The number of ranges, at least 1.
+ */
+size_t msmChunkCount(size_t count, size_t windows, unsigned c, unsigned threads);
+
+/**
+ * @brief Multi-scalar multiplication R = sum_i k_i * P_i with Pippenger's method.
+ *
+ * @param curve The curve arithmetic.
+ * @param R Destination, in Jacobian coordinates.
+ * @param points count affine points.
+ * @param scalars count scalars of limbs limbs each, least significant limb first.
+ * @param count Number of points and scalars.
+ * @param limbs Limbs per scalar.
+ * @param bits Upper bound on the scalar size in bits.
+ * @param c Window width, or 0 to pick it from count with msmWindowBits().
+ * @param pool Pool to spread the windows and point ranges over, or nullptr to run serially.
+ * @throw std::invalid_argument If the window width is out of range.
+ */
+template <class F>
+void pippengerMsm(const JacobianCurve<F>& curve, JacobianPoint<F>& R, const AffinePoint<F>* points,
+                  const mp_limb_t* scalars, size_t count, size_t limbs, size_t bits, unsigned c = 0,
+                  ThreadPool* pool = nullptr) {
+    if (c == 0) c = msmWindowBits(count);
+    const std::vector<int16_t> digits = msmSignedDigits(scalars, count, limbs, bits, c);
+    const size_t windowCount = msmWindowCount(bits, c);
+    const size_t chunks = pool ? msmChunkCount(count, windowCount, c, pool->size()) : 1;
+    const size_t chunkSize = (count + chunks - 1) / chunks;
+
+    std::vector<JacobianPoint<F> > partial(windowCount * chunks);
+    std::function<void(size_t)> task = [&](size_t t) {
+        const size_t j = t / chunks;
+        const size_t begin = (t % chunks) * chunkSize;
+        const size_t end = begin + chunkSize < count ? begin + chunkSize : count;
+        if (begin >= end) {
+            curve.setInfinity(partial[t]);
+            return;
+        }
+        msmWindow(curve, partial[t], points + begin, &digits[j * count + begin], end - begin, c);
+    };
+    if (pool) {
+        pool->parallelFor(partial.size(), task);
+    } else {
+        for (size_t t = 0; t < partial.size(); ++t) task(t);
+    }
+
+    std::vector<JacobianPoint<F> > windows(windowCount);
+    for (size_t j = 0; j < windowCount; ++j) {
+        windows[j] = partial[j * chunks];
+        for (size_t k = 1; k < chunks; ++k) curve.add(windows[j], windows[j], partial[j * chunks + k]);
+    }
+    msmCombineWindows(curve, R, windows, c);
+}
+
+#endif // MSM_HPP
@@ -0,0 +1,293 @@
+/**
+ * @file ntt.hpp
+ * @brief Number theoretic transforms over NTT-friendly prime fields.
+ *
+ * A prime p is NTT-friendly for a power-of-two size n when n divides p - 1,
+ * so that the field contains a primitive n-th root of unity. Polynomial
+ * products of size up to n then cost three transforms of O(n log n) plus n
+ * pointwise multiplications.
+ */
+
+#ifndef NTT_HPP
+#define NTT_HPP
+
+#include "bigint.hpp"
+#include "thread_pool.hpp"
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @brief Smallest transform size that NttDomain splits into cache-sized rows and columns.
+ */
+const size_t NTT_BLOCKED_MIN_SIZE = 1 << 12;
+
+/**
+ * @brief Working-set budget of one column group of a blocked transform, in bytes.
+ */
+const size_t NTT_CACHE_BYTES = 1 << 18;
+
+/**
+ * @brief Check if a modulus admits an NTT of a given size.
+ * @param p The prime modulus.
+ * @param size The transform size.
+ * @return True if p is an odd prime, size is a power of two and size divides p - 1.
+ */
+bool nttFriendly(const BigInt& p, size_t size);
+
+/**
+ * @brief Reverses the lowest bits of an index.
+ * @param x The index.
+ * @param bits Number of bits to reverse.
+ * @return x with its lowest bits bits in reverse order.
+ */
+inline size_t bitReverse(size_t x, unsigned bits) {
+    size_t r = 0;
+    for (unsigned i = 0; i < bits; ++i, x >>= 1) r = (r << 1) | (x & 1);
+    return r;
+}
+
+/**
+ * @class NttDomain
+ * @brief Precomputed roots of unity of one power-of-two transform size.
+ *
+ * The twiddle factors are stored contiguously in bit-reversed order:
+ * twiddles[i] = w^bitrev(i) for i < n / 2. With this layout every stage of the
+ * transform reads a prefix of the same table, and forward() maps natural order
+ * to bit-reversed order while inverse() maps it back, so a convolution needs
+ * no explicit permutation at all.
+ *
+ * @tparam F The field type, e.g. MontgomeryField<N>.
+ */
+template <class F>
+class NttDomain {
+public:
+    typedef typename F::Element Element; ///< Field element type.
+
+    /**
+     * @brief Precomputes the twiddle factors of a given size.
+     * @param field The prime field; it must outlive the domain.
+     * @param size The transform size, a power of two dividing p - 1.
+     * @throw std::invalid_argument If the field has no root of unity of that order.
+     */
+    NttDomain(const F& field, size_t size) : F_(field), n(size), logN(0) {
+        if (!nttFriendly(field.getMod(), size)) {
+            throw std::invalid_argument("Modulus has no root of unity of the requested order.");
+        }
+        while ((static_cast<size_t>(1) << logN) < n) ++logN;
+
+        // A quadratic non-residue g gives a primitive n-th root w = g^((p - 1) / n).
+        const BigInt pMinus1 = field.getMod() - BigInt(static_cast<unsigned long int>(1));
+        const BigInt half = pMinus1.rightShift(1);
+        const Element minusOne = negated(field.one());
+        Element g;
+        for (unsigned long int candidate = 2;; ++candidate) {
+            g = field.fromBigInt(BigInt(candidate));
+            if (power(g, half) == minusOne) break;
+        }
+        BigInt cofactor(static_cast<unsigned long int>(n));
+        omega = power(g, pMinus1 / cofactor);
+        field.inv(sizeInv, field.fromBigInt(cofactor));
+
+        twiddles.resize(n / 2);
+        invTwiddles.resize(n / 2);
+        std::vector<Element> powers(n / 2);
+        Element acc = field.one();
+        for (size_t i = 0; i < n / 2; ++i) {
+            powers[i] = acc;
+            field.mul(acc, acc, omega);
+        }
+        const unsigned bits = logN > 0 ? logN - 1 : 0;
+        for (size_t i = 0; i < n / 2; ++i) {
+            const size_t e = bitReverse(i, bits);
+            twiddles[i] = powers[e];
+            // w^-e = w^(n - e), and w^(n/2) = -1
+            invTwiddles[i] = e == 0 ? field.one() : negated(powers[n / 2 - e]);
+        }
+    }
+
+    /**
+     * @brief Get the transform size.
+     * @return The number of points n.
+     */
+    size_t size() const { return n; }
+
+    /**
+     * @brief Get the field the domain is defined over.
+     * @return The field.
+     */
+    const F& field() const { return F_; }
+
+    /**
+     * @brief Get the primitive n-th root of unity w.
+     * @return The generator of the evaluation domain.
+     */
+    const Element& root() const { return omega; }
+
+    /**
+     * @brief In-place forward transform, a[bitrev(k)] = sum_i a[i] w^(ik).
+     *
+     * Cooley-Tukey butterflies; the input is in natural order and the output
+     * in bit-reversed order. From NTT_BLOCKED_MIN_SIZE points on, the
+     * transform is split four-step style into sqrt(n) rows: the first half of
+     * the stages runs on groups of adjacent columns sized to stay in cache,
+     * after which the remaining stages work on independent contiguous blocks.
+     * Both steps are spread over the pool if one is given. The result is the
+     * same in every case.
+     *
+     * @param a Array of size() elements.
+     * @param pool Pool to run the column groups and blocks on, or nullptr to run serially.
+     */
+    void forward(Element* a, ThreadPool* pool = nullptr) const {
+        if (n < NTT_BLOCKED_MIN_SIZE) {
+            forwardBlock(a, 1, 0);
+            return;
+        }
+        const size_t rows = static_cast<size_t>(1) << (logN / 2);
+        const size_t group = columnGroup(rows);
+        runTasks(pool, n / rows / group, [&](size_t g) { forwardColumns(a, rows, g * group, (g + 1) * group); });
+        runTasks(pool, rows, [&](size_t r) { forwardBlock(a, rows, r); });
+    }
+
+    /**
+     * @brief In-place inverse transform, undoing forward() including the 1/n factor.
+     *
+     * Gentleman-Sande butterflies; the input is in bit-reversed order and the
+     * output in natural order. Large transforms are blocked like in forward(),
+     * with the two steps in reverse order.
+     *
+     * @param a Array of size() elements.
+     * @param pool Pool to run the blocks and column groups on, or nullptr to run serially.
+     */
+    void inverse(Element* a, ThreadPool* pool = nullptr) const {
+        if (n < NTT_BLOCKED_MIN_SIZE) {
+            inverseBlock(a, 1, 0);
+            for (size_t i = 0; i < n; ++i) F_.mul(a[i], a[i], sizeInv);
+            return;
+        }
+        const size_t rows = static_cast<size_t>(1) << (logN / 2);
+        const size_t group = columnGroup(rows);
+        runTasks(pool, rows, [&](size_t r) { inverseBlock(a, rows, r); });
+        runTasks(pool, n / rows / group, [&](size_t g) {
+            inverseColumns(a, rows, g * group, (g + 1) * group);
+            // scale the columns just finished while they are still in cache
+            const size_t columns = n / rows;
+            for (size_t r = 0; r < rows; ++r) {
+                for (size_t j = g * group; j < (g + 1) * group; ++j) {
+                    F_.mul(a[r * columns + j], a[r * columns + j], sizeInv);
+                }
+            }
+        });
+    }
+
+private:
+    Element negated(const Element& x) const {
+        Element r;
+        F_.neg(r, x);
+        return r;
+    }
+
+    // Adjacent columns processed together so that rows * group elements fit in cache.
+    size_t columnGroup(size_t rows) const {
+        size_t group = NTT_CACHE_BYTES / (rows * sizeof(Element));
+        const size_t columns = n / rows;
+        size_t g = 1;
+        while (g * 2 <= group && g * 2 <= columns) g *= 2;
+        return g;
+    }
+
+    static void runTasks(ThreadPool* pool, size_t count, const std::function<void(size_t)>& task) {
+        if (pool) {
+            pool->parallelFor(count, task);
+        } else {
+            for (size_t i = 0; i < count; ++i) task(i);
+        }
+    }
+
+    void butterfly(Element& lo, Element& hi, const Element& w) const {
+        Element v;
+        F_.mul(v, hi, w);
+        F_.sub(hi, lo, v);
+        F_.add(lo, lo, v);
+    }
+
+    void inverseButterfly(Element& lo, Element& hi, const Element& w) const {
+        Element v;
+        F_.sub(v, lo, hi);
+        F_.add(lo, lo, hi);
+        F_.mul(hi, v, w);
+    }
+
+    // The stages with fewer than rows blocks, restricted to columns [j0, j1) of
+    // the rows x (n / rows) matrix: butterfly partners are a multiple of n / rows apart.
+    void forwardColumns(Element* a, size_t rows, size_t j0, size_t j1) const {
+        const size_t columns = n / rows;
+        for (size_t blocks = 1, len = n / 2; blocks < rows; blocks <<= 1, len >>= 1) {
+            for (size_t b = 0; b < blocks; ++b) {
+                const Element& w = twiddles[b];
+                Element* base = a + 2 * len * b;
+                for (size_t off = 0; off < len; off += columns) {
+                    for (size_t j = j0; j < j1; ++j) butterfly(base[off + j], base[off + j + len], w);
+                }
+            }
+        }
+    }
+
+    // The stages with at least rows blocks inside row r, which holds the contiguous
+    // elements [r * n / rows, (r + 1) * n / rows); global block indices select the twiddles.
+    void forwardBlock(Element* a, size_t rows, size_t r) const {
+        const size_t columns = n / rows;
+        Element* row = a + r * columns;
+        for (size_t local = 1, len = columns / 2; len >= 1; local <<= 1, len >>= 1) {
+            for (size_t b = 0; b < local; ++b) {
+                const Element& w = twiddles[r * local + b];
+                Element* lo = row + 2 * len * b;
+                for (size_t j = 0; j < len; ++j) butterfly(lo[j], lo[j + len], w);
+            }
+        }
+    }
+
+    void inverseBlock(Element* a, size_t rows, size_t r) const {
+        const size_t columns = n / rows;
+        Element* row = a + r * columns;
+        for (size_t local = columns / 2, len = 1; local >= 1; local >>= 1, len <<= 1) {
+            for (size_t b = 0; b < local; ++b) {
+                const Element& w = invTwiddles[r * local + b];
+                Element* lo = row + 2 * len * b;
+                for (size_t j = 0; j < len; ++j) inverseButterfly(lo[j], lo[j + len], w);
+            }
+        }
+    }
+
+    void inverseColumns(Element* a, size_t rows, size_t j0, size_t j1) const {
+        const size_t columns = n / rows;
+        for (size_t blocks = rows / 2, len = columns; blocks >= 1; blocks >>= 1, len <<= 1) {
+            for (size_t b = 0; b < blocks; ++b) {
+                const Element& w = invTwiddles[b];
+                Element* base = a + 2 * len * b;
+                for (size_t off = 0; off < len; off += columns) {
+                    for (size_t j = j0; j < j1; ++j) inverseButterfly(base[off + j], base[off + j + len], w);
+                }
+            }
+        }
+    }
+
+    Element power(const Element& x, const BigInt& e) const {
+        std::vector<mp_limb_t> limbs((e.bitSize() + 63) / 64 + 1);
+        e.toLimbs(limbs.data(), limbs.size());
+        Element r;
+        F_.pow(r, x, limbs.data(), limbs.size());
+        return r;
+    }
+
+    const F& F_;   ///< The field.
+    size_t n;      ///< Transform size.
+    unsigned logN; ///< log2 of the transform size.
+    Element omega;   ///< Primitive n-th root of unity.
+    Element sizeInv; ///< n^-1, applied by inverse().
+    std::vector<Element> twiddles;    ///< w^bitrev(i), i < n / 2.
+    std::vector<Element> invTwiddles; ///< w^-bitrev(i), i < n / 2.
+};
+
+#endif // NTT_HPP
@@ -0,0 +1,639 @@
+/**
+ * @file pairing.hpp
+ * @brief Optimal ate pairings on BN254 and BLS12-381 for SNARK verification.
+ *
+ * G1 is the curve y^2 = x^3 + b over Fp, G2 its sextic twist over Fp2 and GT
+ * the order-r subgroup of Fp12*; all three use the fixed-width field types,
+ * with JacobianCurve serving both G1 and G2. The pairing is the optimal ate
+ * pairing: a Miller loop over the curve parameter (6x + 2 for BN, x for BLS12)
+ * with lines computed in homogeneous projective coordinates on the twist,
+ * multiplied into the accumulator as sparse Fp12 elements, and a final
+ * exponentiation whose hard part is a short chain of exponentiations by x
+ * with cyclotomic squarings.
+ *
+ * A verifier checks products of pairings, e.g. e(A, B) = e(alpha, beta)
+ * e(L, gamma) e(C, delta) for Groth16. multiPairing() runs all the Miller loops
+ * with one shared accumulator, so every squaring of the loop is done once
+ * for all pairs, and pays for a single final exponentiation.
+ */
+
+#ifndef PAIRING_HPP
+#define PAIRING_HPP
+
+#include "bigint.hpp"
+#include "field.hpp"
+#include "jacobian.hpp"
+#include "scalarmul.hpp"
+#include "thread_pool.hpp"
+#include "tower.hpp"
+#include <gmp.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct BN254 {};     ///< Tag type of the Barreto-Naehrig curve BN254 (alt_bn128).
+struct BLS12_381 {}; ///< Tag type of BLS12-381.
+
+/**
+ * @struct PairingParameters
+ * @brief Description of a pairing-friendly curve; numbers are strings in base 10 or 0x-prefixed hex.
+ */
+struct PairingParameters {
+    const char* modulus;  ///< The base field prime p.
+    const char* order;    ///< The prime group order r.
+    uint64_t x;           ///< |x|, the curve parameter.
+    bool xNegative;       ///< True if the parameter is -x.
+    bool bn;              ///< True for a BN curve, false for BLS12.
+    bool mTwist;          ///< True for an M-type twist y^2 = x^3 + b xi, false for D-type y^2 = x^3 + b / xi.
+    unsigned long xiReal; ///< k of the non-residue xi = k + u.
+    unsigned long b;      ///< The coefficient b of G1.
+    const char* g1[2];    ///< Generator of G1, x and y.
+    const char* g2[4];    ///< Generator of G2, x = x0 + x1 u and y = y0 + y1 u as x0, x1, y0, y1.
+};
+
+/**
+ * @struct LineCoefficients
+ * @brief The three Fp2 coefficients of a Miller loop line before evaluation at a G1 point.
+ * @tparam F The base field type.
+ */
+template <class F>
+struct LineCoefficients {
+    Fp2Element<F> c0; ///< First coefficient.
+    Fp2Element<F> c1; ///< Second coefficient; scaled by the x of the G1 point.
+    Fp2Element<F> c2; ///< Third coefficient.
+};
+
+/**
+ * @struct G2Prepared
+ * @brief A G2 point with the lines of its Miller loop precomputed.
+ *
+ * The lines only depend on the G2 point, so a verifying key prepares its fixed
+ * G2 elements once and every later pairing skips all G2 arithmetic.
+ *
+ * @tparam F The base field type.
+ */
+template <class F>
+struct G2Prepared {
+    std::vector<LineCoefficients<F> > lines; ///< Doubling and addition lines in loop order.
+    bool infinity;                           ///< True for the point at infinity, whose pairings are 1.
+};
+
+/**
+ * @class PairingEngine
+ * @brief The groups, the tower and the pairing of one pairing-friendly curve.
+ * @tparam F The base field type, a MontgomeryField of the curve's width.
+ */
+template <class F>
+class PairingEngine {
+public:
+    typedef typename F::Element Fp;                ///< Base field element type.
+    typedef Fp2Element<F> Fp2;                     ///< Fp2 element type.
+    typedef AffinePoint<F> G1;                     ///< Affine G1 point.
+    typedef AffinePoint<Fp2Field<F> > G2;          ///< Affine G2 point on the twist.
+    typedef Fp12Element<F> GT;                     ///< Target group element.
+    typedef G2Prepared<F> Prepared;                ///< G2 point with precomputed lines.
+
+    /**
+     * @brief Builds the fields, the curve arithmetic and the loop of a curve.
+     * @param params The curve description.
+     */
+    explicit PairingEngine(const PairingParameters& params)
+        : p(params.modulus, 0), F_(p), E_(F_, params.xiReal), S_(E_), T_(S_), g1Arith(F_, F_.zero()),
+          g2Arith(E_, E_.zero()), r(params.order, 0), x(params.x), xNegative(params.xNegative), bn(params.bn),
+          mTwist(params.mTwist) {
+        b1 = F_.fromBigInt(BigInt(params.b));
+        Fp2 b = E_.zero();
+        b.c0 = b1;
+        Fp2 xi = E_.nonResidue();
+        if (!mTwist) E_.inv(xi, xi);
+        E_.mul(b2, b, xi);
+        F_.inv(twoInv, F_.fromBigInt(BigInt(2UL)));
+
+        g1Gen.x = F_.fromBigInt(BigInt(params.g1[0], 0));
+        g1Gen.y = F_.fromBigInt(BigInt(params.g1[1], 0));
+        g1Gen.infinity = false;
+        g2Gen.x = E_.fromBigInt(BigInt(params.g2[0], 0), BigInt(params.g2[1], 0));
+        g2Gen.y = E_.fromBigInt(BigInt(params.g2[2], 0), BigInt(params.g2[3], 0));
+        g2Gen.infinity = false;
+
+        // loop digits, most significant first: the NAF of 6x + 2 for BN, the bits of x for BLS12
+        const BigInt loopCount = bn ? BigInt(static_cast<unsigned long>(x)) * BigInt(6UL) + BigInt(2UL)
+                                    : BigInt(static_cast<unsigned long>(x));
+        std::vector<mp_limb_t> limbs((loopCount.bitSize() + 63) / 64);
+        loopCount.toLimbs(limbs.data(), limbs.size());
+        const std::vector<int> naf = bn ? wnafRecode(limbs.data(), limbs.size(), WNAF_MIN_WIDTH) : std::vector<int>();
+        for (size_t i = loopCount.bitSize() + 1; i-- > 0;) {
+            const int d = bn ? (i < naf.size() ? naf[i] : 0) : (loopCount.testBit(i) ? 1 : 0);
+            if (!loop.empty() || d != 0) loop.push_back(d);
+        }
+
+        // pi(x, y) on the twist: (conj(x) xi^((p - 1) / 3), conj(y) xi^((p - 1) / 2))
+        E_.pow(frobeniusX, E_.nonResidue(), (p - BigInt(1UL)) / BigInt(3UL));
+        E_.pow(frobeniusY, E_.nonResidue(), (p - BigInt(1UL)) / BigInt(2UL));
+    }
+
+    PairingEngine(const PairingEngine&) = delete;
+    PairingEngine& operator=(const PairingEngine&) = delete;
+
+    /**
+     * @brief Get the base field.
+     * @return Fp.
+     */
+    const F& field() const { return F_; }
+
+    /**
+     * @brief Get the quadratic extension, the field of G2.
+     * @return Fp2.
+     */
+    const Fp2Field<F>& fp2() const { return E_; }
+
+    /**
+     * @brief Get the degree 12 extension, the field of GT.
+     * @return Fp12.
+     */
+    const Fp12Field<F>& fp12() const { return T_; }
+
+    /**
+     * @brief Get the point arithmetic of G1.
+     * @return The curve y^2 = x^3 + b over Fp.
+     */
+    const JacobianCurve<F>& g1() const { return g1Arith; }
+
+    /**
+     * @brief Get the point arithmetic of G2.
+     * @return The twist over Fp2.
+     */
+    const JacobianCurve<Fp2Field<F> >& g2() const { return g2Arith; }
+
+    /**
+     * @brief Get the group order.
+     * @return The prime r.
+     */
+    const BigInt& order() const { return r; }
+
+    /**
+     * @brief Get the generator of G1.
+     * @return The standard generator.
+     */
+    const G1& g1Generator() const { return g1Gen; }
+
+    /**
+     * @brief Get the generator of G2.
+     * @return The standard generator.
+     */
+    const G2& g2Generator() const { return g2Gen; }
+
+    /**
+     * @brief Check that a G1 point satisfies y^2 = x^3 + b.
+     * @param P The point; the point at infinity is on the curve.
+     * @return True if the point is on the curve, false otherwise.
+     */
+    bool onCurve(const G1& P) const {
+        if (P.infinity) return true;
+        Fp l, t;
+        F_.sqr(l, P.y);
+        F_.sqr(t, P.x);
+        F_.mul(t, t, P.x);
+        F_.add(t, t, b1);
+        return l == t;
+    }
+
+    /**
+     * @brief Check that a G2 point satisfies the twist equation y^2 = x^3 + b'.
+     * @param Q The point; the point at infinity is on the curve.
+     * @return True if the point is on the twist, false otherwise.
+     */
+    bool onCurve(const G2& Q) const {
+        if (Q.infinity) return true;
+        Fp2 l, t;
+        E_.sqr(l, Q.y);
+        E_.sqr(t, Q.x);
+        E_.mul(t, t, Q.x);
+        E_.add(t, t, b2);
+        return l == t;
+    }
+
+    /**
+     * @brief Check that a G2 point is on the twist and in the order-r subgroup.
+     *
+     * Unlike G1 of these curves, the twist has a large cofactor, so points from
+     * untrusted input must pass this check before they are paired.
+     *
+     * @param Q The point.
+     * @return True if r Q is the point at infinity, false otherwise.
+     */
+    bool inSubgroup(const G2& Q) const {
+        if (!onCurve(Q)) return false;
+        G2 R;
+        mul(R, Q, r);
+        return R.infinity;
+    }
+
+    /**
+     * @brief Scalar multiplication in G1 by width-w NAF.
+     * @param R Destination; may alias P.
+     * @param P The point.
+     * @param k The scalar, non-negative.
+     */
+    void mul(G1& R, const G1& P, const BigInt& k) const { scalarMul(g1Arith, R, P, k); }
+
+    /**
+     * @brief Scalar multiplication in G2 by width-w NAF.
+     * @param R Destination; may alias Q.
+     * @param Q The point.
+     * @param k The scalar, non-negative.
+     */
+    void mul(G2& R, const G2& Q, const BigInt& k) const { scalarMul(g2Arith, R, Q, k); }
+
+    /**
+     * @brief Precomputes the Miller loop lines of a G2 point.
+     * @param Q The point, in G2.
+     * @return The prepared point.
+     */
+    Prepared prepare(const G2& Q) const {
+        Prepared out;
+        out.infinity = Q.infinity;
+        if (Q.infinity) return out;
+        out.lines.reserve(2 * loop.size() + 2);
+
+        Projective R = {Q.x, Q.y, E_.one()};
+        G2 negQ = Q;
+        E_.neg(negQ.y, Q.y);
+        for (size_t i = 1; i < loop.size(); ++i) {
+            out.lines.push_back(doubleStep(R));
+            if (loop[i] == 1) out.lines.push_back(addStep(R, Q));
+            else if (loop[i] == -1) out.lines.push_back(addStep(R, negQ));
+        }
+        if (bn) {
+            // two more lines through pi(Q) and -pi^2(Q) complete the optimal ate loop
+            G2 q1, q2;
+            frobenius(q1, Q);
+            frobenius(q2, q1);
+            E_.neg(q2.y, q2.y);
+            if (xNegative) E_.neg(R.Y, R.Y);
+            out.lines.push_back(addStep(R, q1));
+            out.lines.push_back(addStep(R, q2));
+        }
+        return out;
+    }
+
+    /**
+     * @brief The product of the Miller loops of n pairs, sharing the squarings of one accumulator.
+     * @param f Destination, the value before the final exponentiation.
+     * @param P The G1 points.
+     * @param Q The prepared G2 points.
+     * @param n Number of pairs; pairs with a point at infinity contribute 1.
+     */
+    void millerLoop(GT& f, const G1* P, const Prepared* Q, size_t n) const {
+        std::vector<size_t> active;
+        for (size_t k = 0; k < n; ++k) {
+            if (!P[k].infinity && !Q[k].infinity) active.push_back(k);
+        }
+        f = T_.one();
+        size_t line = 0;
+        for (size_t i = 1; i < loop.size(); ++i) {
+            if (i > 1) T_.sqr(f, f);
+            for (size_t k : active) evaluate(f, Q[k].lines[line], P[k]);
+            ++line;
+            if (loop[i] != 0) {
+                for (size_t k : active) evaluate(f, Q[k].lines[line], P[k]);
+                ++line;
+            }
+        }
+        if (xNegative) T_.conjugate(f, f);
+        if (bn) {
+            for (size_t k : active) evaluate(f, Q[k].lines[line], P[k]);
+            ++line;
+            for (size_t k : active) evaluate(f, Q[k].lines[line], P[k]);
+        }
+    }
+
+    /**
+     * @brief The final exponentiation r = f^((p^12 - 1) / r), up to a fixed power coprime to r.
+     *
+     * The easy part f^((p^6 - 1)(p^2 + 1)) costs one inversion and Frobenius
+     * maps and lands in the cyclotomic subgroup; the hard part is the chain of
+     * Fuentes-Castaneda et al. for BN and of Hayashida-Hayasaka-Teruya for BLS12,
+     * a handful of exponentiations by x with cyclotomic squarings.
+     *
+     * @param out Destination; may alias f.
+     * @param f The output of the Miller loop, non-zero.
+     */
+    void finalExponentiation(GT& out, const GT& f) const {
+        GT t, m;
+        T_.inv(t, f);
+        T_.conjugate(m, f);
+        T_.mul(m, m, t);
+        T_.frobenius(t, m, 2);
+        T_.mul(m, t, m);
+        if (bn) hardPartBn(out, m);
+        else hardPartBls12(out, m);
+    }
+
+    /**
+     * @brief The pairing e(P, Q).
+     * @param out Destination.
+     * @param P The G1 point.
+     * @param Q The G2 point.
+     */
+    void pairing(GT& out, const G1& P, const G2& Q) const {
+        const Prepared prepared = prepare(Q);
+        millerLoop(out, &P, &prepared, 1);
+        finalExponentiation(out, out);
+    }
+
+    /**
+     * @brief The product of n pairings e(P_i, Q_i) with a single final exponentiation.
+     *
+     * With a pool, the pairs are split into one slice per thread; each slice
+     * runs its own shared Miller loop and the slices' results are multiplied
+     * before the final exponentiation.
+     *
+     * @param out Destination.
+     * @param P The G1 points.
+     * @param Q The prepared G2 points.
+     * @param n Number of pairs.
+     * @param pool Thread pool to run the slices on, or nullptr to run serially.
+     */
+    void multiPairing(GT& out, const G1* P, const Prepared* Q, size_t n, ThreadPool* pool = nullptr) const {
+        const size_t slices = pool ? std::min<size_t>(pool->size(), n) : 1;
+        if (slices <= 1) {
+            millerLoop(out, P, Q, n);
+        } else {
+            std::vector<GT> partial(slices);
+            pool->parallelFor(slices, [&](size_t s) {
+                const size_t begin = n * s / slices, end = n * (s + 1) / slices;
+                millerLoop(partial[s], P + begin, Q + begin, end - begin);
+            });
+            out = partial[0];
+            for (size_t s = 1; s < slices; ++s) T_.mul(out, out, partial[s]);
+        }
+        finalExponentiation(out, out);
+    }
+
+    /**
+     * @brief The product of n pairings of unprepared G2 points.
+     * @param out Destination.
+     * @param P The G1 points.
+     * @param Q The G2 points; they are prepared on the fly.
+     * @param n Number of pairs.
+     * @param pool Thread pool for the preparation and the Miller loops, or nullptr to run serially.
+     */
+    void multiPairing(GT& out, const G1* P, const G2* Q, size_t n, ThreadPool* pool = nullptr) const {
+        std::vector<Prepared> prepared(n);
+        if (pool) pool->parallelFor(n, [&](size_t i) { prepared[i] = prepare(Q[i]); });
+        else for (size_t i = 0; i < n; ++i) prepared[i] = prepare(Q[i]);
+        multiPairing(out, P, prepared.data(), n, pool);
+    }
+
+    /**
+     * @brief Checks that the product of n pairings is 1, the form of a SNARK verification equation.
+     * @param P The G1 points, e.g. -A, alpha, L, C for Groth16.
+     * @param Q The prepared G2 points, e.g. B, beta, gamma, delta.
+     * @param n Number of pairs.
+     * @param pool Thread pool for the Miller loops, or nullptr to run serially.
+     * @return True if prod_i e(P_i, Q_i) = 1, false otherwise.
+     */
+    bool pairingProductIsOne(const G1* P, const Prepared* Q, size_t n, ThreadPool* pool = nullptr) const {
+        GT out;
+        multiPairing(out, P, Q, n, pool);
+        return out == T_.one();
+    }
+
+private:
+    struct Projective {
+        Fp2 X, Y, Z; ///< (X / Z, Y / Z) on the twist.
+    };
+
+    BigInt p;                                 ///< The base field prime.
+    F F_;                                     ///< Fp.
+    Fp2Field<F> E_;                           ///< Fp2.
+    Fp6Field<F> S_;                           ///< Fp6.
+    Fp12Field<F> T_;                          ///< Fp12.
+    JacobianCurve<F> g1Arith;                 ///< G1 arithmetic, a = 0.
+    JacobianCurve<Fp2Field<F> > g2Arith;      ///< G2 arithmetic on the twist, a = 0.
+    BigInt r;                                 ///< The group order.
+    uint64_t x;                               ///< |x|.
+    bool xNegative;                           ///< Sign of the curve parameter.
+    bool bn;                                  ///< BN or BLS12 loop and final exponentiation.
+    bool mTwist;                              ///< Twist type, which fixes the layout of the lines.
+    Fp b1;                                    ///< b of G1.
+    Fp2 b2;                                   ///< b' of the twist.
+    Fp twoInv;                                ///< 1 / 2.
+    G1 g1Gen;                                 ///< Generator of G1.
+    G2 g2Gen;                                 ///< Generator of G2.
+    std::vector<int> loop;                    ///< Miller loop digits, most significant first.
+    Fp2 frobeniusX;                           ///< xi^((p - 1) / 3).
+    Fp2 frobeniusY;                           ///< xi^((p - 1) / 2).
+
+    template <class Field>
+    void scalarMul(const JacobianCurve<Field>& curve, AffinePoint<Field>& R, const AffinePoint<Field>& P,
+                   const BigInt& k) const {
+        std::vector<mp_limb_t> limbs((k.bitSize() + 63) / 64 + 1);
+        k.toLimbs(limbs.data(), limbs.size());
+        JacobianPoint<Field> J;
+        wnafMultiply(curve, J, P, limbs.data(), limbs.size(), WNAF_DEFAULT_WIDTH);
+        curve.toAffine(R, J);
+    }
+
+    // pi on the twist, the Frobenius endomorphism of E carried over by the twisting isomorphism
+    void frobenius(G2& R, const G2& Q) const {
+        E_.conjugate(R.x, Q.x);
+        E_.mul(R.x, R.x, frobeniusX);
+        E_.conjugate(R.y, Q.y);
+        E_.mul(R.y, R.y, frobeniusY);
+        R.infinity = Q.infinity;
+    }
+
+    // R = 2R and the tangent line at R (Costello-Lange-Naehrig, homogeneous coordinates)
+    LineCoefficients<F> doubleStep(Projective& R) const {
+        Fp2 a, b, c, e, f, g, h, i, j, t;
+        E_.mul(a, R.X, R.Y);
+        E_.mulByBase(a, a, twoInv);
+        E_.sqr(b, R.Y);
+        E_.sqr(c, R.Z);
+        E_.add(t, c, c);
+        E_.add(t, t, c);
+        E_.mul(e, t, b2);
+        E_.add(f, e, e);
+        E_.add(f, f, e);
+        E_.add(g, b, f);
+        E_.mulByBase(g, g, twoInv);
+        E_.add(h, R.Y, R.Z);
+        E_.sqr(h, h);
+        E_.sub(h, h, b);
+        E_.sub(h, h, c);
+        E_.sub(i, e, b);
+        E_.sqr(j, R.X);
+
+        E_.sub(t, b, f);
+        E_.mul(R.X, a, t);
+        E_.sqr(t, e);
+        E_.sqr(R.Y, g);
+        E_.sub(R.Y, R.Y, t);
+        E_.sub(R.Y, R.Y, t);
+        E_.sub(R.Y, R.Y, t);
+        E_.mul(R.Z, b, h);
+
+        LineCoefficients<F> line;
+        E_.add(line.c1, j, j);
+        E_.add(line.c1, line.c1, j);
+        E_.neg(h, h);
+        line.c0 = mTwist ? i : h;
+        line.c2 = mTwist ? h : i;
+        return line;
+    }
+
+    // R = R + Q and the line through them
+    LineCoefficients<F> addStep(Projective& R, const G2& Q) const {
+        Fp2 theta, lambda, c, d, e, f, g, h, t;
+        E_.mul(t, Q.y, R.Z);
+        E_.sub(theta, R.Y, t);
+        E_.mul(t, Q.x, R.Z);
+        E_.sub(lambda, R.X, t);
+        E_.sqr(c, theta);
+        E_.sqr(d, lambda);
+        E_.mul(e, lambda, d);
+        E_.mul(f, R.Z, c);
+        E_.mul(g, R.X, d);
+        E_.add(h, e, f);
+        E_.sub(h, h, g);
+        E_.sub(h, h, g);
+
+        E_.mul(R.X, lambda, h);
+        E_.sub(t, g, h);
+        E_.mul(t, theta, t);
+        E_.mul(R.Y, e, R.Y);
+        E_.sub(R.Y, t, R.Y);
+        E_.mul(R.Z, R.Z, e);
+
+        LineCoefficients<F> line;
+        Fp2 j;
+        E_.mul(j, theta, Q.x);
+        E_.mul(t, lambda, Q.y);
+        E_.sub(j, j, t);
+        E_.neg(line.c1, theta);
+        line.c0 = mTwist ? j : lambda;
+        line.c2 = mTwist ? lambda : j;
+        return line;
+    }
+
+    // f = f * line(P)
+    void evaluate(GT& f, const LineCoefficients<F>& line, const G1& P) const {
+        Fp2 c0 = line.c0, c1, c2 = line.c2;
+        E_.mulByBase(c1, line.c1, P.x);
+        if (mTwist) {
+            E_.mulByBase(c2, c2, P.y);
+            T_.mulBy014(f, f, c0, c1, c2);
+        } else {
+            E_.mulByBase(c0, c0, P.y);
+            T_.mulBy034(f, f, c0, c1, c2);
+        }
+    }
+
+    // a^x for the signed curve parameter, a in the cyclotomic subgroup
+    void expByX(GT& out, const GT& a) const {
+        T_.cyclotomicPow(out, a, x);
+        if (xNegative) T_.conjugate(out, out);
+    }
+
+    void hardPartBn(GT& out, const GT& m) const {
+        GT y0, y1, y2, y3, y4, y5, y6, y7, y8, y9, y10, y11, y12, y13, y14, y15, mc;
+        expByX(y0, m);
+        T_.conjugate(y0, y0);
+        T_.cyclotomicSqr(y1, y0);
+        T_.cyclotomicSqr(y2, y1);
+        T_.mul(y3, y2, y1);
+        expByX(y4, y3);
+        T_.conjugate(y4, y4);
+        T_.cyclotomicSqr(y5, y4);
+        expByX(y6, y5);
+        T_.conjugate(y6, y6);
+        T_.conjugate(y3, y3);
+        T_.conjugate(y6, y6);
+        T_.mul(y7, y6, y4);
+        T_.mul(y8, y7, y3);
+        T_.mul(y9, y8, y1);
+        T_.mul(y10, y8, y4);
+        T_.mul(y11, y10, m);
+        T_.frobenius(y12, y9, 1);
+        T_.mul(y13, y12, y11);
+        T_.frobenius(y8, y8, 2);
+        T_.mul(y14, y8, y13);
+        T_.conjugate(mc, m);
+        T_.mul(y15, mc, y9);
+        T_.frobenius(y15, y15, 3);
+        T_.mul(out, y15, y14);
+    }
+
+    void hardPartBls12(GT& out, const GT& m) const {
+        GT y0, y1, y2, y3, y4, y5;
+        T_.cyclotomicSqr(y0, m);
+        T_.conjugate(y0, y0);
+        expByX(y5, m);
+        T_.cyclotomicSqr(y1, y5);
+        T_.mul(y3, y0, y5);
+        expByX(y0, y3);
+        expByX(y2, y0);
+        expByX(y4, y2);
+        T_.mul(y4, y4, y1);
+        expByX(y1, y4);
+        T_.conjugate(y3, y3);
+        T_.mul(y1, y1, y3);
+        T_.mul(y1, y1, m);
+        T_.conjugate(y3, m);
+        T_.mul(y0, y0, m);
+        T_.frobenius(y0, y0, 3);
+        T_.mul(y4, y4, y3);
+        T_.frobenius(y4, y4, 1);
+        T_.mul(y5, y5, y2);
+        T_.frobenius(y5, y5, 2);
+        T_.mul(y5, y5, y0);
+        T_.mul(y5, y5, y4);
+        T_.mul(out, y5, y1);
+    }
+};
+
+/**
+ * @struct PairingCurve
+ * @brief Compile-time access to the shared PairingEngine of a curve.
+ *
+ * Every specialization provides LIMBS, the Field type and engine(), the
+ * lazily built singleton holding the curve's fields, groups and loop.
+ *
+ * @tparam Tag BN254 or BLS12_381.
+ */
+template <class Tag>
+struct PairingCurve;
+
+/**
+ * @brief BN254: p and r of 254 bits, x = 4965661367192848881, D-type twist over xi = 9 + u.
+ */
+template <>
+struct PairingCurve<BN254> {
+    static const size_t LIMBS = 4;      ///< Limbs per base field element.
+    typedef MontgomeryField<LIMBS> Field; ///< Base field type.
+
+    /**
+     * @brief Get the shared engine.
+     * @return The groups and pairing of BN254.
+     */
+    static const PairingEngine<Field>& engine();
+};
+
+/**
+ * @brief BLS12-381: p of 381 bits, r of 255 bits, x = -0xd201000000010000, M-type twist over xi = 1 + u.
+ */
+template <>
+struct PairingCurve<BLS12_381> {
+    static const size_t LIMBS = 6;      ///< Limbs per base field element.
+    typedef MontgomeryField<LIMBS> Field; ///< Base field type.
+
+    /**
+     * @brief Get the shared engine.
+     * @return The groups and pairing of BLS12-381.
+     */
+    static const PairingEngine<Field>& engine();
+};
+
+#endif // PAIRING_HPP
@@ -0,0 +1,131 @@
+/**
+ * @file pointtable.hpp
+ * @brief Memory-mapped files of curve points, such as structured reference strings.
+ *
+ * A point table file is a 64-byte header followed by the points stored as
+ * AffinePoint<Curve<Tag>::Field> structs, i.e. exactly the layout the curve
+ * arithmetic works on. Opening a table maps the file read-only and hands out
+ * pointers into the mapping: nothing is parsed or copied, pages are only read
+ * when an MSM first touches them, and several processes share one copy in
+ * the page cache. The file is tied to the byte order and struct layout of
+ * the machine that wrote it; the header records enough to reject a mismatch.
+ */
+
+#ifndef POINTTABLE_HPP
+#define POINTTABLE_HPP
+
+#include "bigint.hpp"
+#include "curves.hpp"
+#include "ecc.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * @struct PointTableHeader
+ * @brief The header at the start of a point table file.
+ */
+struct PointTableHeader {
+    char magic[8];              ///< "ECPTABLE".
+    uint32_t version;           ///< Format version, currently 1.
+    uint32_t curve;             ///< The CurveId of the points.
+    uint64_t count;             ///< Number of points.
+    uint64_t pointSize;         ///< sizeof(AffinePoint<Field>) on the writing machine.
+    unsigned char reserved[32]; ///< Zero; pads the header so the points are 64-byte aligned.
+};
+
+static_assert(sizeof(PointTableHeader) == 64, "PointTableHeader must be 64 bytes.");
+
+/**
+ * @class PointTable
+ * @brief A read-only, memory-mapped array of points on one curve.
+ */
+class PointTable {
+public:
+    /**
+     * @brief Writes points to a point table file.
+     * @param path The file to create or overwrite.
+     * @param points The points, all on the same curve; points at infinity are allowed.
+     * @param id The curve, used when points is empty (default is P-256).
+     * @throw std::invalid_argument If the points belong to different curves.
+     * @throw std::runtime_error If the file cannot be written.
+     */
+    static void write(const std::string& path, const std::vector<Ecc_Point>& points, CurveId id = CurveId::P256);
+
+    /**
+     * @brief Maps a point table file.
+     * @param path The file to open.
+     * @throw std::runtime_error If the file cannot be opened or mapped, or its header does not
+     *        match a supported curve and the layout of this build.
+     */
+    explicit PointTable(const std::string& path);
+
+    /**
+     * @brief Unmaps the file.
+     */
+    ~PointTable();
+
+    PointTable(const PointTable&) = delete;
+    PointTable& operator=(const PointTable&) = delete;
+
+    /**
+     * @brief Get the curve of the points.
+     * @return The curve identifier from the header.
+     */
+    CurveId curve() const { return curveId; }
+
+    /**
+     * @brief Get the number of points.
+     * @return The point count from the header.
+     */
+    size_t size() const { return count; }
+
+    /**
+     * @brief Copies one point out of the table.
+     * @param i The index of the point, below size().
+     * @return The point as an Ecc_Point.
+     * @throw std::out_of_range If the index is out of range.
+     */
+    Ecc_Point point(size_t i) const;
+
+    /**
+     * @brief Get the points in place, in the representation of the curve arithmetic.
+     * @tparam C The curve trait, Curve<Tag>.
+     * @return Pointer to size() points inside the mapping, valid as long as the table.
+     * @throw std::invalid_argument If the table holds points of another curve.
+     */
+    template <class C>
+    const AffinePoint<typename C::Field>* points() const {
+        if (C::ID != curveId) {
+            throw std::invalid_argument("Point table belongs to a different curve.");
+        }
+        return reinterpret_cast<const AffinePoint<typename C::Field>*>(base + sizeof(PointTableHeader));
+    }
+
+private:
+    void unmap();
+
+    const unsigned char* base; ///< Start of the mapping, the header.
+    size_t length;             ///< Length of the mapping in bytes.
+    CurveId curveId;           ///< Curve of the points.
+    size_t count;              ///< Number of points.
+};
+
+/**
+ * @brief Multi-scalar multiplication over the first points of a table.
+ *
+ * The Pippenger buckets read the points straight from the mapping, so an
+ * MSM over a structured reference string needs no copy or conversion of
+ * the points. Scalars are reduced modulo the group order n.
+ *
+ * @param table The points.
+ * @param scalars One scalar for each of the first scalars.size() points.
+ * @param threads Number of threads, 1 to run serially, or 0 to use the shared pool.
+ * @return sum_i scalars[i] * table.point(i).
+ * @throw std::invalid_argument If there are more scalars than points.
+ */
+Ecc_Point multiScalarMul(const PointTable& table, const std::vector<BigInt>& scalars, unsigned threads = 0);
+
+#endif // POINTTABLE_HPP
@@ -9,14 +9,27 @@
 #define POLYNOMIAL_HPP
 
 #include "bigint.hpp"
+#include "limbs.hpp"
+#include <cstddef>
 #include <vector>
 #include <string>
 
+/**
+ * @brief Default coefficients per task of the threaded coefficient-wise operations.
+ *
+ * A few microseconds of vector arithmetic; polynomials of at most this many
+ * coefficients are processed serially.
+ */
+const size_t POLYNOMIAL_GRAIN = 1 << 12;
+
 /**
  * @class Polynomial
- * @brief A class representing a polynomial with BigInt coefficients.
+ * @brief A class representing a polynomial with coefficients in Z/modZ.
  * 
- * This class allows operations on polynomials over finite fields using BigInt.
+ * This class allows operations on polynomials over finite fields. The
+ * coefficients are kept reduced to [0, mod) in one dense, aligned LimbBuffer
+ * of size() * width() limbs, where width() is the limb count of the modulus,
+ * lowest degree first.
  */
 class Polynomial {
 public:
@@ -28,6 +41,24 @@ public:
      */
     Polynomial(const std::vector<std::string>& coeff_array, const std::string& modulusStr);
 
+    /**
+     * @brief Constructs a Polynomial object from BigInt coefficients.
+     *
+     * @param coeff_array The coefficients, lowest degree first; they are reduced modulo the modulus.
+     * @param modulus The modulus of the finite field.
+     * @throw std::invalid_argument If the modulus is not positive.
+     */
+    Polynomial(const std::vector<BigInt>& coeff_array, const BigInt& modulus);
+
+    /**
+     * @brief Constructs a polynomial with a given number of zero coefficients.
+     *
+     * @param size Number of coefficients.
+     * @param modulus The modulus of the finite field.
+     * @throw std::invalid_argument If the modulus is not positive.
+     */
+    Polynomial(size_t size, const BigInt& modulus);
+
     /**
      * @brief Prints the polynomial in a readable format.
      */
@@ -41,18 +72,78 @@ public:
     int deg() const;
 
     /**
-     * @brief Gets the coefficients of the polynomial.
+     * @brief Returns the number of coefficients.
+     * 
+     * @return deg() + 1.
+     */
+    size_t size() const { return count; }
+
+    /**
+     * @brief Returns the number of limbs every coefficient occupies.
      * 
-     * @return Vector of BigInt representing the coefficients.
+     * @return The limb count of the modulus.
      */
-    std::vector<BigInt> getCoefficients() const;
+    size_t width() const { return limbsPerCoefficient; }
+
+    /**
+     * @brief Gets a read-only view of the coefficients without copying them.
+     * 
+     * @return View of size() canonical coefficients of width() limbs each.
+     */
+    ConstLimbView coefficients() const { return ConstLimbView(limbs.data(), count, limbsPerCoefficient); }
+
+    /**
+     * @brief Gets a mutable view of the coefficients.
+     * 
+     * Values written through the view must stay below the modulus.
+     *
+     * @return View of size() coefficients of width() limbs each.
+     */
+    LimbView coefficients() { return LimbView(limbs.data(), count, limbsPerCoefficient); }
+
+    /**
+     * @brief Gets one coefficient as a BigInt.
+     * 
+     * @param i The degree of the coefficient.
+     * @return The coefficient in [0, mod).
+     */
+    BigInt coefficient(size_t i) const;
+
+    /**
+     * @brief Sets one coefficient.
+     * 
+     * @param i The degree of the coefficient, below size().
+     * @param value The new value; it is reduced modulo the modulus.
+     */
+    void setCoefficient(size_t i, const BigInt& value);
 
     /**
      * @brief Gets the modulus of the finite field.
      * 
      * @return Modulus as BigInt.
      */
-    BigInt getMod() const;
+    const BigInt& getMod() const;
+
+    /**
+     * @brief Evaluates the polynomial at one point with Horner's rule.
+     * 
+     * @param x The point; it is reduced modulo the modulus.
+     * @return The value in [0, mod).
+     */
+    BigInt evaluate(const BigInt& x) const;
+
+    /**
+     * @brief Evaluates the polynomial at several points.
+     * 
+     * Horner's rule runs on small blocks of points at once, so the
+     * multiplications of different points overlap instead of waiting on each
+     * other. For many points multipointEvaluate() of interpolation.hpp is
+     * asymptotically faster.
+     *
+     * @param xs The points; they are reduced modulo the modulus.
+     * @return The values, in the order of the points.
+     */
+    std::vector<BigInt> evaluate(const std::vector<BigInt>& xs) const;
 
     /**
      * @brief Adds two polynomials and stores the result in a third polynomial.
@@ -64,6 +155,19 @@ public:
      */
     friend void addPolynomials(Polynomial &result, const Polynomial &a, const Polynomial &b);
 
+    /**
+     * @brief Adds two polynomials on several threads, in chunks of grain coefficients.
+     *
+     * @param result Reference to Polynomial where the result will be stored.
+     * @param a The first polynomial to add.
+     * @param b The second polynomial to add.
+     * @param threads Number of threads, 1 to run serially, or 0 to use the shared pool.
+     * @param grain Coefficients per task; shorter polynomials are added serially.
+     * @throw std::invalid_argument If the moduli of the polynomials are not the same.
+     */
+    friend void addPolynomials(Polynomial &result, const Polynomial &a, const Polynomial &b, unsigned threads,
+                               size_t grain);
+
     /**
      * @brief Subtracts the second polynomial from the first and stores the result in a third polynomial.
      * 
@@ -74,8 +178,27 @@ public:
      */
     friend void subtractPolynomials(Polynomial &result, const Polynomial &a, const Polynomial &b);
 
+    /**
+     * @brief Subtracts two polynomials on several threads, in chunks of grain coefficients.
+     *
+     * @param result Reference to Polynomial where the result will be stored.
+     * @param a The polynomial to subtract from.
+     * @param b The polynomial to subtract.
+     * @param threads Number of threads, 1 to run serially, or 0 to use the shared pool.
+     * @param grain Coefficients per task; shorter polynomials are subtracted serially.
+     * @throw std::invalid_argument If the moduli of the polynomials are not the same.
+     */
+    friend void subtractPolynomials(Polynomial &result, const Polynomial &a, const Polynomial &b, unsigned threads,
+                                    size_t grain);
+
     /**
      * @brief Multiplies two polynomials and stores the result in a third polynomial.
+     *
+     * Short factors use the schoolbook method. Larger products use an NTT (see
+     * NttDomain) when the modulus is an NTT-friendly prime below 2^512 for the
+     * padded product size, and Kronecker substitution into a single GMP integer
+     * multiplication (Karatsuba, Toom-Cook or FFT) otherwise. The result may
+     * alias either factor.
      * 
      * @param result Reference to Polynomial where the result will be stored.
      * @param a The first polynomial to multiply.
@@ -84,6 +207,21 @@ public:
      */
     friend void multiplyPolynomials(Polynomial &result, const Polynomial &a, const Polynomial &b);
 
+    /**
+     * @brief Multiplies two polynomials on several threads.
+     *
+     * Same as the three-argument version, but the NTT path runs its blocked
+     * transforms, conversions and pointwise products on a thread pool.
+     *
+     * @param result Reference to Polynomial where the result will be stored.
+     * @param a The first polynomial to multiply.
+     * @param b The second polynomial to multiply.
+     * @param threads Number of threads, 1 to run serially, or 0 to use the shared pool
+     *        with one thread per hardware thread.
+     * @throw std::invalid_argument If the moduli of the polynomials are not the same.
+     */
+    friend void multiplyPolynomials(Polynomial &result, const Polynomial &a, const Polynomial &b, unsigned threads);
+
     /**
      * @brief Multiplies a polynomial by a scalar and stores the result in another polynomial.
      * 
@@ -93,6 +231,18 @@ public:
      */
     friend void multiplyPolynomialByScalar(Polynomial &result, const Polynomial &poly, const BigInt &scalar);
 
+    /**
+     * @brief Multiplies a polynomial by a scalar on several threads, in chunks of grain coefficients.
+     *
+     * @param result Reference to Polynomial where the result will be stored.
+     * @param poly The polynomial to multiply.
+     * @param scalar The scalar to multiply the polynomial by.
+     * @param threads Number of threads, 1 to run serially, or 0 to use the shared pool.
+     * @param grain Coefficients per task; shorter polynomials are scaled serially.
+     */
+    friend void multiplyPolynomialByScalar(Polynomial &result, const Polynomial &poly, const BigInt &scalar,
+                                           unsigned threads, size_t grain);
+
     /**
      * @brief Divides a polynomial by a scalar and stores the result in another polynomial.
      * 
@@ -103,10 +253,179 @@ public:
      */
     friend void dividePolynomialByScalar(Polynomial &result, const Polynomial &poly, const BigInt &scalar);
 
+    /**
+     * @brief Divides two polynomials with remainder: a = quotient * b + remainder.
+     *
+     * Short quotients or divisors use long division. Otherwise the quotient is
+     * the reversed dividend times the inverse power series of the reversed
+     * divisor, found by Newton iteration g <- g * (2 - rev(b) * g), so the cost
+     * is a few multiplications of the operand size. Leading zero coefficients
+     * are ignored; the quotient has deg(a) - deg(b) + 1 coefficients (none if
+     * deg(a) < deg(b)) and the remainder always deg(b). Either result may alias
+     * an operand.
+     *
+     * @param quotient Reference to Polynomial where the quotient will be stored.
+     * @param remainder Reference to Polynomial where the remainder will be stored.
+     * @param a The dividend.
+     * @param b The divisor.
+     * @throw std::invalid_argument If the moduli differ or b is the zero polynomial.
+     * @throw std::runtime_error If the leading coefficient of b is not invertible.
+     */
+    friend void dividePolynomials(Polynomial &quotient, Polynomial &remainder, const Polynomial &a, const Polynomial &b);
+
+    /**
+     * @brief Divides two polynomials with remainder, multiplying on several threads.
+     *
+     * @param quotient Reference to Polynomial where the quotient will be stored.
+     * @param remainder Reference to Polynomial where the remainder will be stored.
+     * @param a The dividend.
+     * @param b The divisor.
+     * @param threads Number of threads as for multiplyPolynomials().
+     * @throw std::invalid_argument If the moduli differ or b is the zero polynomial.
+     * @throw std::runtime_error If the leading coefficient of b is not invertible.
+     */
+    friend void dividePolynomials(Polynomial &quotient, Polynomial &remainder, const Polynomial &a, const Polynomial &b,
+                                  unsigned threads);
+
+    /**
+     * @brief Computes the formal derivative of a polynomial.
+     *
+     * @param result Reference to Polynomial where the derivative will be stored; size() - 1 coefficients.
+     * @param poly The polynomial to differentiate.
+     */
+    friend void derivePolynomial(Polynomial &result, const Polynomial &poly);
+
+    /**
+     * @brief Divides a polynomial by X - z with synthetic division: poly = quotient * (X - z) + remainder.
+     *
+     * One Horner pass yields the quotient along with the remainder poly(z),
+     * as needed for KZG opening proofs.
+     *
+     * @param quotient Reference to Polynomial where the quotient will be stored; size() - 1 coefficients.
+     * @param remainder Reference to BigInt where poly(z) will be stored.
+     * @param poly The dividend.
+     * @param z The root of the divisor; it is reduced modulo the modulus.
+     */
+    friend void dividePolynomialByLinear(Polynomial &quotient, BigInt &remainder, const Polynomial &poly, const BigInt &z);
+
+    /**
+     * @brief Divides a polynomial by the vanishing polynomial X^n - 1 of the n-th roots of unity.
+     *
+     * Since X^n = 1 modulo the divisor, the coefficients fold down in blocks of
+     * n with vector additions only.
+     *
+     * @param quotient Reference to Polynomial where the quotient will be stored; size() - n coefficients, none if fewer.
+     * @param remainder Reference to Polynomial where the remainder will be stored; n coefficients.
+     * @param poly The dividend; it may alias either result.
+     * @param n The degree of the divisor.
+     * @throw std::invalid_argument If n is zero.
+     */
+    friend void dividePolynomialByVanishing(Polynomial &quotient, Polynomial &remainder, const Polynomial &poly, size_t n);
+
 
 private:
-    std::vector<BigInt> coefficients; ///< Coefficients of the polynomial.
+    /**
+     * @brief Resets the polynomial to size zero coefficients of a modulus.
+     * 
+     * @param modulus The modulus of the finite field.
+     * @param size Number of coefficients.
+     * @throw std::invalid_argument If the modulus is not positive.
+     */
+    void reset(const BigInt& modulus, size_t size);
+
     BigInt mod; ///< Modulus of the finite field.
+    size_t limbsPerCoefficient; ///< Limb count of the modulus.
+    size_t count; ///< Number of coefficients.
+    LimbBuffer limbs; ///< count * limbsPerCoefficient limbs, coefficient i at i * limbsPerCoefficient.
+};
+
+/**
+ * @brief Evaluates many polynomials at one point, e.g. every committed polynomial at a challenge.
+ *
+ * The polynomials are spread over the pool in blocks of grain; each is
+ * evaluated with Horner's rule. Moduli may differ between polynomials.
+ *
+ * @param polys The polynomials.
+ * @param x The point; it is reduced modulo each modulus.
+ * @param threads Number of threads, 1 to run serially, or 0 to use the shared pool.
+ * @param grain Polynomials per task (default is 1); at most grain polynomials are evaluated serially.
+ * @return polys[i](x) for every i.
+ */
+std::vector<BigInt> batchEvaluate(const std::vector<Polynomial>& polys, const BigInt& x, unsigned threads = 0,
+                                  size_t grain = 1);
+
+/**
+ * @class PolynomialAccumulator
+ * @brief A lazily reduced sum of polynomials and scalar multiples of polynomials.
+ *
+ * Each coefficient of the sum is kept unreduced in 2 * width + 1 limbs: the
+ * double-width products of the scaled terms are added as they are, and the
+ * extra limb takes the carries, room for 2^64 terms. The sum is reduced once
+ * per coefficient when read back, so a chain such as a + s * b - c costs a
+ * multiplication and an addition per term and coefficient instead of a
+ * modular reduction after every operation.
+ */
+class PolynomialAccumulator {
+public:
+    /**
+     * @brief Constructs an empty sum.
+     * 
+     * @param modulus The modulus of the polynomials to add up.
+     * @throw std::invalid_argument If the modulus is not positive.
+     */
+    explicit PolynomialAccumulator(const BigInt& modulus);
+
+    /**
+     * @brief Adds a polynomial.
+     * 
+     * @param poly The polynomial, over the same modulus.
+     * @throw std::invalid_argument If the moduli differ.
+     */
+    void add(const Polynomial& poly);
+
+    /**
+     * @brief Adds a scalar multiple of a polynomial.
+     * 
+     * @param poly The polynomial, over the same modulus.
+     * @param scalar The factor; it is reduced modulo the modulus.
+     * @throw std::invalid_argument If the moduli differ.
+     */
+    void add(const Polynomial& poly, const BigInt& scalar);
+
+    /**
+     * @brief Subtracts a polynomial.
+     * 
+     * @param poly The polynomial, over the same modulus.
+     * @throw std::invalid_argument If the moduli differ.
+     */
+    void subtract(const Polynomial& poly);
+
+    /**
+     * @brief Subtracts a scalar multiple of a polynomial.
+     * 
+     * @param poly The polynomial, over the same modulus.
+     * @param scalar The factor; it is reduced modulo the modulus.
+     * @throw std::invalid_argument If the moduli differ.
+     */
+    void subtract(const Polynomial& poly, const BigInt& scalar);
+
+    /**
+     * @brief Reduces the sum.
+     * 
+     * @return The sum, with as many coefficients as the longest term.
+     */
+    Polynomial result() const;
+
+private:
+    // Checks the modulus of a term and widens the sum to its size.
+    void extend(const Polynomial& poly);
+
+    BigInt mod;
+    size_t width; ///< Limb count of the modulus.
+    size_t slot;  ///< Limbs per unreduced coefficient.
+    size_t count; ///< Number of coefficients.
+    LimbBuffer modLimbs;
+    LimbBuffer sums; ///< count * slot limbs.
 };
 
 #endif // POLYNOMIAL_HPP
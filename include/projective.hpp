@@ -0,0 +1,446 @@
+/**
+ * @file projective.hpp
+ * @brief Complete elliptic curve arithmetic in homogeneous projective coordinates.
+ *
+ * A projective point (X : Y : Z) represents the affine point (X / Z, Y / Z) on
+ * y^2 = x^3 + ax + b, and (0 : 1 : 0) is the point at infinity. The addition
+ * formulas of Renes, Costello and Batina ("Complete addition formulas for
+ * prime order elliptic curves", 2016) are complete on curves of odd order:
+ * the same straight-line sequence of field operations computes P + Q for
+ * every pair of inputs, including P = Q, P = -Q and the point at infinity.
+ * There is no branch at all, which is what the constant-time scalar
+ * multiplications in scalarmul.hpp are built on.
+ */
+
+#ifndef PROJECTIVE_HPP
+#define PROJECTIVE_HPP
+
+#include "field.hpp"
+#include "jacobian.hpp"
+
+/**
+ * @struct ProjectivePoint
+ * @brief A point in homogeneous projective coordinates; Z = 0 encodes the point at infinity.
+ * @tparam F The field type, e.g. MontgomeryField<4>.
+ */
+template <class F>
+struct ProjectivePoint {
+    typename F::Element X; ///< X-coordinate, x = X / Z.
+    typename F::Element Y; ///< Y-coordinate, y = Y / Z.
+    typename F::Element Z; ///< Z-coordinate.
+};
+
+/**
+ * @class ProjectiveCurve
+ * @brief Complete point formulas for a short Weierstrass curve of odd order.
+ *
+ * The formulas are picked once from the value of 'a', like in JacobianCurve:
+ * a = -3 and a = 0 have dedicated variants (Algorithms 4-6 and 7-9 of the
+ * paper), every other curve uses the generic ones (Algorithms 1-3). A full
+ * addition costs 12 multiplications, a mixed one 11 and a doubling 8 with 3
+ * squarings, plus multiplications by the constants a and 3b.
+ *
+ * @tparam F The field type, e.g. MontgomeryField<4>.
+ */
+template <class F>
+class ProjectiveCurve {
+public:
+    typedef typename F::Element Element;  ///< Field element type.
+    typedef AffinePoint<F> Affine;        ///< Affine point type.
+    typedef ProjectivePoint<F> Projective; ///< Projective point type.
+
+    /**
+     * @brief Constructs the curve arithmetic for a field and coefficients a and b.
+     * @param field The base field; it must outlive this object.
+     * @param a The curve coefficient a, in the field's representation.
+     * @param b The curve coefficient b, in the field's representation.
+     */
+    ProjectiveCurve(const F& field, const Element& a, const Element& b) : F_(field), a_(a), b_(b) {
+        F_.add(b3, b, b);
+        F_.add(b3, b3, b);
+        Element minus3;
+        F_.add(minus3, F_.one(), F_.one());
+        F_.add(minus3, minus3, F_.one());
+        F_.neg(minus3, minus3);
+        aKind = a.isZero() ? A_ZERO : (a == minus3 ? A_MINUS_3 : A_GENERIC);
+    }
+
+    /**
+     * @brief Get the base field.
+     * @return The field this curve is defined over.
+     */
+    const F& field() const { return F_; }
+
+    /**
+     * @brief Set R to the point at infinity (0 : 1 : 0).
+     * @param R The point to clear.
+     */
+    void setInfinity(Projective& R) const {
+        R.X = F_.zero();
+        R.Y = F_.one();
+        R.Z = F_.zero();
+    }
+
+    /**
+     * @brief Lift an affine point to projective coordinates with Z = 1.
+     * @param R Destination.
+     * @param P The affine point.
+     */
+    void fromAffine(Projective& R, const Affine& P) const {
+        if (P.infinity) {
+            setInfinity(R);
+            return;
+        }
+        R.X = P.x;
+        R.Y = P.y;
+        R.Z = F_.one();
+    }
+
+    /**
+     * @brief Convert back to affine coordinates; costs one field inversion and no branch.
+     * @param R Destination.
+     * @param P The projective point.
+     */
+    void toAffine(Affine& R, const Projective& P) const {
+        Element zInv;
+        F_.inv(zInv, P.Z);
+        F_.mul(R.x, P.X, zInv);
+        F_.mul(R.y, P.Y, zInv);
+        R.infinity = P.Z.isZero();
+    }
+
+    /**
+     * @brief Copies P into R if flag is 1, with no branch on flag.
+     * @param R Destination.
+     * @param P The point to copy.
+     * @param flag 0 or 1.
+     */
+    static void conditionalMove(Projective& R, const Projective& P, mp_limb_t flag) {
+        ::conditionalMove(R.X, P.X, flag);
+        ::conditionalMove(R.Y, P.Y, flag);
+        ::conditionalMove(R.Z, P.Z, flag);
+    }
+
+    /**
+     * @brief Swaps P and Q if flag is 1, with no branch on flag.
+     * @param P First point.
+     * @param Q Second point.
+     * @param flag 0 or 1.
+     */
+    static void conditionalSwap(Projective& P, Projective& Q, mp_limb_t flag) {
+        ::conditionalSwap(P.X, Q.X, flag);
+        ::conditionalSwap(P.Y, Q.Y, flag);
+        ::conditionalSwap(P.Z, Q.Z, flag);
+    }
+
+    /**
+     * @brief Complete point addition R = P + Q.
+     * @param R Destination; may alias P or Q.
+     * @param P First point.
+     * @param Q Second point.
+     */
+    void add(Projective& R, const Projective& P, const Projective& Q) const {
+        INSTRUMENT_COUNT(PointAdd);
+        Element t0, t1, t2, t3, t4, t5, x3, y3, z3;
+        F_.mul(t0, P.X, Q.X);
+        F_.mul(t1, P.Y, Q.Y);
+        F_.mul(t2, P.Z, Q.Z);
+        F_.add(t3, P.X, P.Y);
+        F_.add(t4, Q.X, Q.Y);
+        F_.mul(t3, t3, t4);
+        F_.add(t4, t0, t1);
+        F_.sub(t3, t3, t4);           // X1 Y2 + X2 Y1
+        if (aKind == A_GENERIC) {
+            // Algorithm 1
+            F_.add(t4, P.X, P.Z);
+            F_.add(t5, Q.X, Q.Z);
+            F_.mul(t4, t4, t5);
+            F_.add(t5, t0, t2);
+            F_.sub(t4, t4, t5);       // X1 Z2 + X2 Z1
+            F_.add(t5, P.Y, P.Z);
+            F_.add(x3, Q.Y, Q.Z);
+            F_.mul(t5, t5, x3);
+            F_.add(x3, t1, t2);
+            F_.sub(t5, t5, x3);       // Y1 Z2 + Y2 Z1
+            F_.mul(z3, a_, t4);
+            F_.mul(x3, b3, t2);
+            F_.add(z3, x3, z3);
+            F_.sub(x3, t1, z3);
+            F_.add(z3, t1, z3);
+            F_.mul(y3, x3, z3);
+            F_.add(t1, t0, t0);
+            F_.add(t1, t1, t0);
+            F_.mul(t2, a_, t2);
+            F_.mul(t4, b3, t4);
+            F_.add(t1, t1, t2);
+            F_.sub(t2, t0, t2);
+            F_.mul(t2, a_, t2);
+            F_.add(t4, t4, t2);
+            finish(R, x3, y3, z3, t0, t1, t3, t4, t5);
+            return;
+        }
+
+        F_.add(t4, P.Y, P.Z);
+        F_.add(x3, Q.Y, Q.Z);
+        F_.mul(t4, t4, x3);
+        F_.add(x3, t1, t2);
+        F_.sub(t4, t4, x3);           // Y1 Z2 + Y2 Z1
+        F_.add(x3, P.X, P.Z);
+        F_.add(y3, Q.X, Q.Z);
+        F_.mul(x3, x3, y3);
+        F_.add(y3, t0, t2);
+        F_.sub(y3, x3, y3);           // X1 Z2 + X2 Z1
+        if (aKind == A_ZERO) {
+            // Algorithm 7
+            F_.add(x3, t0, t0);
+            F_.add(t0, x3, t0);
+            F_.mul(t2, b3, t2);
+            F_.add(z3, t1, t2);
+            F_.sub(t1, t1, t2);
+            F_.mul(y3, b3, y3);
+            finishAZero(R, y3, z3, t0, t1, t3, t4);
+            return;
+        }
+
+        // Algorithm 4
+        F_.mul(z3, b_, t2);
+        F_.sub(x3, y3, z3);
+        F_.add(z3, x3, x3);
+        F_.add(x3, x3, z3);
+        F_.sub(z3, t1, x3);
+        F_.add(x3, t1, x3);
+        F_.mul(y3, b_, y3);
+        F_.add(t1, t2, t2);
+        F_.add(t2, t1, t2);
+        finishAMinus3(R, x3, y3, z3, t0, t1, t2, t3, t4);
+    }
+
+    /**
+     * @brief Complete mixed addition R = P + Q with Q in affine coordinates.
+     * @param R Destination; may alias P.
+     * @param P The projective point, possibly the point at infinity.
+     * @param Q The affine point; it must not be the point at infinity.
+     */
+    void madd(Projective& R, const Projective& P, const Affine& Q) const {
+        INSTRUMENT_COUNT(PointAdd);
+        Element t0, t1, t2, t3, t4, t5, x3, y3, z3;
+        F_.mul(t0, P.X, Q.x);
+        F_.mul(t1, P.Y, Q.y);
+        F_.add(t3, Q.x, Q.y);
+        F_.add(t4, P.X, P.Y);
+        F_.mul(t3, t3, t4);
+        F_.add(t4, t0, t1);
+        F_.sub(t3, t3, t4);           // X1 y2 + x2 Y1
+        if (aKind == A_GENERIC) {
+            // Algorithm 2
+            F_.mul(t4, Q.x, P.Z);
+            F_.add(t4, t4, P.X);      // X1 + x2 Z1
+            F_.mul(t5, Q.y, P.Z);
+            F_.add(t5, t5, P.Y);      // Y1 + y2 Z1
+            F_.mul(z3, a_, t4);
+            F_.mul(x3, b3, P.Z);
+            F_.add(z3, x3, z3);
+            F_.sub(x3, t1, z3);
+            F_.add(z3, t1, z3);
+            F_.mul(y3, x3, z3);
+            F_.add(t1, t0, t0);
+            F_.add(t1, t1, t0);
+            F_.mul(t2, a_, P.Z);
+            F_.mul(t4, b3, t4);
+            F_.add(t1, t1, t2);
+            F_.sub(t2, t0, t2);
+            F_.mul(t2, a_, t2);
+            F_.add(t4, t4, t2);
+            finish(R, x3, y3, z3, t0, t1, t3, t4, t5);
+            return;
+        }
+
+        F_.mul(t4, Q.y, P.Z);
+        F_.add(t4, t4, P.Y);          // Y1 + y2 Z1
+        F_.mul(y3, Q.x, P.Z);
+        F_.add(y3, y3, P.X);          // X1 + x2 Z1
+        if (aKind == A_ZERO) {
+            // Algorithm 8
+            F_.add(x3, t0, t0);
+            F_.add(t0, x3, t0);
+            F_.mul(t2, b3, P.Z);
+            F_.add(z3, t1, t2);
+            F_.sub(t1, t1, t2);
+            F_.mul(y3, b3, y3);
+            finishAZero(R, y3, z3, t0, t1, t3, t4);
+            return;
+        }
+
+        // Algorithm 5
+        F_.mul(z3, b_, P.Z);
+        F_.sub(x3, y3, z3);
+        F_.add(z3, x3, x3);
+        F_.add(x3, x3, z3);
+        F_.sub(z3, t1, x3);
+        F_.add(x3, t1, x3);
+        F_.mul(y3, b_, y3);
+        F_.add(t1, P.Z, P.Z);
+        F_.add(t2, t1, P.Z);
+        finishAMinus3(R, x3, y3, z3, t0, t1, t2, t3, t4);
+    }
+
+    /**
+     * @brief Complete point doubling R = 2P.
+     * @param R Destination; may alias P.
+     * @param P The point to double.
+     */
+    void dbl(Projective& R, const Projective& P) const {
+        INSTRUMENT_COUNT(PointDouble);
+        Element t0, t1, t2, t3, x3, y3, z3;
+        if (aKind == A_ZERO) {
+            // Algorithm 9
+            F_.sqr(t0, P.Y);
+            F_.add(z3, t0, t0);
+            F_.add(z3, z3, z3);
+            F_.add(z3, z3, z3);
+            F_.mul(t1, P.Y, P.Z);
+            F_.sqr(t2, P.Z);
+            F_.mul(t2, b3, t2);
+            F_.mul(x3, t2, z3);
+            F_.add(y3, t0, t2);
+            F_.mul(z3, t1, z3);
+            F_.add(t1, t2, t2);
+            F_.add(t2, t1, t2);
+            F_.sub(t0, t0, t2);
+            F_.mul(y3, t0, y3);
+            F_.add(y3, x3, y3);
+            F_.mul(t1, P.X, P.Y);
+            F_.mul(x3, t0, t1);
+            F_.add(R.X, x3, x3);
+            R.Y = y3;
+            R.Z = z3;
+            return;
+        }
+
+        F_.sqr(t0, P.X);
+        F_.sqr(t1, P.Y);
+        F_.sqr(t2, P.Z);
+        F_.mul(t3, P.X, P.Y);
+        F_.add(t3, t3, t3);
+        F_.mul(z3, P.X, P.Z);
+        F_.add(z3, z3, z3);
+        if (aKind == A_MINUS_3) {
+            // Algorithm 6
+            F_.mul(y3, b_, t2);
+            F_.sub(y3, y3, z3);
+            F_.add(x3, y3, y3);
+            F_.add(y3, x3, y3);
+            F_.sub(x3, t1, y3);
+            F_.add(y3, t1, y3);
+            F_.mul(y3, x3, y3);
+            F_.mul(x3, x3, t3);
+            F_.add(t3, t2, t2);
+            F_.add(t2, t2, t3);
+            F_.mul(z3, b_, z3);
+            F_.sub(z3, z3, t2);
+            F_.sub(z3, z3, t0);
+            F_.add(t3, z3, z3);
+            F_.add(z3, z3, t3);
+            F_.add(t3, t0, t0);
+            F_.add(t0, t3, t0);
+            F_.sub(t0, t0, t2);
+            F_.mul(t0, t0, z3);
+            F_.add(y3, y3, t0);
+            F_.mul(t0, P.Y, P.Z);
+            F_.add(t0, t0, t0);
+            F_.mul(z3, t0, z3);
+            F_.sub(x3, x3, z3);
+            F_.mul(z3, t0, t1);
+        } else {
+            // Algorithm 3
+            F_.mul(x3, a_, z3);
+            F_.mul(y3, b3, t2);
+            F_.add(y3, x3, y3);
+            F_.sub(x3, t1, y3);
+            F_.add(y3, t1, y3);
+            F_.mul(y3, x3, y3);
+            F_.mul(x3, t3, x3);
+            F_.mul(z3, b3, z3);
+            F_.mul(t2, a_, t2);
+            F_.sub(t3, t0, t2);
+            F_.mul(t3, a_, t3);
+            F_.add(t3, t3, z3);
+            F_.add(z3, t0, t0);
+            F_.add(t0, z3, t0);
+            F_.add(t0, t0, t2);
+            F_.mul(t0, t0, t3);
+            F_.add(y3, y3, t0);
+            F_.mul(t2, P.Y, P.Z);
+            F_.add(t2, t2, t2);
+            F_.mul(t0, t2, t3);
+            F_.sub(x3, x3, t0);
+            F_.mul(z3, t2, t1);
+        }
+        F_.add(z3, z3, z3);
+        F_.add(R.Z, z3, z3);
+        R.X = x3;
+        R.Y = y3;
+    }
+
+private:
+    enum AKind { A_GENERIC, A_ZERO, A_MINUS_3 };
+
+    const F& F_;   ///< The base field.
+    Element a_;    ///< Curve coefficient a.
+    Element b_;    ///< Curve coefficient b.
+    Element b3;    ///< 3b.
+    AKind aKind;   ///< Which formulas apply.
+
+    // Last steps of Algorithms 1 and 2.
+    void finish(Projective& R, Element& x3, Element& y3, Element& z3, Element& t0,
+                const Element& t1, const Element& t3, const Element& t4, const Element& t5) const {
+        F_.mul(t0, t1, t4);
+        F_.add(y3, y3, t0);
+        F_.mul(t0, t5, t4);
+        F_.mul(x3, t3, x3);
+        F_.sub(R.X, x3, t0);
+        F_.mul(t0, t3, t1);
+        F_.mul(z3, t5, z3);
+        F_.add(R.Z, z3, t0);
+        R.Y = y3;
+    }
+
+    // Last steps of Algorithms 7 and 8.
+    void finishAZero(Projective& R, Element& y3, Element& z3, Element& t0, Element& t1,
+                     const Element& t3, const Element& t4) const {
+        Element x3, t2;
+        F_.mul(x3, t4, y3);
+        F_.mul(t2, t3, t1);
+        F_.sub(R.X, t2, x3);
+        F_.mul(y3, y3, t0);
+        F_.mul(t1, t1, z3);
+        F_.add(R.Y, t1, y3);
+        F_.mul(t0, t0, t3);
+        F_.mul(z3, z3, t4);
+        F_.add(R.Z, z3, t0);
+    }
+
+    // Last steps of Algorithms 4 and 5.
+    void finishAMinus3(Projective& R, Element& x3, Element& y3, Element& z3, Element& t0, Element& t1,
+                       const Element& t2, const Element& t3, const Element& t4) const {
+        F_.sub(y3, y3, t2);
+        F_.sub(y3, y3, t0);
+        F_.add(t1, y3, y3);
+        F_.add(y3, t1, y3);
+        F_.add(t1, t0, t0);
+        F_.add(t0, t1, t0);
+        F_.sub(t0, t0, t2);
+        Element u;
+        F_.mul(t1, t4, y3);
+        F_.mul(u, t0, y3);
+        F_.mul(y3, x3, z3);
+        F_.add(R.Y, y3, u);
+        F_.mul(x3, t3, x3);
+        F_.sub(R.X, x3, t1);
+        F_.mul(z3, t4, z3);
+        F_.mul(t1, t3, t0);
+        F_.add(R.Z, z3, t1);
+    }
+};
+
+#endif // PROJECTIVE_HPP
@@ -0,0 +1,210 @@
+/**
+ * @file safegcd.hpp
+ * @brief Constant-time modular inversion by Bernstein-Yang divsteps.
+ *
+ * The inverse is found by the "safegcd" iteration of Bernstein and Yang, "Fast
+ * constant-time gcd computation and modular inversion" (2019). Divsteps are run
+ * in batches of 62 on the low 64 bits of the operands only; each batch yields a
+ * 2x2 transition matrix that is then applied to the full-width values. The
+ * number of batches depends only on the size of the modulus, and every step is
+ * written with masks instead of branches, so the running time is independent of
+ * the value being inverted.
+ *
+ * Multi-limb values are held in signed 62-bit limbs (int64_t, all but the top
+ * limb in [0, 2^62)), which leaves room for the matrix products in __int128.
+ */
+
+#ifndef SAFEGCD_HPP
+#define SAFEGCD_HPP
+
+#include <gmp.h>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class SafegcdInverter
+ * @brief Constant-time inversion modulo a fixed odd N-limb modulus.
+ * @tparam N Number of 64-bit limbs of the modulus.
+ */
+template <size_t N>
+class SafegcdInverter {
+public:
+    /**
+     * @brief Precomputes the modulus in signed 62-bit limbs and p^-1 mod 2^62.
+     * @param p The N limbs of the odd modulus, least significant first.
+     */
+    explicit SafegcdInverter(const mp_limb_t* p) {
+        toSigned62(modulus, p);
+        // Newton iteration for p^-1 mod 2^64, each step doubles the correct bits.
+        uint64_t inv = p[0];
+        for (int i = 0; i < 5; ++i) inv *= 2 - p[0] * inv;
+        modulusInv62 = inv & M62;
+
+        // Bernstein-Yang, theorem 11.2: (49d + 57) / 17 divsteps bring g to zero for d-bit inputs, d >= 46.
+        size_t bits = 64 * N;
+        while (bits > 0 && !((p[(bits - 1) / 64] >> ((bits - 1) % 64)) & 1)) --bits;
+        const size_t steps = bits < 46 ? (49 * bits + 80) / 17 : (49 * bits + 57) / 17;
+        batches = (steps + 61) / 62;
+    }
+
+    /**
+     * @brief Computes r = a^-1 mod p in constant time.
+     * @param r Destination of N limbs, in [0, p); may alias a.
+     * @param a The N limbs of the value, below p; the inverse of zero is zero.
+     */
+    void invert(mp_limb_t* r, const mp_limb_t* a) const {
+        int64_t f[L], g[L], d[L] = {0}, e[L] = {0};
+        for (size_t i = 0; i < L; ++i) f[i] = modulus[i];
+        toSigned62(g, a);
+        e[0] = 1;
+
+        // Invariants: d * a = f and e * a = g (mod p), with f odd.
+        int64_t delta = 1;
+        for (unsigned b = 0; b < batches; ++b) {
+            int64_t t[4];
+            delta = divsteps62(delta, static_cast<uint64_t>(f[0]) | (static_cast<uint64_t>(f[1]) << 62),
+                               static_cast<uint64_t>(g[0]) | (static_cast<uint64_t>(g[1]) << 62), t);
+            updateDE(d, e, t);
+            updateFG(f, g, t);
+        }
+
+        // Now f = +-1, so a^-1 = d * f.
+        normalize(d, f[L - 1] >> 63);
+        fromSigned62(r, d);
+    }
+
+private:
+    static const size_t L = (64 * N + 2 + 61) / 62; ///< Signed 62-bit limbs for values in (-2p, p).
+    static const int64_t M62 = (static_cast<int64_t>(1) << 62) - 1;
+
+    int64_t modulus[L];     ///< p in signed 62-bit limbs.
+    uint64_t modulusInv62;  ///< p^-1 mod 2^62.
+    unsigned batches;       ///< Batches of 62 divsteps that suffice for every input.
+
+    // 62 divsteps on the low bits of f and g; t receives the matrix with 2^62 (f', g') = t (f, g).
+    static int64_t divsteps62(int64_t delta, uint64_t f, uint64_t g, int64_t* t) {
+        uint64_t u = 1, v = 0, q = 0, r = 1;
+        for (int i = 0; i < 62; ++i) {
+            // delta > 0 and g odd: (delta, f, g) -> (-delta, g, -f) before the common step
+            const uint64_t swap = static_cast<uint64_t>((-delta) >> 63) & -(g & 1);
+            uint64_t x = (f ^ g) & swap;
+            f ^= x;
+            g ^= x;
+            g = (g ^ swap) - swap;
+            x = (u ^ q) & swap;
+            u ^= x;
+            q ^= x;
+            q = (q ^ swap) - swap;
+            x = (v ^ r) & swap;
+            v ^= x;
+            r ^= x;
+            r = (r ^ swap) - swap;
+            delta = (delta ^ static_cast<int64_t>(swap)) - static_cast<int64_t>(swap);
+
+            // (delta, f, g) -> (1 + delta, f, (g + (g mod 2) f) / 2)
+            const uint64_t odd = -(g & 1);
+            g += f & odd;
+            q += u & odd;
+            r += v & odd;
+            g >>= 1;
+            u <<= 1;
+            v <<= 1;
+            ++delta;
+        }
+        t[0] = static_cast<int64_t>(u);
+        t[1] = static_cast<int64_t>(v);
+        t[2] = static_cast<int64_t>(q);
+        t[3] = static_cast<int64_t>(r);
+        return delta;
+    }
+
+    // (f, g) = t (f, g) / 2^62; the division is exact.
+    static void updateFG(int64_t* f, int64_t* g, const int64_t* t) {
+        const int64_t u = t[0], v = t[1], q = t[2], r = t[3];
+        __int128 cf = static_cast<__int128>(u) * f[0] + static_cast<__int128>(v) * g[0];
+        __int128 cg = static_cast<__int128>(q) * f[0] + static_cast<__int128>(r) * g[0];
+        cf >>= 62;
+        cg >>= 62;
+        for (size_t i = 1; i < L; ++i) {
+            cf += static_cast<__int128>(u) * f[i] + static_cast<__int128>(v) * g[i];
+            cg += static_cast<__int128>(q) * f[i] + static_cast<__int128>(r) * g[i];
+            f[i - 1] = static_cast<int64_t>(cf) & M62;
+            g[i - 1] = static_cast<int64_t>(cg) & M62;
+            cf >>= 62;
+            cg >>= 62;
+        }
+        f[L - 1] = static_cast<int64_t>(cf);
+        g[L - 1] = static_cast<int64_t>(cg);
+    }
+
+    // (d, e) = t (d, e) / 2^62 mod p, adding the multiples of p that make the division
+    // exact; inputs and outputs stay in (-2p, p) because |u| + |v| <= 2^62.
+    void updateDE(int64_t* d, int64_t* e, const int64_t* t) const {
+        const int64_t u = t[0], v = t[1], q = t[2], r = t[3];
+        const int64_t sd = d[L - 1] >> 63, se = e[L - 1] >> 63;
+        int64_t md = (u & sd) + (v & se);
+        int64_t me = (q & sd) + (r & se);
+        __int128 cd = static_cast<__int128>(u) * d[0] + static_cast<__int128>(v) * e[0];
+        __int128 ce = static_cast<__int128>(q) * d[0] + static_cast<__int128>(r) * e[0];
+        md -= static_cast<int64_t>((modulusInv62 * static_cast<uint64_t>(cd) + static_cast<uint64_t>(md)) & M62);
+        me -= static_cast<int64_t>((modulusInv62 * static_cast<uint64_t>(ce) + static_cast<uint64_t>(me)) & M62);
+        cd += static_cast<__int128>(modulus[0]) * md;
+        ce += static_cast<__int128>(modulus[0]) * me;
+        cd >>= 62;
+        ce >>= 62;
+        for (size_t i = 1; i < L; ++i) {
+            cd += static_cast<__int128>(u) * d[i] + static_cast<__int128>(v) * e[i] +
+                  static_cast<__int128>(modulus[i]) * md;
+            ce += static_cast<__int128>(q) * d[i] + static_cast<__int128>(r) * e[i] +
+                  static_cast<__int128>(modulus[i]) * me;
+            d[i - 1] = static_cast<int64_t>(cd) & M62;
+            e[i - 1] = static_cast<int64_t>(ce) & M62;
+            cd >>= 62;
+            ce >>= 62;
+        }
+        d[L - 1] = static_cast<int64_t>(cd);
+        e[L - 1] = static_cast<int64_t>(ce);
+    }
+
+    // Maps d in (-2p, p), negated if sign is all ones, to [0, p).
+    void normalize(int64_t* d, int64_t sign) const {
+        addModulusIfNegative(d);
+        for (size_t i = 0; i < L; ++i) d[i] = (d[i] ^ sign) - sign;
+        carry(d);
+        addModulusIfNegative(d);
+    }
+
+    void addModulusIfNegative(int64_t* d) const {
+        const int64_t negative = d[L - 1] >> 63;
+        for (size_t i = 0; i < L; ++i) d[i] += modulus[i] & negative;
+        carry(d);
+    }
+
+    static void carry(int64_t* d) {
+        for (size_t i = 0; i + 1 < L; ++i) {
+            d[i + 1] += d[i] >> 62;
+            d[i] &= M62;
+        }
+    }
+
+    static void toSigned62(int64_t* out, const mp_limb_t* a) {
+        for (size_t i = 0; i < L; ++i) {
+            const size_t bit = 62 * i, limb = bit / 64, shift = bit % 64;
+            uint64_t w = limb < N ? a[limb] >> shift : 0;
+            if (shift > 2 && limb + 1 < N) w |= a[limb + 1] << (64 - shift);
+            out[i] = static_cast<int64_t>(w) & M62;
+        }
+    }
+
+    // a in [0, p); the shifts 64 j mod 62 are even, so two source limbs always cover a limb of r
+    static void fromSigned62(mp_limb_t* r, const int64_t* a) {
+        for (size_t j = 0; j < N; ++j) {
+            const size_t bit = 64 * j, limb = bit / 62, shift = bit % 62;
+            uint64_t w = static_cast<uint64_t>(a[limb]) >> shift;
+            if (limb + 1 < L) w |= static_cast<uint64_t>(a[limb + 1]) << (62 - shift);
+            r[j] = w;
+        }
+    }
+};
+
+#endif // SAFEGCD_HPP
@@ -0,0 +1,360 @@
+/**
+ * @file scalarmul.hpp
+ * @brief Scalar multiplication algorithms over Jacobian curve arithmetic.
+ *
+ * The algorithms here are templates over the field type and work on any
+ * JacobianCurve. Scalars are passed as little-endian limb arrays so the
+ * recoding reads bits straight from the limbs instead of going through
+ * BigInt division.
+ *
+ * ladderMultiply() and FixedBaseTable::multiplyConstantTime() are the
+ * constant-time variants: they run the complete formulas of ProjectiveCurve
+ * over a fixed number of scalar bits, and select table entries and swap
+ * points with masks, so neither the branches taken nor the memory addresses
+ * touched depend on the scalar.
+ */
+
+#ifndef SCALARMUL_HPP
+#define SCALARMUL_HPP
+
+#include "jacobian.hpp"
+#include "projective.hpp"
+#include <gmp.h>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @brief Smallest supported wNAF window width.
+ */
+const unsigned WNAF_MIN_WIDTH = 2;
+
+/**
+ * @brief Largest supported wNAF window width.
+ */
+const unsigned WNAF_MAX_WIDTH = 8;
+
+/**
+ * @brief Default wNAF window width, a good trade-off for 256-bit scalars.
+ */
+const unsigned WNAF_DEFAULT_WIDTH = 5;
+
+/**
+ * @brief Width-w non-adjacent form recoding of a non-negative scalar.
+ *
+ * Every non-zero digit is odd and lies in [-(2^(w-1) - 1), 2^(w-1) - 1], and
+ * any w consecutive digits contain at most one non-zero digit, so a b-bit
+ * scalar needs about b / (w + 1) additions.
+ *
+ * @param k Scalar limbs, least significant first.
+ * @param n Number of scalar limbs.
+ * @param w Window width in [WNAF_MIN_WIDTH, WNAF_MAX_WIDTH].
+ * @return The digits, least significant first.
+ * @throw std::invalid_argument If the window width is out of range.
+ */
+std::vector<int> wnafRecode(const mp_limb_t* k, size_t n, unsigned w);
+
+/**
+ * @brief Builds the affine table of odd multiples P, 3P, ..., (2^(w-1) - 1)P.
+ *
+ * The multiples are computed in Jacobian coordinates and normalized together
+ * with a single field inversion.
+ *
+ * @param curve The curve arithmetic.
+ * @param P The base point.
+ * @param w Window width; the table has 2^(w-2) entries.
+ * @return The table, entry i holding (2i + 1)P.
+ */
+template <class F>
+std::vector<AffinePoint<F> > oddMultiples(const JacobianCurve<F>& curve, const AffinePoint<F>& P, unsigned w) {
+    const size_t size = static_cast<size_t>(1) << (w - 2);
+    std::vector<JacobianPoint<F> > jacobian(size);
+    curve.fromAffine(jacobian[0], P);
+    if (size > 1) {
+        JacobianPoint<F> twoP;
+        curve.dbl(twoP, jacobian[0]);
+        for (size_t i = 1; i < size; ++i) {
+            curve.add(jacobian[i], jacobian[i - 1], twoP);
+        }
+    }
+    std::vector<AffinePoint<F> > table(size);
+    curve.toAffineBatch(table.data(), jacobian.data(), size);
+    return table;
+}
+
+/**
+ * @brief Variable-base scalar multiplication R = kP with a width-w NAF.
+ *
+ * @param curve The curve arithmetic.
+ * @param R Destination, in Jacobian coordinates.
+ * @param P The base point.
+ * @param k Scalar limbs, least significant first.
+ * @param n Number of scalar limbs.
+ * @param w Window width in [WNAF_MIN_WIDTH, WNAF_MAX_WIDTH].
+ * @throw std::invalid_argument If the window width is out of range.
+ */
+template <class F>
+void wnafMultiply(const JacobianCurve<F>& curve, JacobianPoint<F>& R, const AffinePoint<F>& P,
+                  const mp_limb_t* k, size_t n, unsigned w) {
+    const std::vector<int> digits = wnafRecode(k, n, w);
+    curve.setInfinity(R);
+    if (P.infinity || digits.empty()) return;
+
+    const std::vector<AffinePoint<F> > table = oddMultiples(curve, P, w);
+    AffinePoint<F> negated;
+    for (size_t i = digits.size(); i-- > 0;) {
+        curve.dbl(R, R);
+        const int d = digits[i];
+        if (d > 0) {
+            curve.madd(R, R, table[d >> 1]);
+        } else if (d < 0) {
+            curve.neg(negated, table[(-d) >> 1]);
+            curve.madd(R, R, negated);
+        }
+    }
+}
+
+/**
+ * @brief Interleaved wNAF multiplication R = sum_i k_i P_i (Straus-Shamir trick).
+ *
+ * All terms share one chain of doublings, as long as the longest digit
+ * string; every non-zero digit adds one table entry. Two 256-bit scalars at
+ * width 5 thus cost about 256 doublings and 86 mixed additions instead of
+ * 512 doublings for two separate multiplications. The widths may differ
+ * per term, so a fixed base can use a wider precomputed table.
+ *
+ * @param curve The curve arithmetic.
+ * @param R Destination, in Jacobian coordinates.
+ * @param tables tables[i] the odd multiples of P_i, as built by oddMultiples().
+ * @param digits digits[i] the wNAF digits of k_i, of the width tables[i] was built for.
+ * @param count Number of terms.
+ */
+template <class F>
+void strausMultiply(const JacobianCurve<F>& curve, JacobianPoint<F>& R, const AffinePoint<F>* const* tables,
+                    const std::vector<int>* digits, size_t count) {
+    size_t length = 0;
+    for (size_t t = 0; t < count; ++t) {
+        if (digits[t].size() > length) length = digits[t].size();
+    }
+    curve.setInfinity(R);
+    AffinePoint<F> negated;
+    for (size_t i = length; i-- > 0;) {
+        curve.dbl(R, R);
+        for (size_t t = 0; t < count; ++t) {
+            const int d = i < digits[t].size() ? digits[t][i] : 0;
+            if (d > 0) {
+                curve.madd(R, R, tables[t][d >> 1]);
+            } else if (d < 0) {
+                curve.neg(negated, tables[t][(-d) >> 1]);
+                curve.madd(R, R, negated);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Returns 1 if a equals b and 0 otherwise, with no branch.
+ * @param a First value, below 2^63.
+ * @param b Second value, below 2^63.
+ * @return The equality flag.
+ */
+inline mp_limb_t limbEquals(mp_limb_t a, mp_limb_t b) {
+    return ((a ^ b) - 1) >> 63;
+}
+
+/**
+ * @brief Constant-time variable-base scalar multiplication R = kP with the Montgomery ladder.
+ *
+ * Keeps R1 - R0 = P while scanning the scalar from the top: every bit costs
+ * one complete addition and one complete doubling, and the two registers
+ * trade places through a masked swap instead of a branch. All bits below
+ * the given count are processed, including leading zeros, so the running
+ * time only depends on that count.
+ *
+ * @param curve The complete curve arithmetic.
+ * @param R Destination, in projective coordinates.
+ * @param P The base point.
+ * @param k Scalar limbs, least significant first.
+ * @param n Number of scalar limbs.
+ * @param bits Number of scalar bits to process, usually the bit size of the group order.
+ */
+template <class F>
+void ladderMultiply(const ProjectiveCurve<F>& curve, ProjectivePoint<F>& R, const AffinePoint<F>& P,
+                    const mp_limb_t* k, size_t n, size_t bits) {
+    ProjectivePoint<F> R0, R1;
+    curve.setInfinity(R0);
+    curve.fromAffine(R1, P);
+    mp_limb_t swapped = 0;
+    for (size_t i = bits; i-- > 0;) {
+        const mp_limb_t bit = i / 64 < n ? (k[i / 64] >> (i % 64)) & 1 : 0;
+        ProjectiveCurve<F>::conditionalSwap(R0, R1, bit ^ swapped);
+        swapped = bit;
+        curve.add(R1, R0, R1);
+        curve.dbl(R0, R0);
+    }
+    ProjectiveCurve<F>::conditionalSwap(R0, R1, swapped);
+    R = R0;
+}
+
+/**
+ * @brief Default window width of fixed-base tables.
+ */
+const unsigned FIXED_BASE_DEFAULT_WIDTH = 5;
+
+/**
+ * @brief Extracts a window of bits from a little-endian limb array.
+ * @param k Scalar limbs, least significant first.
+ * @param n Number of scalar limbs.
+ * @param pos Position of the lowest bit of the window.
+ * @param w Window width, at most 63.
+ * @return The w bits starting at pos; bits beyond the scalar read as zero.
+ */
+mp_limb_t scalarWindow(const mp_limb_t* k, size_t n, size_t pos, unsigned w);
+
+/**
+ * @class FixedBaseTable
+ * @brief Precomputed multiples of a fixed base point for doubling-free scalar multiplication.
+ *
+ * This is the comb layout taken to one window per row: the scalar is split
+ * into signed base-2^w digits d_j in [-2^(w-1), 2^(w-1)], and row j stores
+ * m * 2^(wj) * B for m = 1 .. 2^(w-1). Then kB = sum_j d_j 2^(wj) B is a plain
+ * sum of table entries, so a multiplication costs about bits / w mixed
+ * additions and no doublings at all. All entries are kept in affine form,
+ * normalized with a single shared inversion when the table is built.
+ *
+ * @tparam F The field type.
+ */
+template <class F>
+class FixedBaseTable {
+public:
+    /**
+     * @brief Builds the table for a base point.
+     * @param curve The curve arithmetic; it must outlive the table.
+     * @param base The fixed base point, usually the generator.
+     * @param scalarBits Largest scalar size in bits the table must cover.
+     * @param w Window width, from 2 to 8.
+     * @throw std::invalid_argument If the window width is out of range.
+     */
+    FixedBaseTable(const JacobianCurve<F>& curve, const AffinePoint<F>& base, size_t scalarBits,
+                   unsigned w = FIXED_BASE_DEFAULT_WIDTH)
+        : curve_(curve), width(w), rows((scalarBits + w - 1) / w + 1), perRow(static_cast<size_t>(1) << (w - 1)) {
+        if (w < WNAF_MIN_WIDTH || w > WNAF_MAX_WIDTH) {
+            throw std::invalid_argument("Fixed-base window width out of range.");
+        }
+        std::vector<JacobianPoint<F> > jacobian(rows * perRow);
+        JacobianPoint<F> rowBase;
+        curve.fromAffine(rowBase, base);
+        for (size_t j = 0; j < rows; ++j) {
+            JacobianPoint<F>* row = &jacobian[j * perRow];
+            row[0] = rowBase;
+            for (size_t m = 1; m < perRow; ++m) {
+                curve.add(row[m], row[m - 1], rowBase);
+            }
+            for (unsigned i = 0; i < w; ++i) {
+                curve.dbl(rowBase, rowBase);
+            }
+        }
+        table.resize(jacobian.size());
+        curve.toAffineBatch(table.data(), jacobian.data(), jacobian.size());
+    }
+
+    /**
+     * @brief Get the largest scalar size the table covers.
+     * @return Maximum number of scalar bits.
+     */
+    size_t maxBits() const { return (rows - 1) * width; }
+
+    /**
+     * @brief Computes R = kB using only mixed additions.
+     * @param R Destination, in Jacobian coordinates.
+     * @param k Scalar limbs, least significant first.
+     * @param n Number of scalar limbs.
+     * @throw std::invalid_argument If the scalar has more than maxBits() bits.
+     */
+    void multiply(JacobianPoint<F>& R, const mp_limb_t* k, size_t n) const {
+        size_t bits = n * 64;
+        while (bits > 0 && !((k[(bits - 1) / 64] >> ((bits - 1) % 64)) & 1)) --bits;
+        if (bits > maxBits()) {
+            throw std::invalid_argument("Scalar is too large for the fixed-base table.");
+        }
+
+        const mp_limb_t half = static_cast<mp_limb_t>(1) << (width - 1);
+        curve_.setInfinity(R);
+        AffinePoint<F> negated;
+        mp_limb_t carry = 0;
+        for (size_t j = 0; j < rows; ++j) {
+            mp_limb_t digit = scalarWindow(k, n, j * width, width) + carry;
+            carry = 0;
+            if (digit > half) {
+                // Use the negative digit digit - 2^w and carry 2^w into the next window.
+                carry = 1;
+                digit = (half << 1) - digit;
+                if (digit != 0) {
+                    curve_.neg(negated, table[j * perRow + digit - 1]);
+                    curve_.madd(R, R, negated);
+                }
+            } else if (digit != 0) {
+                curve_.madd(R, R, table[j * perRow + digit - 1]);
+            }
+        }
+    }
+
+    /**
+     * @brief Computes R = kB in constant time with complete mixed additions.
+     *
+     * Every row is visited: the signed digit is recoded with masks, the entry
+     * is picked by scanning the whole row with masked moves, negated with a
+     * masked move and added with the complete formulas; the sum is kept only
+     * if the digit is non-zero, again through a masked move.
+     *
+     * @param complete The complete formulas of the same curve.
+     * @param R Destination, in projective coordinates.
+     * @param k Scalar limbs, least significant first.
+     * @param n Number of scalar limbs.
+     * @throw std::invalid_argument If the scalar has bits set above maxBits().
+     */
+    void multiplyConstantTime(const ProjectiveCurve<F>& complete, ProjectivePoint<F>& R,
+                              const mp_limb_t* k, size_t n) const {
+        mp_limb_t high = 0;
+        for (size_t pos = maxBits(); pos < n * 64; pos += width) high |= scalarWindow(k, n, pos, width);
+        if (high != 0) {
+            throw std::invalid_argument("Scalar is too large for the fixed-base table.");
+        }
+
+        const mp_limb_t half = static_cast<mp_limb_t>(1) << (width - 1);
+        const F& field = complete.field();
+        complete.setInfinity(R);
+        ProjectivePoint<F> sum;
+        AffinePoint<F> entry;
+        typename F::Element negated;
+        mp_limb_t carry = 0;
+        for (size_t j = 0; j < rows; ++j) {
+            const mp_limb_t digit = scalarWindow(k, n, j * width, width) + carry;
+            // digit > half stands for digit - 2^w with a carry of 2^w into the next window
+            carry = (half - digit) >> 63;
+            const mp_limb_t magnitude = digit ^ ((digit ^ ((half << 1) - digit)) & -carry);
+
+            const AffinePoint<F>* row = &table[j * perRow];
+            entry = row[0];
+            for (size_t m = 1; m < perRow; ++m) {
+                const mp_limb_t hit = limbEquals(m + 1, magnitude);
+                conditionalMove(entry.x, row[m].x, hit);
+                conditionalMove(entry.y, row[m].y, hit);
+            }
+            field.neg(negated, entry.y);
+            conditionalMove(entry.y, negated, carry);
+
+            complete.madd(sum, R, entry);
+            ProjectiveCurve<F>::conditionalMove(R, sum, limbEquals(magnitude, 0) ^ 1);
+        }
+    }
+
+private:
+    const JacobianCurve<F>& curve_;      ///< The curve arithmetic.
+    unsigned width;                      ///< Window width w.
+    size_t rows;                         ///< Number of windows, one spare for the final carry.
+    size_t perRow;                       ///< Entries per row, 2^(w-1).
+    std::vector<AffinePoint<F> > table;  ///< rows * perRow affine multiples.
+};
+
+#endif // SCALARMUL_HPP
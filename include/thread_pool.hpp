@@ -0,0 +1,124 @@
+/**
+ * @file thread_pool.hpp
+ * @brief A fixed-size pool of worker threads for data-parallel loops.
+ *
+ * The pool runs one loop at a time on the workers and the calling thread, and
+ * parallelFor() returns once every index has been processed. The indices are
+ * grouped into blocks of a given grain, and every thread starts on its own
+ * contiguous range of blocks, claiming them from the front. A thread that runs
+ * dry steals the back half of the remaining range of another thread, so
+ * uneven iterations balance out without the threads contending on one shared
+ * counter. A range is a pair of 32-bit block indices in one atomic word, so an
+ * owner's claim and a thief's steal are one compare-and-swap each.
+ *
+ * Nested calls from inside a loop body run serially on the calling thread.
+ */
+
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief Worker threads that execute the iterations of parallelFor().
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Starts the workers.
+     * @param threads Total number of threads including the caller of parallelFor(),
+     *        or 0 for one per hardware thread.
+     */
+    explicit ThreadPool(unsigned threads = 0);
+
+    /**
+     * @brief Stops and joins the workers.
+     */
+    ~ThreadPool();
+
+    /**
+     * @brief Get the number of threads taking part in a loop.
+     * @return The worker count plus one for the calling thread.
+     */
+    unsigned size() const { return static_cast<unsigned>(workers.size()) + 1; }
+
+    /**
+     * @brief Calls body(i) for every i in [0, count), spread over the pool.
+     *
+     * Threads claim and steal whole blocks of grain consecutive indices, so
+     * a grain that covers a few microseconds of work keeps the claims cheap
+     * relative to the body. Loops of at most grain indices run serially on
+     * the calling thread. If a body throws, the remaining indices are skipped
+     * and the first exception is rethrown on the calling thread.
+     *
+     * @param count Number of iterations.
+     * @param body The loop body.
+     * @param grain Indices per block, at least 1 (default is 1).
+     */
+    void parallelFor(size_t count, const std::function<void(size_t)>& body, size_t grain = 1);
+
+    /**
+     * @brief Get the process-wide pool with one thread per hardware thread.
+     * @return The shared pool, started on the first call.
+     */
+    static ThreadPool& shared();
+
+private:
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @struct Slot
+     * @brief The unclaimed blocks [begin, end) of one thread, packed as begin | end << 32.
+     */
+    struct Slot {
+        std::atomic<uint64_t> range; ///< The packed range.
+        char padding[56];            ///< Keeps the slots of different threads on different cache lines.
+    };
+
+    void workerLoop(unsigned slot);
+    void runBlocks(unsigned slot);
+    bool claim(unsigned slot, size_t& block);
+    bool steal(unsigned slot);
+
+    std::vector<std::thread> workers;
+    std::mutex callMutex; ///< Serializes concurrent parallelFor() callers.
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+
+    const std::function<void(size_t)>* job; ///< Body of the running loop.
+    size_t jobCount;
+    size_t jobGrain;                        ///< Indices per block of the running loop.
+    std::unique_ptr<Slot[]> slots;          ///< One range per thread; slot 0 belongs to the caller.
+    std::atomic<bool> cancelled;            ///< Set by the first exception to skip the other blocks.
+    unsigned generation; ///< Incremented for every loop so workers notice new jobs.
+    unsigned busy;       ///< Workers still inside the running loop.
+    bool stopping;
+    std::exception_ptr error;
+};
+
+/**
+ * @brief Picks the pool for a thread-count knob.
+ *
+ * @param threads 0 to use ThreadPool::shared(), otherwise the requested thread count.
+ * @param local Storage for a pool that is created when threads is not 0.
+ * @return The pool to run on.
+ */
+inline ThreadPool& selectThreadPool(unsigned threads, std::unique_ptr<ThreadPool>& local) {
+    if (threads == 0) return ThreadPool::shared();
+    local.reset(new ThreadPool(threads));
+    return *local;
+}
+
+#endif // THREAD_POOL_HPP
@@ -0,0 +1,884 @@
+/**
+ * @file tower.hpp
+ * @brief The extension field tower Fp2 / Fp6 / Fp12 of pairing-friendly curves.
+ *
+ * Fp2 = Fp[u] / (u^2 + 1), Fp6 = Fp2[v] / (v^3 - xi) and Fp12 = Fp6[w] / (w^2 - v),
+ * with the non-residue xi = k + u for a small integer k. This is the tower of
+ * both BN254 (k = 9) and BLS12-381 (k = 1). Every level offers the interface of
+ * the base fields (add, sub, neg, mul, sqr, inv, zero, one), so Fp2Field can
+ * be plugged into JacobianCurve for the points of G2 as it is.
+ *
+ * Multiplications are Karatsuba at every level (3 products of the level below
+ * in Fp2 and Fp12, 6 in Fp6), squarings use the complex and Chung-Hasan SQR2
+ * formulas, and Fp12 adds the sparse products with Miller loop lines and the
+ * Granger-Scott squaring of the cyclotomic subgroup.
+ */
+
+#ifndef TOWER_HPP
+#define TOWER_HPP
+
+#include "bigint.hpp"
+#include <gmp.h>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @struct Fp2Element
+ * @brief c0 + c1 u in Fp2.
+ * @tparam F The base field type, e.g. MontgomeryField<4>.
+ */
+template <class F>
+struct Fp2Element {
+    typename F::Element c0; ///< Real part.
+    typename F::Element c1; ///< Coefficient of u.
+
+    /**
+     * @brief Check if the element is zero.
+     * @return True if both coefficients are zero, false otherwise.
+     */
+    bool isZero() const { return c0.isZero() && c1.isZero(); }
+
+    /**
+     * @brief Coefficient-wise equality operator.
+     * @param other The element to compare with.
+     * @return True if equal, false otherwise.
+     */
+    bool operator==(const Fp2Element& other) const { return c0 == other.c0 && c1 == other.c1; }
+
+    /**
+     * @brief Coefficient-wise inequality operator.
+     * @param other The element to compare with.
+     * @return True if not equal, false otherwise.
+     */
+    bool operator!=(const Fp2Element& other) const { return !(*this == other); }
+};
+
+/**
+ * @struct Fp6Element
+ * @brief c0 + c1 v + c2 v^2 in Fp6.
+ * @tparam F The base field type.
+ */
+template <class F>
+struct Fp6Element {
+    Fp2Element<F> c0; ///< Constant coefficient.
+    Fp2Element<F> c1; ///< Coefficient of v.
+    Fp2Element<F> c2; ///< Coefficient of v^2.
+
+    /**
+     * @brief Check if the element is zero.
+     * @return True if all coefficients are zero, false otherwise.
+     */
+    bool isZero() const { return c0.isZero() && c1.isZero() && c2.isZero(); }
+
+    /**
+     * @brief Coefficient-wise equality operator.
+     * @param other The element to compare with.
+     * @return True if equal, false otherwise.
+     */
+    bool operator==(const Fp6Element& other) const { return c0 == other.c0 && c1 == other.c1 && c2 == other.c2; }
+
+    /**
+     * @brief Coefficient-wise inequality operator.
+     * @param other The element to compare with.
+     * @return True if not equal, false otherwise.
+     */
+    bool operator!=(const Fp6Element& other) const { return !(*this == other); }
+};
+
+/**
+ * @struct Fp12Element
+ * @brief c0 + c1 w in Fp12, the target group of the pairing.
+ * @tparam F The base field type.
+ */
+template <class F>
+struct Fp12Element {
+    Fp6Element<F> c0; ///< Constant coefficient.
+    Fp6Element<F> c1; ///< Coefficient of w.
+
+    /**
+     * @brief Check if the element is zero.
+     * @return True if both coefficients are zero, false otherwise.
+     */
+    bool isZero() const { return c0.isZero() && c1.isZero(); }
+
+    /**
+     * @brief Coefficient-wise equality operator.
+     * @param other The element to compare with.
+     * @return True if equal, false otherwise.
+     */
+    bool operator==(const Fp12Element& other) const { return c0 == other.c0 && c1 == other.c1; }
+
+    /**
+     * @brief Coefficient-wise inequality operator.
+     * @param other The element to compare with.
+     * @return True if not equal, false otherwise.
+     */
+    bool operator!=(const Fp12Element& other) const { return !(*this == other); }
+};
+
+/**
+ * @class Fp2Field
+ * @brief Arithmetic in Fp2 = Fp[u] / (u^2 + 1), for p = 3 mod 4.
+ * @tparam F The base field type.
+ */
+template <class F>
+class Fp2Field {
+public:
+    typedef Fp2Element<F> Element;      ///< Element type handled by this field.
+    typedef typename F::Element Base;   ///< Base field element type.
+
+    /**
+     * @brief Constructs Fp2 over a base field and the non-residue xi = k + u.
+     * @param base The base field; it must outlive this object.
+     * @param xiReal The integer k of xi = k + u.
+     */
+    Fp2Field(const F& base, unsigned long xiReal) : F_(base) {
+        zeroM.c0 = F_.zero();
+        zeroM.c1 = F_.zero();
+        oneM.c0 = F_.one();
+        oneM.c1 = F_.zero();
+        k = F_.fromBigInt(BigInt(xiReal));
+        xi.c0 = k;
+        xi.c1 = F_.one();
+    }
+
+    /**
+     * @brief Get the base field.
+     * @return The field Fp.
+     */
+    const F& base() const { return F_; }
+
+    /**
+     * @brief The additive identity.
+     * @return Zero.
+     */
+    const Element& zero() const { return zeroM; }
+
+    /**
+     * @brief The multiplicative identity.
+     * @return One.
+     */
+    const Element& one() const { return oneM; }
+
+    /**
+     * @brief The cubic and sextic non-residue of the tower.
+     * @return xi = k + u.
+     */
+    const Element& nonResidue() const { return xi; }
+
+    /**
+     * @brief Builds an element from its coefficients.
+     * @param c0 Real part.
+     * @param c1 Coefficient of u.
+     * @return c0 + c1 u.
+     */
+    Element fromBigInt(const BigInt& c0, const BigInt& c1) const {
+        Element r;
+        r.c0 = F_.fromBigInt(c0);
+        r.c1 = F_.fromBigInt(c1);
+        return r;
+    }
+
+    /**
+     * @brief Addition r = a + b.
+     * @param r Destination; may alias a or b.
+     * @param a First operand.
+     * @param b Second operand.
+     */
+    void add(Element& r, const Element& a, const Element& b) const {
+        F_.add(r.c0, a.c0, b.c0);
+        F_.add(r.c1, a.c1, b.c1);
+    }
+
+    /**
+     * @brief Subtraction r = a - b.
+     * @param r Destination; may alias a or b.
+     * @param a The element to subtract from.
+     * @param b The element to subtract.
+     */
+    void sub(Element& r, const Element& a, const Element& b) const {
+        F_.sub(r.c0, a.c0, b.c0);
+        F_.sub(r.c1, a.c1, b.c1);
+    }
+
+    /**
+     * @brief Negation r = -a.
+     * @param r Destination; may alias a.
+     * @param a The element to negate.
+     */
+    void neg(Element& r, const Element& a) const {
+        F_.neg(r.c0, a.c0);
+        F_.neg(r.c1, a.c1);
+    }
+
+    /**
+     * @brief Conjugation r = c0 - c1 u, the Frobenius map of Fp2.
+     * @param r Destination; may alias a.
+     * @param a The element.
+     */
+    void conjugate(Element& r, const Element& a) const {
+        r.c0 = a.c0;
+        F_.neg(r.c1, a.c1);
+    }
+
+    /**
+     * @brief Karatsuba multiplication r = a * b with 3 base field products.
+     * @param r Destination; may alias a or b.
+     * @param a First operand.
+     * @param b Second operand.
+     */
+    void mul(Element& r, const Element& a, const Element& b) const {
+        Base v0, v1, s, t;
+        F_.mul(v0, a.c0, b.c0);
+        F_.mul(v1, a.c1, b.c1);
+        F_.add(s, a.c0, a.c1);
+        F_.add(t, b.c0, b.c1);
+        F_.mul(s, s, t);
+        F_.sub(r.c0, v0, v1);
+        F_.sub(s, s, v0);
+        F_.sub(r.c1, s, v1);
+    }
+
+    /**
+     * @brief Complex squaring r = a^2 with 2 base field products.
+     * @param r Destination; may alias a.
+     * @param a The element to square.
+     */
+    void sqr(Element& r, const Element& a) const {
+        Base s, d, m;
+        F_.add(s, a.c0, a.c1);
+        F_.sub(d, a.c0, a.c1);
+        F_.mul(m, a.c0, a.c1);
+        F_.mul(r.c0, s, d);
+        F_.add(r.c1, m, m);
+    }
+
+    /**
+     * @brief Multiplication by a base field element, r = a * s.
+     * @param r Destination; may alias a.
+     * @param a The Fp2 element.
+     * @param s The base field element.
+     */
+    void mulByBase(Element& r, const Element& a, const Base& s) const {
+        F_.mul(r.c0, a.c0, s);
+        F_.mul(r.c1, a.c1, s);
+    }
+
+    /**
+     * @brief Multiplication by the non-residue, r = a * (k + u), with 2 base field products.
+     * @param r Destination; may alias a.
+     * @param a The element.
+     */
+    void mulByNonResidue(Element& r, const Element& a) const {
+        Base t0, t1;
+        F_.mul(t0, a.c0, k);
+        F_.mul(t1, a.c1, k);
+        F_.sub(t0, t0, a.c1);
+        F_.add(r.c1, t1, a.c0);
+        r.c0 = t0;
+    }
+
+    /**
+     * @brief Inversion r = a^-1 = conj(a) / (c0^2 + c1^2), one base field inversion.
+     * @param r Destination; may alias a.
+     * @param a The element to invert; the inverse of zero is zero.
+     */
+    void inv(Element& r, const Element& a) const {
+        Base n, t;
+        F_.sqr(n, a.c0);
+        F_.sqr(t, a.c1);
+        F_.add(n, n, t);
+        F_.inv(n, n);
+        F_.mul(r.c0, a.c0, n);
+        F_.mul(t, a.c1, n);
+        F_.neg(r.c1, t);
+    }
+
+    /**
+     * @brief Exponentiation r = a^e by left-to-right square and multiply.
+     * @param r Destination; may alias a.
+     * @param a The base.
+     * @param e The exponent, non-negative.
+     */
+    void pow(Element& r, const Element& a, const BigInt& e) const {
+        const Element base = a;
+        Element acc = oneM;
+        for (size_t i = e.bitSize(); i-- > 0;) {
+            sqr(acc, acc);
+            if (e.testBit(i)) mul(acc, acc, base);
+        }
+        r = acc;
+    }
+
+private:
+    const F& F_;   ///< The base field.
+    Base k;        ///< The integer part of xi.
+    Element xi;    ///< The non-residue k + u.
+    Element zeroM; ///< Zero.
+    Element oneM;  ///< One.
+};
+
+/**
+ * @class Fp6Field
+ * @brief Arithmetic in Fp6 = Fp2[v] / (v^3 - xi).
+ * @tparam F The base field type.
+ */
+template <class F>
+class Fp6Field {
+public:
+    typedef Fp6Element<F> Element; ///< Element type handled by this field.
+    typedef Fp2Element<F> Fp2;     ///< Coefficient type.
+
+    /**
+     * @brief Constructs Fp6 over Fp2 and precomputes the Frobenius coefficients.
+     * @param fp2 The quadratic extension; it must outlive this object.
+     */
+    explicit Fp6Field(const Fp2Field<F>& fp2) : E_(fp2) {
+        zeroM.c0 = zeroM.c1 = zeroM.c2 = E_.zero();
+        oneM = zeroM;
+        oneM.c0 = E_.one();
+        // v^(p^k) = xi^((p^k - 1) / 3) v
+        const BigInt& p = E_.base().getMod();
+        BigInt pk(1UL);
+        for (int i = 0; i < 3; ++i) {
+            pk = pk * p;
+            const BigInt e = (pk - BigInt(1UL)) / BigInt(3UL);
+            E_.pow(frobeniusV[i], E_.nonResidue(), e);
+            E_.sqr(frobeniusV2[i], frobeniusV[i]);
+        }
+    }
+
+    /**
+     * @brief Get the quadratic extension below.
+     * @return Fp2.
+     */
+    const Fp2Field<F>& fp2() const { return E_; }
+
+    /**
+     * @brief The additive identity.
+     * @return Zero.
+     */
+    const Element& zero() const { return zeroM; }
+
+    /**
+     * @brief The multiplicative identity.
+     * @return One.
+     */
+    const Element& one() const { return oneM; }
+
+    /**
+     * @brief Addition r = a + b.
+     * @param r Destination; may alias a or b.
+     * @param a First operand.
+     * @param b Second operand.
+     */
+    void add(Element& r, const Element& a, const Element& b) const {
+        E_.add(r.c0, a.c0, b.c0);
+        E_.add(r.c1, a.c1, b.c1);
+        E_.add(r.c2, a.c2, b.c2);
+    }
+
+    /**
+     * @brief Subtraction r = a - b.
+     * @param r Destination; may alias a or b.
+     * @param a The element to subtract from.
+     * @param b The element to subtract.
+     */
+    void sub(Element& r, const Element& a, const Element& b) const {
+        E_.sub(r.c0, a.c0, b.c0);
+        E_.sub(r.c1, a.c1, b.c1);
+        E_.sub(r.c2, a.c2, b.c2);
+    }
+
+    /**
+     * @brief Negation r = -a.
+     * @param r Destination; may alias a.
+     * @param a The element to negate.
+     */
+    void neg(Element& r, const Element& a) const {
+        E_.neg(r.c0, a.c0);
+        E_.neg(r.c1, a.c1);
+        E_.neg(r.c2, a.c2);
+    }
+
+    /**
+     * @brief Karatsuba multiplication r = a * b with 6 Fp2 products.
+     * @param r Destination; may alias a or b.
+     * @param a First operand.
+     * @param b Second operand.
+     */
+    void mul(Element& r, const Element& a, const Element& b) const {
+        Fp2 v0, v1, v2, s, t, c0, c1, c2;
+        E_.mul(v0, a.c0, b.c0);
+        E_.mul(v1, a.c1, b.c1);
+        E_.mul(v2, a.c2, b.c2);
+        // c0 = v0 + xi ((a1 + a2)(b1 + b2) - v1 - v2)
+        E_.add(s, a.c1, a.c2);
+        E_.add(t, b.c1, b.c2);
+        E_.mul(s, s, t);
+        E_.sub(s, s, v1);
+        E_.sub(s, s, v2);
+        E_.mulByNonResidue(s, s);
+        E_.add(c0, s, v0);
+        // c1 = (a0 + a1)(b0 + b1) - v0 - v1 + xi v2
+        E_.add(s, a.c0, a.c1);
+        E_.add(t, b.c0, b.c1);
+        E_.mul(s, s, t);
+        E_.sub(s, s, v0);
+        E_.sub(s, s, v1);
+        E_.mulByNonResidue(t, v2);
+        E_.add(c1, s, t);
+        // c2 = (a0 + a2)(b0 + b2) - v0 - v2 + v1
+        E_.add(s, a.c0, a.c2);
+        E_.add(t, b.c0, b.c2);
+        E_.mul(s, s, t);
+        E_.sub(s, s, v0);
+        E_.sub(s, s, v2);
+        E_.add(c2, s, v1);
+        r.c0 = c0;
+        r.c1 = c1;
+        r.c2 = c2;
+    }
+
+    /**
+     * @brief Chung-Hasan SQR2 squaring r = a^2 with 2 Fp2 products and 3 Fp2 squarings.
+     * @param r Destination; may alias a.
+     * @param a The element to square.
+     */
+    void sqr(Element& r, const Element& a) const {
+        Fp2 s0, s1, s2, s3, s4, t;
+        E_.sqr(s0, a.c0);
+        E_.mul(s1, a.c0, a.c1);
+        E_.add(s1, s1, s1);
+        E_.sub(s2, a.c0, a.c1);
+        E_.add(s2, s2, a.c2);
+        E_.sqr(s2, s2);
+        E_.mul(s3, a.c1, a.c2);
+        E_.add(s3, s3, s3);
+        E_.sqr(s4, a.c2);
+        E_.mulByNonResidue(t, s3);
+        E_.add(r.c0, s0, t);
+        E_.mulByNonResidue(t, s4);
+        E_.add(r.c1, s1, t);
+        E_.add(t, s1, s2);
+        E_.add(t, t, s3);
+        E_.sub(t, t, s0);
+        E_.sub(r.c2, t, s4);
+    }
+
+    /**
+     * @brief Multiplication by v, r = a * v = xi c2 + c0 v + c1 v^2.
+     * @param r Destination; may alias a.
+     * @param a The element.
+     */
+    void mulByV(Element& r, const Element& a) const {
+        Fp2 t;
+        E_.mulByNonResidue(t, a.c2);
+        r.c2 = a.c1;
+        r.c1 = a.c0;
+        r.c0 = t;
+    }
+
+    /**
+     * @brief Multiplication by an Fp2 element, r = a * s.
+     * @param r Destination; may alias a.
+     * @param a The Fp6 element.
+     * @param s The Fp2 element.
+     */
+    void mulByFp2(Element& r, const Element& a, const Fp2& s) const {
+        E_.mul(r.c0, a.c0, s);
+        E_.mul(r.c1, a.c1, s);
+        E_.mul(r.c2, a.c2, s);
+    }
+
+    /**
+     * @brief Sparse multiplication r = a * (b0 + b1 v) with 5 Fp2 products.
+     * @param r Destination; may alias a.
+     * @param a The element.
+     * @param b0 Constant coefficient of the sparse factor.
+     * @param b1 Coefficient of v of the sparse factor.
+     */
+    void mulBy01(Element& r, const Element& a, const Fp2& b0, const Fp2& b1) const {
+        Fp2 v0, v1, s, t, c0, c1, c2;
+        E_.mul(v0, a.c0, b0);
+        E_.mul(v1, a.c1, b1);
+        // c0 = v0 + xi (a1 + a2) b1 - xi v1
+        E_.add(s, a.c1, a.c2);
+        E_.mul(s, s, b1);
+        E_.sub(s, s, v1);
+        E_.mulByNonResidue(s, s);
+        E_.add(c0, s, v0);
+        // c1 = (a0 + a1)(b0 + b1) - v0 - v1
+        E_.add(s, a.c0, a.c1);
+        E_.add(t, b0, b1);
+        E_.mul(s, s, t);
+        E_.sub(s, s, v0);
+        E_.sub(c1, s, v1);
+        // c2 = (a0 + a2) b0 - v0 + v1
+        E_.add(s, a.c0, a.c2);
+        E_.mul(s, s, b0);
+        E_.sub(s, s, v0);
+        E_.add(c2, s, v1);
+        r.c0 = c0;
+        r.c1 = c1;
+        r.c2 = c2;
+    }
+
+    /**
+     * @brief Sparse multiplication r = a * b1 v with 3 Fp2 products.
+     * @param r Destination; may alias a.
+     * @param a The element.
+     * @param b1 Coefficient of v of the sparse factor.
+     */
+    void mulBy1(Element& r, const Element& a, const Fp2& b1) const {
+        Fp2 c0;
+        E_.mul(c0, a.c2, b1);
+        E_.mulByNonResidue(c0, c0);
+        E_.mul(r.c2, a.c1, b1);
+        E_.mul(r.c1, a.c0, b1);
+        r.c0 = c0;
+    }
+
+    /**
+     * @brief Inversion r = a^-1 through the norm to Fp2, one Fp2 inversion.
+     * @param r Destination; may alias a.
+     * @param a The element to invert; the inverse of zero is zero.
+     */
+    void inv(Element& r, const Element& a) const {
+        Fp2 t0, t1, t2, s, d;
+        // t0 = a0^2 - xi a1 a2, t1 = xi a2^2 - a0 a1, t2 = a1^2 - a0 a2
+        E_.sqr(t0, a.c0);
+        E_.mul(s, a.c1, a.c2);
+        E_.mulByNonResidue(s, s);
+        E_.sub(t0, t0, s);
+        E_.sqr(t1, a.c2);
+        E_.mulByNonResidue(t1, t1);
+        E_.mul(s, a.c0, a.c1);
+        E_.sub(t1, t1, s);
+        E_.sqr(t2, a.c1);
+        E_.mul(s, a.c0, a.c2);
+        E_.sub(t2, t2, s);
+        // d = a0 t0 + xi (a2 t1 + a1 t2)
+        E_.mul(d, a.c2, t1);
+        E_.mul(s, a.c1, t2);
+        E_.add(d, d, s);
+        E_.mulByNonResidue(d, d);
+        E_.mul(s, a.c0, t0);
+        E_.add(d, d, s);
+        E_.inv(d, d);
+        E_.mul(r.c0, t0, d);
+        E_.mul(r.c1, t1, d);
+        E_.mul(r.c2, t2, d);
+    }
+
+    /**
+     * @brief The Frobenius map r = a^(p^k).
+     * @param r Destination; may alias a.
+     * @param a The element.
+     * @param k The power of p, 1, 2 or 3.
+     */
+    void frobenius(Element& r, const Element& a, unsigned k) const {
+        const bool odd = k & 1;
+        if (odd) {
+            E_.conjugate(r.c0, a.c0);
+            E_.conjugate(r.c1, a.c1);
+            E_.conjugate(r.c2, a.c2);
+        } else {
+            r = a;
+        }
+        E_.mul(r.c1, r.c1, frobeniusV[k - 1]);
+        E_.mul(r.c2, r.c2, frobeniusV2[k - 1]);
+    }
+
+private:
+    const Fp2Field<F>& E_; ///< The quadratic extension.
+    Fp2 frobeniusV[3];     ///< xi^((p^k - 1) / 3), k = 1, 2, 3.
+    Fp2 frobeniusV2[3];    ///< xi^(2 (p^k - 1) / 3), k = 1, 2, 3.
+    Element zeroM;         ///< Zero.
+    Element oneM;          ///< One.
+};
+
+/**
+ * @class Fp12Field
+ * @brief Arithmetic in Fp12 = Fp6[w] / (w^2 - v).
+ * @tparam F The base field type.
+ */
+template <class F>
+class Fp12Field {
+public:
+    typedef Fp12Element<F> Element; ///< Element type handled by this field.
+    typedef Fp6Element<F> Fp6;      ///< Coefficient type.
+    typedef Fp2Element<F> Fp2;      ///< Coefficient type of Fp6.
+
+    /**
+     * @brief Constructs Fp12 over Fp6 and precomputes the Frobenius coefficients.
+     * @param fp6 The sextic extension; it must outlive this object.
+     */
+    explicit Fp12Field(const Fp6Field<F>& fp6) : S_(fp6), E_(fp6.fp2()) {
+        zeroM.c0 = zeroM.c1 = S_.zero();
+        oneM = zeroM;
+        oneM.c0 = S_.one();
+        // w^(p^k) = xi^((p^k - 1) / 6) w
+        const BigInt& p = E_.base().getMod();
+        BigInt pk(1UL);
+        for (int i = 0; i < 3; ++i) {
+            pk = pk * p;
+            E_.pow(frobeniusW[i], E_.nonResidue(), (pk - BigInt(1UL)) / BigInt(6UL));
+        }
+    }
+
+    /**
+     * @brief Get the sextic extension below.
+     * @return Fp6.
+     */
+    const Fp6Field<F>& fp6() const { return S_; }
+
+    /**
+     * @brief The additive identity.
+     * @return Zero.
+     */
+    const Element& zero() const { return zeroM; }
+
+    /**
+     * @brief The multiplicative identity.
+     * @return One.
+     */
+    const Element& one() const { return oneM; }
+
+    /**
+     * @brief Karatsuba multiplication r = a * b with 3 Fp6 products.
+     * @param r Destination; may alias a or b.
+     * @param a First operand.
+     * @param b Second operand.
+     */
+    void mul(Element& r, const Element& a, const Element& b) const {
+        Fp6 v0, v1, s, t;
+        S_.mul(v0, a.c0, b.c0);
+        S_.mul(v1, a.c1, b.c1);
+        S_.add(s, a.c0, a.c1);
+        S_.add(t, b.c0, b.c1);
+        S_.mul(s, s, t);
+        S_.sub(s, s, v0);
+        S_.sub(r.c1, s, v1);
+        S_.mulByV(v1, v1);
+        S_.add(r.c0, v0, v1);
+    }
+
+    /**
+     * @brief Complex squaring r = a^2 with 2 Fp6 products.
+     * @param r Destination; may alias a.
+     * @param a The element to square.
+     */
+    void sqr(Element& r, const Element& a) const {
+        Fp6 m, s, t;
+        // (a0 + a1 w)^2 = (a0 + a1)(a0 + v a1) - m - v m + 2 m w, m = a0 a1
+        S_.mul(m, a.c0, a.c1);
+        S_.add(s, a.c0, a.c1);
+        S_.mulByV(t, a.c1);
+        S_.add(t, t, a.c0);
+        S_.mul(s, s, t);
+        S_.sub(s, s, m);
+        S_.mulByV(t, m);
+        S_.sub(r.c0, s, t);
+        S_.add(r.c1, m, m);
+    }
+
+    /**
+     * @brief Inversion r = a^-1 = (a0 - a1 w) / (a0^2 - v a1^2), one Fp6 inversion.
+     * @param r Destination; may alias a.
+     * @param a The element to invert; the inverse of zero is zero.
+     */
+    void inv(Element& r, const Element& a) const {
+        Fp6 t0, t1;
+        S_.sqr(t0, a.c0);
+        S_.sqr(t1, a.c1);
+        S_.mulByV(t1, t1);
+        S_.sub(t0, t0, t1);
+        S_.inv(t0, t0);
+        S_.mul(r.c0, a.c0, t0);
+        S_.mul(t1, a.c1, t0);
+        S_.neg(r.c1, t1);
+    }
+
+    /**
+     * @brief Conjugation r = a0 - a1 w = a^(p^6); the inverse on the cyclotomic subgroup.
+     * @param r Destination; may alias a.
+     * @param a The element.
+     */
+    void conjugate(Element& r, const Element& a) const {
+        r.c0 = a.c0;
+        S_.neg(r.c1, a.c1);
+    }
+
+    /**
+     * @brief The Frobenius map r = a^(p^k).
+     * @param r Destination; may alias a.
+     * @param a The element.
+     * @param k The power of p, 1, 2 or 3.
+     */
+    void frobenius(Element& r, const Element& a, unsigned k) const {
+        S_.frobenius(r.c0, a.c0, k);
+        S_.frobenius(r.c1, a.c1, k);
+        S_.mulByFp2(r.c1, r.c1, frobeniusW[k - 1]);
+    }
+
+    /**
+     * @brief Sparse multiplication by a line, r = a * (b0 + b1 v + b4 v w) (M-type twists).
+     * @param r Destination; may alias a.
+     * @param a The element.
+     * @param b0 Coefficient of 1.
+     * @param b1 Coefficient of v.
+     * @param b4 Coefficient of v w.
+     */
+    void mulBy014(Element& r, const Element& a, const Fp2& b0, const Fp2& b1, const Fp2& b4) const {
+        Fp6 v0, v1, s;
+        Fp2 t;
+        S_.mulBy01(v0, a.c0, b0, b1);
+        S_.mulBy1(v1, a.c1, b4);
+        E_.add(t, b1, b4);
+        S_.add(s, a.c0, a.c1);
+        S_.mulBy01(s, s, b0, t);
+        S_.sub(s, s, v0);
+        S_.sub(r.c1, s, v1);
+        S_.mulByV(v1, v1);
+        S_.add(r.c0, v1, v0);
+    }
+
+    /**
+     * @brief Sparse multiplication by a line, r = a * (b0 + b3 w + b4 v w) (D-type twists).
+     * @param r Destination; may alias a.
+     * @param a The element.
+     * @param b0 Coefficient of 1.
+     * @param b3 Coefficient of w.
+     * @param b4 Coefficient of v w.
+     */
+    void mulBy034(Element& r, const Element& a, const Fp2& b0, const Fp2& b3, const Fp2& b4) const {
+        Fp6 v0, v1, s;
+        Fp2 t;
+        S_.mulByFp2(v0, a.c0, b0);
+        S_.mulBy01(v1, a.c1, b3, b4);
+        E_.add(t, b0, b3);
+        S_.add(s, a.c0, a.c1);
+        S_.mulBy01(s, s, t, b4);
+        S_.sub(s, s, v0);
+        S_.sub(r.c1, s, v1);
+        S_.mulByV(v1, v1);
+        S_.add(r.c0, v1, v0);
+    }
+
+    /**
+     * @brief Granger-Scott squaring in the cyclotomic subgroup, 6 Fp2 products.
+     *
+     * Valid only for a with a^(p^6 + 1) = 1, e.g. after the easy part of the
+     * final exponentiation; elsewhere the result is not a^2.
+     *
+     * @param r Destination; may alias a.
+     * @param a The element of the cyclotomic subgroup.
+     */
+    void cyclotomicSqr(Element& r, const Element& a) const {
+        // Fp12 as Fp4^3 with Fp4 = Fp2[y] / (y^2 - xi): (z0, z1), (z2, z3), (z4, z5)
+        const Fp2& z0 = a.c0.c0;
+        const Fp2& z4 = a.c0.c1;
+        const Fp2& z3 = a.c0.c2;
+        const Fp2& z2 = a.c1.c0;
+        const Fp2& z1 = a.c1.c1;
+        const Fp2& z5 = a.c1.c2;
+        Fp2 t0, t1, t2, t3, t4, t5;
+        fp4Sqr(t0, t1, z0, z1);
+        fp4Sqr(t2, t3, z2, z3);
+        fp4Sqr(t4, t5, z4, z5);
+
+        Fp2 t;
+        Element out;
+        // z0 = 3 t0 - 2 z0, z1 = 3 t1 + 2 z1
+        tripleMinusDouble(out.c0.c0, t0, z0);
+        triplePlusDouble(out.c1.c1, t1, z1);
+        // z2 = 3 xi t5 + 2 z2, z3 = 3 t4 - 2 z3
+        E_.mulByNonResidue(t, t5);
+        triplePlusDouble(out.c1.c0, t, z2);
+        tripleMinusDouble(out.c0.c2, t4, z3);
+        // z4 = 3 t2 - 2 z4, z5 = 3 t3 + 2 z5
+        tripleMinusDouble(out.c0.c1, t2, z4);
+        triplePlusDouble(out.c1.c2, t3, z5);
+        r = out;
+    }
+
+    /**
+     * @brief Exponentiation r = a^e in the cyclotomic subgroup by cyclotomic squarings.
+     * @param r Destination; may alias a.
+     * @param a The element of the cyclotomic subgroup.
+     * @param e The exponent, non-negative.
+     */
+    void cyclotomicPow(Element& r, const Element& a, uint64_t e) const {
+        const Element base = a;
+        Element acc = oneM;
+        bool started = false;
+        for (int i = 63; i >= 0; --i) {
+            if (started) cyclotomicSqr(acc, acc);
+            if ((e >> i) & 1) {
+                if (started) mul(acc, acc, base);
+                else acc = base;
+                started = true;
+            }
+        }
+        r = acc;
+    }
+
+    /**
+     * @brief Exponentiation r = a^e in the cyclotomic subgroup by a BigInt exponent.
+     * @param r Destination; may alias a.
+     * @param a The element of the cyclotomic subgroup.
+     * @param e The exponent; a negative exponent raises the conjugate.
+     */
+    void cyclotomicPow(Element& r, const Element& a, const BigInt& e) const {
+        Element base = a;
+        if (e.isNegative()) conjugate(base, base);
+        Element acc = oneM;
+        for (size_t i = e.bitSize(); i-- > 0;) {
+            cyclotomicSqr(acc, acc);
+            if (e.testBit(i)) mul(acc, acc, base);
+        }
+        r = acc;
+    }
+
+private:
+    const Fp6Field<F>& S_; ///< The sextic extension.
+    const Fp2Field<F>& E_; ///< The quadratic extension.
+    Fp2 frobeniusW[3];     ///< xi^((p^k - 1) / 6), k = 1, 2, 3.
+    Element zeroM;         ///< Zero.
+    Element oneM;          ///< One.
+
+    // (a + b y)^2 in Fp4 = Fp2[y] / (y^2 - xi): r0 = a^2 + xi b^2, r1 = 2 a b
+    void fp4Sqr(Fp2& r0, Fp2& r1, const Fp2& a, const Fp2& b) const {
+        Fp2 m, s, t;
+        E_.mul(m, a, b);
+        E_.add(s, a, b);
+        E_.mulByNonResidue(t, b);
+        E_.add(t, t, a);
+        E_.mul(s, s, t);
+        E_.sub(s, s, m);
+        E_.mulByNonResidue(t, m);
+        E_.sub(r0, s, t);
+        E_.add(r1, m, m);
+    }
+
+    // r = 3 t - 2 z
+    void tripleMinusDouble(Fp2& r, const Fp2& t, const Fp2& z) const {
+        Fp2 s;
+        E_.sub(s, t, z);
+        E_.add(s, s, s);
+        E_.add(r, s, t);
+    }
+
+    // r = 3 t + 2 z
+    void triplePlusDouble(Fp2& r, const Fp2& t, const Fp2& z) const {
+        Fp2 s;
+        E_.add(s, t, z);
+        E_.add(s, s, s);
+        E_.add(r, s, t);
+    }
+};
+
+#endif // TOWER_HPP
@@ -0,0 +1,161 @@
+/**
+ * @file vecmod.hpp
+ * @brief Element-wise modular arithmetic on dense arrays of fixed-width integers.
+ *
+ * The kernels work on the contiguous limb layout of LimbBuffer: count integers
+ * of m.width() limbs each, stored back to back, all canonical in [0, m). There
+ * are three backends, picked once at runtime from the CPU features:
+ * - Avx512Ifma: eight elements per register in 52-bit digits, multiplied with
+ *   the IFMA instructions vpmadd52luq/vpmadd52huq;
+ * - Avx2: additions and subtractions on four limbs per register; products use
+ *   the scalar code, which beats 32x32-bit vector multiplies on 64-bit limbs;
+ * - Scalar: the portable mpn_* / MontgomeryField code.
+ * Elements of more than eight limbs are added and subtracted by the scalar code.
+ * Every backend returns the same results.
+ */
+
+#ifndef VECMOD_HPP
+#define VECMOD_HPP
+
+#include "bigint.hpp"
+#include <gmp.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @enum VecBackend
+ * @brief Implementation used by the vec*Mod kernels.
+ */
+enum class VecBackend {
+    Scalar,    ///< Portable mpn_* code.
+    Avx2,      ///< AVX2, four 64-bit lanes.
+    Avx512Ifma ///< AVX-512F with IFMA, eight 64-bit lanes.
+};
+
+/**
+ * @brief Check if the CPU and the build support a backend.
+ * @param backend The backend to check.
+ * @return True if the backend can be selected.
+ */
+bool vecBackendSupported(VecBackend backend);
+
+/**
+ * @brief Get the backend in use; initially the fastest supported one.
+ * @return The selected backend.
+ */
+VecBackend vecBackend();
+
+/**
+ * @brief Select the backend for all subsequent calls, e.g. to compare implementations.
+ * @param backend The backend to use.
+ * @throw std::invalid_argument If the backend is not supported.
+ */
+void setVecBackend(VecBackend backend);
+
+/**
+ * @class VecModulus
+ * @brief A modulus with the constants every backend needs, computed once.
+ */
+class VecModulus {
+public:
+    /**
+     * @brief Largest number of 52-bit digits of the IFMA backend, i.e. moduli below 2^520.
+     */
+    static const size_t MAX_DIGITS_52 = 10;
+
+    /**
+     * @brief Precomputes the constants of a modulus.
+     * @param modulus The modulus, positive.
+     * @throw std::invalid_argument If the modulus is not positive.
+     */
+    explicit VecModulus(const BigInt& modulus);
+
+    /**
+     * @brief Get the modulus.
+     * @return The modulus as a BigInt.
+     */
+    const BigInt& value() const { return mod; }
+
+    /**
+     * @brief Get the limbs per element.
+     * @return The limb count of the modulus.
+     */
+    size_t width() const { return limbs.size(); }
+
+    /**
+     * @brief Get the limbs of the modulus.
+     * @return width() limbs, least significant first.
+     */
+    const mp_limb_t* data() const { return limbs.data(); }
+
+    /**
+     * @brief Check if the Montgomery based multiplication kernels apply.
+     * @return True if the modulus is odd.
+     */
+    bool odd() const { return limbs[0] & 1; }
+
+private:
+    friend struct VecKernels;
+
+    BigInt mod;
+    std::vector<mp_limb_t> limbs;
+
+    // IFMA: p in 52-bit digits, -p^-1 mod 2^52 and R^2 mod p for R = 2^(52 * digits52);
+    // digits52 is 0 if the kernel does not apply.
+    size_t digits52;
+    uint64_t p52[MAX_DIGITS_52];
+    uint64_t pInv52;
+    uint64_t rr52[MAX_DIGITS_52];
+
+};
+
+/**
+ * @brief r[i] = a[i] + b[i] mod m for count elements.
+ * @param r Destination; may alias a or b.
+ * @param a First operands, canonical.
+ * @param b Second operands, canonical.
+ * @param count Number of elements.
+ * @param m The modulus.
+ */
+void vecAddMod(mp_limb_t* r, const mp_limb_t* a, const mp_limb_t* b, size_t count, const VecModulus& m);
+
+/**
+ * @brief r[i] = a[i] - b[i] mod m for count elements.
+ * @param r Destination; may alias a or b.
+ * @param a First operands, canonical.
+ * @param b Second operands, canonical.
+ * @param count Number of elements.
+ * @param m The modulus.
+ */
+void vecSubMod(mp_limb_t* r, const mp_limb_t* a, const mp_limb_t* b, size_t count, const VecModulus& m);
+
+/**
+ * @brief r[i] = a[i] * b[i] mod m for count elements.
+ *
+ * Odd moduli use two Montgomery multiplications per element, the second one by
+ * R^2 to cancel the Montgomery factor; even moduli fall back to division.
+ *
+ * @param r Destination; may alias a or b.
+ * @param a First operands, canonical.
+ * @param b Second operands, canonical.
+ * @param count Number of elements.
+ * @param m The modulus.
+ */
+void vecMulMod(mp_limb_t* r, const mp_limb_t* a, const mp_limb_t* b, size_t count, const VecModulus& m);
+
+/**
+ * @brief r[i] = a[i] * s mod m for count elements.
+ *
+ * The scalar is moved into Montgomery form once, so odd moduli need a single
+ * Montgomery multiplication per element.
+ *
+ * @param r Destination; may alias a.
+ * @param a The operands, canonical.
+ * @param s The scalar, canonical, m.width() limbs.
+ * @param count Number of elements.
+ * @param m The modulus.
+ */
+void vecMulScalarMod(mp_limb_t* r, const mp_limb_t* a, const mp_limb_t* s, size_t count, const VecModulus& m);
+
+#endif // VECMOD_HPP
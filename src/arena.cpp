@@ -0,0 +1,207 @@
+#include "../include/arena.hpp"
+#include "../include/instrument.hpp"
+#include <gmp.h>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#define ARENA_MMAP 1
+#endif
+
+namespace {
+
+// Address space reserved for chunks; pages are only committed when a chunk is first used.
+const size_t REGION_BYTES = static_cast<size_t>(1) << 34;
+const size_t CHUNK_COUNT = REGION_BYTES / BigIntArena::CHUNK_BYTES;
+
+// Blocks above this size are rare and would waste most of a chunk.
+const size_t MAX_BLOCK = BigIntArena::CHUNK_BYTES / 4;
+
+const size_t BLOCK_ALIGN = 16;
+
+// Set in a chunk state while an arena still bumps into it; the low bits count the live blocks.
+const size_t OPEN = static_cast<size_t>(1) << (sizeof(size_t) * 8 - 1);
+
+size_t roundUp(size_t size) {
+    return (size + BLOCK_ALIGN - 1) & ~(BLOCK_ALIGN - 1);
+}
+
+struct Region {
+    char* base;
+    std::unique_ptr<std::atomic<size_t>[]> state;
+    std::mutex mutex; ///< Guards the chunk lists below.
+    std::vector<size_t> freeChunks;
+    size_t fresh;     ///< Chunks never handed out so far.
+
+    void* (*heapAllocate)(size_t);
+    void* (*heapReallocate)(void*, size_t, size_t);
+    void (*heapFree)(void*, size_t);
+
+    bool owns(const void* p) const {
+        return reinterpret_cast<uintptr_t>(p) - reinterpret_cast<uintptr_t>(base) < REGION_BYTES;
+    }
+
+    size_t chunkOf(const void* p) const {
+        return (reinterpret_cast<uintptr_t>(p) - reinterpret_cast<uintptr_t>(base)) / BigIntArena::CHUNK_BYTES;
+    }
+
+    char* chunkStart(size_t c) const { return base + c * BigIntArena::CHUNK_BYTES; }
+
+    // Hands out a chunk with no live blocks, or CHUNK_COUNT if the region is exhausted.
+    size_t acquire() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!freeChunks.empty()) {
+            size_t c = freeChunks.back();
+            freeChunks.pop_back();
+            return c;
+        }
+        if (fresh == CHUNK_COUNT) return CHUNK_COUNT;
+#ifdef ARENA_MMAP
+        if (mprotect(chunkStart(fresh), BigIntArena::CHUNK_BYTES, PROT_READ | PROT_WRITE) != 0) return CHUNK_COUNT;
+#endif
+        return fresh++;
+    }
+
+    void release(size_t c) {
+        std::lock_guard<std::mutex> lock(mutex);
+        freeChunks.push_back(c);
+    }
+
+    // Exactly one of the last free and the arena leaving the chunk sees the state drop to 0.
+    void dropBlock(size_t c) {
+        if (state[c].fetch_sub(1, std::memory_order_acq_rel) == 1) release(c);
+    }
+
+    void close(size_t c) {
+        if (state[c].fetch_sub(OPEN, std::memory_order_acq_rel) == OPEN) release(c);
+    }
+};
+
+Region* region = nullptr;
+std::once_flag installOnce;
+thread_local BigIntArena* current = nullptr;
+
+} // namespace
+
+// The functions handed to mp_set_memory_functions(), with access to the arena internals.
+struct ArenaHooks {
+    static void* allocate(size_t size) {
+        if (current) {
+            void* p = current->allocate(size);
+            if (p) {
+                // blocks that fall through to the heap are counted by the instrumentation hooks
+                INSTRUMENT_COUNT(GmpAllocations);
+                INSTRUMENT_ADD(GmpAllocatedBytes, size);
+                return p;
+            }
+        }
+        return region->heapAllocate(size);
+    }
+
+    static void* reallocate(void* block, size_t oldSize, size_t newSize) {
+        // values that started on the heap stay there, e.g. long-lived results
+        if (!region->owns(block)) return region->heapReallocate(block, oldSize, newSize);
+        if (current && current->grow(block, oldSize, newSize)) {
+            INSTRUMENT_COUNT(GmpAllocations);
+            INSTRUMENT_ADD(GmpAllocatedBytes, newSize);
+            return block;
+        }
+        void* p = allocate(newSize);
+        std::memcpy(p, block, oldSize < newSize ? oldSize : newSize);
+        region->dropBlock(region->chunkOf(block));
+        return p;
+    }
+
+    static void free(void* block, size_t size) {
+        if (region->owns(block)) {
+            if (current) current->rewind(block, size);
+            region->dropBlock(region->chunkOf(block));
+        } else {
+            region->heapFree(block, size);
+        }
+    }
+
+    static void install() {
+        char* base = nullptr;
+#ifdef ARENA_MMAP
+        void* p = mmap(nullptr, REGION_BYTES, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (p != MAP_FAILED) base = static_cast<char*>(p);
+#endif
+        if (!base) return;
+
+        Region* r = new Region;
+        r->base = base;
+        r->state.reset(new std::atomic<size_t>[CHUNK_COUNT]);
+        for (size_t c = 0; c < CHUNK_COUNT; ++c) r->state[c].store(0, std::memory_order_relaxed);
+        r->fresh = 0;
+        mp_get_memory_functions(&r->heapAllocate, &r->heapReallocate, &r->heapFree);
+        region = r;
+        mp_set_memory_functions(&ArenaHooks::allocate, &ArenaHooks::reallocate, &ArenaHooks::free);
+    }
+};
+
+bool BigIntArena::install() {
+    std::call_once(installOnce, &ArenaHooks::install);
+    return region != nullptr;
+}
+
+BigIntArena::BigIntArena() : previous(current), chunk(CHUNK_COUNT), offset(0), bytes(0) {
+    if (install()) current = this;
+}
+
+BigIntArena::~BigIntArena() {
+    if (!region) return;
+    if (chunk != CHUNK_COUNT) region->close(chunk);
+    current = previous;
+}
+
+void* BigIntArena::allocate(size_t size) {
+    const size_t rounded = roundUp(size);
+    if (rounded > MAX_BLOCK) return nullptr;
+    if (chunk == CHUNK_COUNT || offset + rounded > CHUNK_BYTES) {
+        if (!nextChunk()) return nullptr;
+    }
+    void* p = region->chunkStart(chunk) + offset;
+    offset += rounded;
+    bytes += rounded;
+    region->state[chunk].fetch_add(1, std::memory_order_relaxed);
+    return p;
+}
+
+bool BigIntArena::grow(void* block, size_t oldSize, size_t newSize) {
+    // only the most recent block of the open chunk can be resized in place; a block ending
+    // where the previous, adjacent chunk ends would otherwise match an offset of 0
+    if (chunk == CHUNK_COUNT || region->chunkOf(block) != chunk) return false;
+    char* start = region->chunkStart(chunk);
+    char* end = static_cast<char*>(block) + roundUp(oldSize);
+    if (end != start + offset) return false;
+    const size_t blockOffset = static_cast<char*>(block) - start;
+    const size_t rounded = roundUp(newSize);
+    if (rounded > MAX_BLOCK || blockOffset + rounded > CHUNK_BYTES) return false;
+    bytes += rounded > roundUp(oldSize) ? rounded - roundUp(oldSize) : 0;
+    offset = blockOffset + rounded;
+    return true;
+}
+
+void BigIntArena::rewind(void* block, size_t size) {
+    // temporaries die mostly in reverse order, so the top block is reused right away
+    if (chunk != CHUNK_COUNT && region->chunkOf(block) == chunk &&
+        static_cast<char*>(block) + roundUp(size) == region->chunkStart(chunk) + offset) {
+        offset = static_cast<char*>(block) - region->chunkStart(chunk);
+    }
+}
+
+bool BigIntArena::nextChunk() {
+    size_t c = region->acquire();
+    if (c == CHUNK_COUNT) return false;
+    region->state[c].store(OPEN, std::memory_order_relaxed);
+    if (chunk != CHUNK_COUNT) region->close(chunk);
+    chunk = c;
+    offset = 0;
+    return true;
+}
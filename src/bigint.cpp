@@ -1,6 +1,9 @@
 #include "../include/bigint.hpp"
+#include "../include/instrument.hpp"
+#include <cstring>
 #include <stdexcept>
 #include <iostream>
+#include <utility>
 
 // Default Constructor
 BigInt::BigInt() {
@@ -29,6 +32,12 @@ BigInt::BigInt(const BigInt &other) {
     mpz_init_set(value, other.value);
 }
 
+// Move Constructor: mpz_init does not allocate, so this is a swap
+BigInt::BigInt(BigInt &&other) noexcept {
+    mpz_init(value);
+    mpz_swap(value, other.value);
+}
+
 // Construct from mpz_t
 BigInt::BigInt(mpz_t bi) {
     mpz_init_set(value, bi);
@@ -39,43 +48,113 @@ BigInt::~BigInt() {
     mpz_clear(value);
 }
 
-// Arithmetic Operations
-BigInt BigInt::operator+(const BigInt &other) const {
+// Arithmetic Operations; the rvalue overloads compute in place in a dying operand
+BigInt BigInt::operator+(const BigInt &other) const & {
     BigInt result;
     mpz_add(result.value, value, other.value);
     return result;
 }
 
-BigInt BigInt::operator-(const BigInt &other) const {
+BigInt BigInt::operator+(const BigInt &other) && {
+    mpz_add(value, value, other.value);
+    return std::move(*this);
+}
+
+BigInt BigInt::operator+(BigInt &&other) const & {
+    mpz_add(other.value, value, other.value);
+    return std::move(other);
+}
+
+BigInt BigInt::operator+(BigInt &&other) && {
+    mpz_add(value, value, other.value);
+    return std::move(*this);
+}
+
+BigInt BigInt::operator-(const BigInt &other) const & {
     BigInt result;
     mpz_sub(result.value, value, other.value);
     return result;
 }
 
-BigInt BigInt::operator*(const BigInt &other) const {
+BigInt BigInt::operator-(const BigInt &other) && {
+    mpz_sub(value, value, other.value);
+    return std::move(*this);
+}
+
+BigInt BigInt::operator-(BigInt &&other) const & {
+    mpz_sub(other.value, value, other.value);
+    return std::move(other);
+}
+
+BigInt BigInt::operator-(BigInt &&other) && {
+    mpz_sub(value, value, other.value);
+    return std::move(*this);
+}
+
+BigInt BigInt::operator*(const BigInt &other) const & {
     BigInt result;
+    INSTRUMENT_COUNT(BigIntMul);
     mpz_mul(result.value, value, other.value);
     return result;
 }
 
-BigInt BigInt::operator/(const BigInt &other) const {
+BigInt BigInt::operator*(const BigInt &other) && {
+    INSTRUMENT_COUNT(BigIntMul);
+    mpz_mul(value, value, other.value);
+    return std::move(*this);
+}
+
+BigInt BigInt::operator*(BigInt &&other) const & {
+    INSTRUMENT_COUNT(BigIntMul);
+    mpz_mul(other.value, value, other.value);
+    return std::move(other);
+}
+
+BigInt BigInt::operator*(BigInt &&other) && {
+    INSTRUMENT_COUNT(BigIntMul);
+    mpz_mul(value, value, other.value);
+    return std::move(*this);
+}
+
+BigInt BigInt::operator/(const BigInt &other) const & {
     BigInt result;
     mpz_fdiv_q(result.value, value, other.value);
     return result;
 }
 
-BigInt BigInt::operator%(const BigInt &other) const {
+BigInt BigInt::operator/(const BigInt &other) && {
+    mpz_fdiv_q(value, value, other.value);
+    return std::move(*this);
+}
+
+BigInt BigInt::operator%(const BigInt &other) const & {
     BigInt result;
+    INSTRUMENT_COUNT(BigIntMod);
     mpz_mod(result.value, value, other.value);
     return result;
 }
 
+BigInt BigInt::operator%(const BigInt &other) && {
+    INSTRUMENT_COUNT(BigIntMod);
+    mpz_mod(value, value, other.value);
+    return std::move(*this);
+}
+
 // Assignment Operations
 BigInt& BigInt::operator=(const BigInt &other) {
     mpz_set(value, other.value);
     return *this;
 }
 
+BigInt& BigInt::operator=(BigInt &&other) noexcept {
+    mpz_swap(value, other.value);
+    return *this;
+}
+
+void BigInt::swap(BigInt &other) noexcept {
+    mpz_swap(value, other.value);
+}
+
 BigInt& BigInt::operator+=(const BigInt &other) {
     mpz_add(value, value, other.value);
     return *this;
@@ -87,6 +166,7 @@ BigInt& BigInt::operator-=(const BigInt &other) {
 }
 
 BigInt& BigInt::operator*=(const BigInt &other) {
+    INSTRUMENT_COUNT(BigIntMul);
     mpz_mul(value, value, other.value);
     return *this;
 }
@@ -97,10 +177,56 @@ BigInt& BigInt::operator/=(const BigInt &other) {
 }
 
 BigInt& BigInt::operator%=(const BigInt &other) {
+    INSTRUMENT_COUNT(BigIntMod);
     mpz_mod(value, value, other.value);
     return *this;
 }
 
+BigInt& BigInt::addmul(const BigInt &a, const BigInt &b) {
+    mpz_addmul(value, a.value, b.value);
+    return *this;
+}
+
+BigInt& BigInt::submul(const BigInt &a, const BigInt &b) {
+    mpz_submul(value, a.value, b.value);
+    return *this;
+}
+
+// Modular Operations
+BigInt addMod(const BigInt& a, const BigInt& b, const BigInt& modulus) {
+    BigInt result;
+    mpz_add(result.value, a.value, b.value);
+    if (mpz_cmp(result.value, modulus.value) >= 0) {
+        mpz_sub(result.value, result.value, modulus.value);
+    }
+    // only inputs outside [0, modulus) get here
+    if (mpz_sgn(result.value) < 0 || mpz_cmp(result.value, modulus.value) >= 0) {
+        mpz_mod(result.value, result.value, modulus.value);
+    }
+    return result;
+}
+
+BigInt subMod(const BigInt& a, const BigInt& b, const BigInt& modulus) {
+    BigInt result;
+    mpz_sub(result.value, a.value, b.value);
+    if (mpz_sgn(result.value) < 0) {
+        mpz_add(result.value, result.value, modulus.value);
+    }
+    if (mpz_sgn(result.value) < 0 || mpz_cmp(result.value, modulus.value) >= 0) {
+        mpz_mod(result.value, result.value, modulus.value);
+    }
+    return result;
+}
+
+BigInt mulMod(const BigInt& a, const BigInt& b, const BigInt& modulus) {
+    INSTRUMENT_COUNT(BigIntMul);
+    INSTRUMENT_COUNT(BigIntMod);
+    BigInt result;
+    mpz_mul(result.value, a.value, b.value);
+    mpz_mod(result.value, result.value, modulus.value);
+    return result;
+}
+
 // Comparison Operations
 bool BigInt::operator==(const BigInt &other) const {
     return mpz_cmp(value, other.value) == 0;
@@ -130,7 +256,10 @@ bool BigInt::operator>=(const BigInt &other) const {
 std::string BigInt::toString(int base) const {
     char* str = mpz_get_str(nullptr, base, value);
     std::string result(str);
-    free(str);
+    // GMP may not allocate with malloc, e.g. inside a BigIntArena
+    void (*freeFunction)(void*, size_t);
+    mp_get_memory_functions(nullptr, nullptr, &freeFunction);
+    freeFunction(str, result.size() + 1);
     return result;
 }
 
@@ -152,10 +281,12 @@ void BigInt::negate() {
 }
 
 bool BigInt::invert(const BigInt& modulus) {
+    INSTRUMENT_COUNT(BigIntInvert);
     return mpz_invert(value, value, modulus.value) != 0;
 }
 
 BigInt BigInt::modInverse(const BigInt& modulus) const {
+    INSTRUMENT_COUNT(BigIntInvert);
     BigInt inverse;
     if (mpz_invert(inverse.value, value, modulus.value) != 0) {
         return inverse;
@@ -164,6 +295,56 @@ BigInt BigInt::modInverse(const BigInt& modulus) const {
     }
 }
 
+BigInt BigInt::modPow(const BigInt& exponent, const BigInt& modulus) const {
+    if (mpz_sgn(modulus.value) <= 0) {
+        throw std::invalid_argument("Modulus must be positive.");
+    }
+    BigInt result;
+    if (mpz_sgn(exponent.value) < 0) {
+        BigInt inverse = modInverse(modulus);
+        mpz_neg(result.value, exponent.value);
+        mpz_powm(result.value, inverse.value, result.value, modulus.value);
+        return result;
+    }
+    mpz_powm(result.value, value, exponent.value, modulus.value);
+    return result;
+}
+
+BigInt BigInt::modPowSecure(const BigInt& exponent, const BigInt& modulus) const {
+    if (mpz_sgn(exponent.value) < 0) {
+        throw std::invalid_argument("Exponent must be non-negative.");
+    }
+    if (mpz_sgn(modulus.value) <= 0 || mpz_even_p(modulus.value)) {
+        throw std::invalid_argument("Modulus must be odd and positive.");
+    }
+    BigInt result;
+    if (mpz_sgn(exponent.value) == 0) {
+        // mpz_powm_sec needs a positive exponent
+        mpz_set_ui(result.value, 1);
+        mpz_mod(result.value, result.value, modulus.value);
+        return result;
+    }
+    BigInt base = *this % modulus;
+    mpz_powm_sec(result.value, base.value, exponent.value, modulus.value);
+    return result;
+}
+
+void batchInvert(std::vector<BigInt>& values, const BigInt& modulus) {
+    if (values.empty()) return;
+    std::vector<BigInt> prefix(values.size());
+    BigInt acc(static_cast<unsigned long int>(1));
+    for (size_t i = 0; i < values.size(); ++i) {
+        prefix[i] = acc;
+        acc = mulMod(acc, values[i], modulus);
+    }
+    // Fails exactly when one of the values shares a factor with the modulus.
+    acc = acc.modInverse(modulus);
+    for (size_t i = values.size(); i-- > 0;) {
+        BigInt inverse = mulMod(acc, prefix[i], modulus);
+        acc = mulMod(acc, values[i], modulus);
+        values[i] = std::move(inverse);
+    }
+}
 
 // Primality Testing
 int BigInt::isPrime(int provable) const {
@@ -214,6 +395,39 @@ BigInt BigInt::rightShift(unsigned long int shiftBy) const {
     return result;
 }
 
+bool BigInt::testBit(unsigned long int index) const {
+    return mpz_tstbit(value, index) != 0;
+}
+
+// Limb Conversion
+void BigInt::toLimbs(mp_limb_t* out, size_t n) const {
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = mpz_getlimbn(value, i);
+    }
+}
+
+BigInt BigInt::fromLimbs(const mp_limb_t* limbs, size_t n) {
+    BigInt result;
+    mpz_t view;
+    mpz_set(result.value, mpz_roinit_n(view, limbs, n));
+    return result;
+}
+
+void BigInt::toBytes(unsigned char* out, size_t n) const {
+    if ((mpz_sizeinbase(value, 2) + 7) / 8 > n && mpz_sgn(value) != 0) {
+        throw std::invalid_argument("Value does not fit in the byte count.");
+    }
+    size_t written = 0;
+    mpz_export(out, &written, -1, 1, -1, 0, value);
+    std::memset(out + written, 0, n - written);
+}
+
+BigInt BigInt::fromBytes(const unsigned char* bytes, size_t n) {
+    BigInt result;
+    mpz_import(result.value, n, -1, 1, -1, 0, bytes);
+    return result;
+}
+
 bool BigInt::isNegative() const {
     return mpz_sgn(value) < 0;
 }
@@ -0,0 +1,279 @@
+#include "../include/curves.hpp"
+#include <cstdint>
+#include <cstring>
+
+constexpr mp_limb_t Curve<P256>::P[];
+constexpr mp_limb_t Curve<P256>::A[];
+constexpr mp_limb_t Curve<P256>::B[];
+constexpr mp_limb_t Curve<P256>::GX[];
+constexpr mp_limb_t Curve<P256>::GY[];
+constexpr mp_limb_t Curve<P256>::N[];
+
+constexpr mp_limb_t Curve<Secp256k1>::P[];
+constexpr mp_limb_t Curve<Secp256k1>::A[];
+constexpr mp_limb_t Curve<Secp256k1>::B[];
+constexpr mp_limb_t Curve<Secp256k1>::GX[];
+constexpr mp_limb_t Curve<Secp256k1>::GY[];
+constexpr mp_limb_t Curve<Secp256k1>::N[];
+
+constexpr mp_limb_t Curve<P521>::P[];
+constexpr mp_limb_t Curve<P521>::A[];
+constexpr mp_limb_t Curve<P521>::B[];
+constexpr mp_limb_t Curve<P521>::GX[];
+constexpr mp_limb_t Curve<P521>::GY[];
+constexpr mp_limb_t Curve<P521>::N[];
+
+namespace {
+
+// r -= p if r >= p, without branching on the value.
+void subtractIfNotBelow(mp_limb_t* r, const mp_limb_t* p, size_t n) {
+    mp_limb_t s[9];
+    mp_limb_t mask = static_cast<mp_limb_t>(mpn_sub_n(s, r, p, n)) - 1;
+    for (size_t i = 0; i < n; ++i) r[i] = (s[i] & mask) | (r[i] & ~mask);
+}
+
+// Propagates signed carries through eight 32-bit words and returns the carry out.
+int64_t propagateWords(int64_t* w) {
+    int64_t carry = 0;
+    for (int i = 0; i < 8; ++i) {
+        w[i] += carry;
+        carry = w[i] >> 32;
+        w[i] &= 0xffffffffLL;
+    }
+    return carry;
+}
+
+template <class C>
+typename C::Field::Element elementFromLimbs(const mp_limb_t* limbs) {
+    typename C::Field::Element e;
+    std::memcpy(e.limbs, limbs, sizeof(e.limbs));
+    return e;
+}
+
+template <class C>
+const JacobianCurve<typename C::Field>& makeArithmetic() {
+    static const JacobianCurve<typename C::Field> curve(C::field(), elementFromLimbs<C>(C::A));
+    return curve;
+}
+
+template <class C>
+const ProjectiveCurve<typename C::Field>& makeCompleteArithmetic() {
+    static const ProjectiveCurve<typename C::Field> curve(C::field(), elementFromLimbs<C>(C::A), elementFromLimbs<C>(C::B));
+    return curve;
+}
+
+// r = a^(2^k) * b
+template <class F>
+void squareTimes(const F& field, typename F::Element& r, const typename F::Element& a, unsigned k,
+                 const typename F::Element& b) {
+    r = a;
+    for (unsigned i = 0; i < k; ++i) field.sqr(r, r);
+    field.mul(r, r, b);
+}
+
+// x_k = a^(2^k - 1) along 1, 2, 3, 6, 9, 11, 22, 44, 88, 176, 220, 223, keeping the block lengths 2, 22 and 223
+void secp256k1Blocks(const Curve<Secp256k1>::Field& f, const FieldElement<4>& a, FieldElement<4>& x2,
+                     FieldElement<4>& x22, FieldElement<4>& x223) {
+    FieldElement<4> x3, x6, x9, x11, x44, x88, x176, x220;
+    squareTimes(f, x2, a, 1, a);
+    squareTimes(f, x3, x2, 1, a);
+    squareTimes(f, x6, x3, 3, x3);
+    squareTimes(f, x9, x6, 3, x3);
+    squareTimes(f, x11, x9, 2, x2);
+    squareTimes(f, x22, x11, 11, x11);
+    squareTimes(f, x44, x22, 22, x22);
+    squareTimes(f, x88, x44, 44, x44);
+    squareTimes(f, x176, x88, 88, x88);
+    squareTimes(f, x220, x176, 44, x44);
+    squareTimes(f, x223, x220, 3, x3);
+}
+
+} // namespace
+
+// P-256: NIST Solinas reduction on 32-bit words, see FIPS 186-4 D.2.3
+void Curve<P256>::reduce(mp_limb_t* r, const mp_limb_t* t) {
+    int64_t c[16];
+    for (int i = 0; i < 8; ++i) {
+        c[2 * i] = static_cast<int64_t>(t[i] & 0xffffffffULL);
+        c[2 * i + 1] = static_cast<int64_t>(t[i] >> 32);
+    }
+
+    // s1 + 2 s2 + 2 s3 + s4 + s5 - s6 - s7 - s8 - s9, offset by 5p to stay non-negative
+    const int64_t M = 0xffffffffLL;
+    int64_t w[8];
+    w[0] = c[0] + c[8] + c[9] - c[11] - c[12] - c[13] - c[14] + 5 * M;
+    w[1] = c[1] + c[9] + c[10] - c[12] - c[13] - c[14] - c[15] + 5 * M;
+    w[2] = c[2] + c[10] + c[11] - c[13] - c[14] - c[15] + 5 * M;
+    w[3] = c[3] + 2 * c[11] + 2 * c[12] + c[13] - c[15] - c[8] - c[9];
+    w[4] = c[4] + 2 * c[12] + 2 * c[13] + c[14] - c[9] - c[10];
+    w[5] = c[5] + 2 * c[13] + 2 * c[14] + c[15] - c[10] - c[11];
+    w[6] = c[6] + 3 * c[14] + 2 * c[15] + c[13] - c[8] - c[9] + 5;
+    w[7] = c[7] + 3 * c[15] + c[8] - c[10] - c[11] - c[12] - c[13] + 5 * M;
+
+    // Fold the carry with 2^256 = 2^224 - 2^192 - 2^96 + 1 (mod p); two rounds suffice.
+    int64_t carry = propagateWords(w);
+    for (int round = 0; round < 2; ++round) {
+        w[0] += carry;
+        w[3] -= carry;
+        w[6] -= carry;
+        w[7] += carry;
+        carry = propagateWords(w);
+    }
+
+    for (int i = 0; i < 4; ++i) {
+        r[i] = static_cast<mp_limb_t>(w[2 * i]) | (static_cast<mp_limb_t>(w[2 * i + 1]) << 32);
+    }
+    subtractIfNotBelow(r, P, LIMBS);
+}
+
+// secp256k1: t = hi * 2^256 + lo = lo + hi * (2^32 + 977) (mod p)
+void Curve<Secp256k1>::reduce(mp_limb_t* r, const mp_limb_t* t) {
+    const mp_limb_t c = 0x1000003d1ULL;
+    mp_limb_t m[LIMBS];
+    mp_limb_t top = mpn_mul_1(m, t + LIMBS, LIMBS, c);
+    top += mpn_add_n(r, t, m, LIMBS);
+
+    // top < 2^34, fold it once more; a final wrap leaves r tiny, so adding c cannot carry.
+    mp_limb_t f[2];
+    f[1] = mpn_mul_1(f, &top, 1, c);
+    mp_limb_t cy = mpn_add(r, r, LIMBS, f, 2);
+    mpn_add_1(r, r, LIMBS, cy * c);
+    subtractIfNotBelow(r, P, LIMBS);
+}
+
+// P-521: t = hi * 2^521 + lo = lo + hi (mod p)
+void Curve<P521>::reduce(mp_limb_t* r, const mp_limb_t* t) {
+    mp_limb_t hi[LIMBS + 1];
+    mpn_rshift(hi, t + LIMBS - 1, LIMBS + 1, 9);
+    std::memcpy(r, t, LIMBS * sizeof(mp_limb_t));
+    r[LIMBS - 1] &= 0x1ff;
+    mpn_add_n(r, r, hi, LIMBS);
+
+    // The sum is below 2^522; fold the single bit above 2^521 back in.
+    mp_limb_t top = r[LIMBS - 1] >> 9;
+    r[LIMBS - 1] &= 0x1ff;
+    mpn_add_1(r, r, LIMBS, top);
+    subtractIfNotBelow(r, P, LIMBS);
+}
+
+// x_k = a^(2^k - 1) for k = 2, 4, .., 32, then a^((2^32 - 1) 2^222 + 2^190 + 2^94) by Horner's rule
+void Curve<P256>::sqrtPower(FieldElement<LIMBS>& r, const FieldElement<LIMBS>& a) {
+    const Field& f = field();
+    FieldElement<LIMBS> x = a, t;
+    for (unsigned k = 1; k < 32; k *= 2) {
+        squareTimes(f, t, x, k, x);
+        x = t;
+    }
+    const FieldElement<LIMBS> base = a;
+    squareTimes(f, x, x, 32, base);
+    squareTimes(f, x, x, 96, base);
+    r = x;
+    for (unsigned i = 0; i < 94; ++i) f.sqr(r, r);
+}
+
+// x_k = a^(2^k - 1) for k = 2, 3, 6, 12, 15, 30, 32, then the blocks of p - 2 by Horner's rule
+void Curve<P256>::invPower(FieldElement<LIMBS>& r, const FieldElement<LIMBS>& a) {
+    const Field& f = field();
+    FieldElement<LIMBS> x2, x3, x6, x12, x15, x30, x32, t;
+    const FieldElement<LIMBS> base = a;
+    squareTimes(f, x2, base, 1, base);
+    squareTimes(f, x3, x2, 1, base);
+    squareTimes(f, x6, x3, 3, x3);
+    squareTimes(f, x12, x6, 6, x6);
+    squareTimes(f, x15, x12, 3, x3);
+    squareTimes(f, x30, x15, 15, x15);
+    squareTimes(f, x32, x30, 2, x2);
+    // 32 ones, 31 zeros, 1, 96 zeros, 94 ones, 0, 1
+    squareTimes(f, t, x32, 32, base);
+    squareTimes(f, t, t, 128, x32);
+    squareTimes(f, t, t, 32, x32);
+    squareTimes(f, t, t, 30, x30);
+    squareTimes(f, r, t, 2, base);
+}
+
+// The ones of p - 2 come in blocks of 223, 22, 1, 2 and 1.
+void Curve<Secp256k1>::invPower(FieldElement<LIMBS>& r, const FieldElement<LIMBS>& a) {
+    const Field& f = field();
+    FieldElement<LIMBS> x2, x22, t;
+    const FieldElement<LIMBS> base = a;
+    secp256k1Blocks(f, base, x2, x22, t);
+    squareTimes(f, t, t, 23, x22);
+    squareTimes(f, t, t, 5, base);
+    squareTimes(f, t, t, 3, x2);
+    squareTimes(f, r, t, 2, base);
+}
+
+// The ones of (p + 1) / 4 come in blocks of 223, 22 and 2.
+void Curve<Secp256k1>::sqrtPower(FieldElement<LIMBS>& r, const FieldElement<LIMBS>& a) {
+    const Field& f = field();
+    FieldElement<LIMBS> x2, x22, t;
+    secp256k1Blocks(f, a, x2, x22, t);
+    squareTimes(f, t, t, 23, x22);
+    squareTimes(f, t, t, 6, x2);
+    r = t;
+    f.sqr(r, r);
+    f.sqr(r, r);
+}
+
+// x_k = a^(2^k - 1) along 1, 2, 3, 6, 7, 8, 16, .., 512, 519; p - 2 is 519 ones, 0, 1
+void Curve<P521>::invPower(FieldElement<LIMBS>& r, const FieldElement<LIMBS>& a) {
+    const Field& f = field();
+    FieldElement<LIMBS> x2, x3, x6, x7, x, t;
+    const FieldElement<LIMBS> base = a;
+    squareTimes(f, x2, base, 1, base);
+    squareTimes(f, x3, x2, 1, base);
+    squareTimes(f, x6, x3, 3, x3);
+    squareTimes(f, x7, x6, 1, base);
+    squareTimes(f, x, x7, 1, base);
+    for (unsigned k = 8; k < 512; k *= 2) {
+        squareTimes(f, t, x, k, x);
+        x = t;
+    }
+    squareTimes(f, x, x, 7, x7);
+    squareTimes(f, r, x, 2, base);
+}
+
+void Curve<P521>::sqrtPower(FieldElement<LIMBS>& r, const FieldElement<LIMBS>& a) {
+    const Field& f = field();
+    r = a;
+    for (unsigned i = 0; i < 519; ++i) f.sqr(r, r);
+}
+
+const Curve<P256>::Field& Curve<P256>::field() {
+    static const Field f;
+    return f;
+}
+
+const Curve<Secp256k1>::Field& Curve<Secp256k1>::field() {
+    static const Field f;
+    return f;
+}
+
+const Curve<P521>::Field& Curve<P521>::field() {
+    static const Field f;
+    return f;
+}
+
+const JacobianCurve<Curve<P256>::Field>& Curve<P256>::arithmetic() {
+    return makeArithmetic<Curve<P256> >();
+}
+
+const JacobianCurve<Curve<Secp256k1>::Field>& Curve<Secp256k1>::arithmetic() {
+    return makeArithmetic<Curve<Secp256k1> >();
+}
+
+const JacobianCurve<Curve<P521>::Field>& Curve<P521>::arithmetic() {
+    return makeArithmetic<Curve<P521> >();
+}
+
+const ProjectiveCurve<Curve<P256>::Field>& Curve<P256>::completeArithmetic() {
+    return makeCompleteArithmetic<Curve<P256> >();
+}
+
+const ProjectiveCurve<Curve<Secp256k1>::Field>& Curve<Secp256k1>::completeArithmetic() {
+    return makeCompleteArithmetic<Curve<Secp256k1> >();
+}
+
+const ProjectiveCurve<Curve<P521>::Field>& Curve<P521>::completeArithmetic() {
+    return makeCompleteArithmetic<Curve<P521> >();
+}
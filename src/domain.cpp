@@ -0,0 +1,267 @@
+#include "../include/domain.hpp"
+#include "../include/field.hpp"
+#include "../include/ntt.hpp"
+#include "../include/thread_pool.hpp"
+#include "../include/vecmod.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+// Elements converted per thread pool task around a transform.
+const size_t CONVERT_CHUNK = 1 << 12;
+
+} // namespace
+
+struct EvaluationDomain::Transform {
+    virtual ~Transform() {}
+    virtual void forward(mp_limb_t* values, ThreadPool& pool) const = 0;
+    virtual void inverse(mp_limb_t* values, ThreadPool& pool) const = 0;
+    virtual BigInt root() const = 0;
+};
+
+// The NTT of one width with the coset folded into the Montgomery conversions: entering
+// multiplies by g^i R^2, leaving by g^-i, so the shift costs no extra pass.
+template <size_t N>
+struct EvaluationDomain::FieldTransform : EvaluationDomain::Transform {
+    typedef MontgomeryField<N> Field;
+    typedef typename Field::Element Element;
+
+    Field field;
+    NttDomain<Field> ntt;
+    std::vector<Element> into; ///< g^i R^2 mod p.
+    std::vector<Element> out;  ///< g^-i mod p, canonical.
+
+    FieldTransform(const BigInt& mod, size_t n, const BigInt& shift) : field(mod), ntt(field, n), into(n), out(n) {
+        const Element g = field.fromBigInt(shift);
+        Element gInverse, up = field.one(), down = field.one();
+        field.inv(gInverse, g);
+        for (size_t i = 0; i < n; ++i) {
+            field.toMontgomery(into[i], up);
+            field.fromMontgomery(out[i], down);
+            field.mul(up, up, g);
+            field.mul(down, down, gInverse);
+        }
+    }
+
+    void forward(mp_limb_t* values, ThreadPool& pool) const {
+        const size_t n = into.size();
+        std::vector<Element> a(n);
+        convert(pool, [&](size_t i) {
+            std::memcpy(a[i].limbs, values + i * N, sizeof(a[i].limbs));
+            field.mul(a[i], a[i], into[i]);
+        });
+        ntt.forward(a.data(), &pool);
+        convert(pool, [&](size_t i) {
+            field.fromMontgomery(a[i], a[i]);
+            std::memcpy(values + i * N, a[i].limbs, sizeof(a[i].limbs));
+        });
+    }
+
+    void inverse(mp_limb_t* values, ThreadPool& pool) const {
+        const size_t n = into.size();
+        std::vector<Element> a(n);
+        convert(pool, [&](size_t i) {
+            std::memcpy(a[i].limbs, values + i * N, sizeof(a[i].limbs));
+            field.toMontgomery(a[i], a[i]);
+        });
+        ntt.inverse(a.data(), &pool);
+        convert(pool, [&](size_t i) {
+            field.mul(a[i], a[i], out[i]);
+            std::memcpy(values + i * N, a[i].limbs, sizeof(a[i].limbs));
+        });
+    }
+
+    BigInt root() const { return field.toBigInt(ntt.root()); }
+
+    template <class Body>
+    void convert(ThreadPool& pool, const Body& body) const {
+        const size_t n = into.size();
+        pool.parallelFor((n + CONVERT_CHUNK - 1) / CONVERT_CHUNK, [&](size_t c) {
+            for (size_t i = c * CONVERT_CHUNK; i < std::min((c + 1) * CONVERT_CHUNK, n); ++i) body(i);
+        });
+    }
+};
+
+struct EvaluationDomain::TransformFactory {
+    typedef EvaluationDomain::Transform* result_type;
+    const BigInt& mod;
+    size_t n;
+    const BigInt& shift;
+
+    template <size_t N>
+    result_type run() const {
+        return new FieldTransform<N>(mod, n, shift);
+    }
+};
+
+EvaluationDomain::EvaluationDomain(size_t size, const BigInt& modulus, const BigInt& shift, unsigned threads)
+    : n(size), logN(0), mod(modulus), threads(threads) {
+    if (!nttFriendly(mod, n)) {
+        throw std::invalid_argument("Modulus has no root of unity of the requested order.");
+    }
+    const size_t width = (mod.bitSize() + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS;
+    if (width > MONTGOMERY_MAX_LIMBS) {
+        throw std::invalid_argument("Modulus is too wide for an evaluation domain.");
+    }
+    this->shift = shift % mod;
+    if (this->shift.isZero()) {
+        throw std::invalid_argument("Coset shift must be non-zero.");
+    }
+    while ((static_cast<size_t>(1) << logN) < n) ++logN;
+
+    TransformFactory factory = {mod, n, this->shift};
+    transform.reset(visitMontgomeryField(width, factory));
+    omega = transform->root();
+}
+
+bool EvaluationDomain::operator==(const EvaluationDomain& other) const {
+    return transform == other.transform || (n == other.n && mod == other.mod && shift == other.shift);
+}
+
+void EvaluationDomain::forward(mp_limb_t* values) const {
+    std::unique_ptr<ThreadPool> local;
+    transform->forward(values, selectThreadPool(threads, local));
+}
+
+void EvaluationDomain::inverse(mp_limb_t* values) const {
+    std::unique_ptr<ThreadPool> local;
+    transform->inverse(values, selectThreadPool(threads, local));
+}
+
+DomainPolynomial::DomainPolynomial(const EvaluationDomain& domain, size_t bound)
+    : domain(domain), sizeBound(bound), coeffs(static_cast<size_t>(0), domain.getMod()),
+      hasCoefficients(false), hasEvaluations(false) {}
+
+DomainPolynomial::DomainPolynomial(const Polynomial& poly, const EvaluationDomain& domain)
+    : domain(domain), sizeBound(poly.size()), coeffs(poly), hasCoefficients(true), hasEvaluations(false) {
+    if (poly.getMod() != domain.getMod()) {
+        throw std::invalid_argument("Moduli of the polynomial and the domain must be the same.");
+    }
+    if (poly.size() > domain.size()) {
+        throw std::invalid_argument("Polynomial has more coefficients than the domain has points.");
+    }
+}
+
+DomainPolynomial DomainPolynomial::fromEvaluations(const std::vector<BigInt>& values, const EvaluationDomain& domain) {
+    if (values.size() != domain.size()) {
+        throw std::invalid_argument("The number of values must match the domain size.");
+    }
+    DomainPolynomial poly(domain, domain.size());
+    const size_t width = poly.coeffs.width();
+    poly.evals = LimbBuffer(domain.size() * width);
+    for (size_t i = 0; i < values.size(); ++i) {
+        (values[i] % domain.getMod()).toLimbs(poly.evals.data() + bitReverse(i, domain.logN) * width, width);
+    }
+    poly.hasEvaluations = true;
+    return poly;
+}
+
+void DomainPolynomial::ensureCoefficients() const {
+    if (hasCoefficients) return;
+    const size_t width = coeffs.width();
+    LimbBuffer values(evals);
+    domain.inverse(values.data());
+    Polynomial poly(sizeBound, domain.getMod());
+    std::copy(values.data(), values.data() + sizeBound * width, poly.coefficients().data());
+    coeffs = std::move(poly);
+    hasCoefficients = true;
+}
+
+void DomainPolynomial::ensureEvaluations() const {
+    if (hasEvaluations) return;
+    const size_t width = coeffs.width();
+    LimbBuffer values(domain.size() * width);
+    std::copy(coeffs.coefficients().data(), coeffs.coefficients().data() + coeffs.size() * width, values.data());
+    domain.forward(values.data());
+    evals = std::move(values);
+    hasEvaluations = true;
+}
+
+const Polynomial& DomainPolynomial::coefficients() const {
+    ensureCoefficients();
+    return coeffs;
+}
+
+BigInt DomainPolynomial::evaluation(size_t i) const {
+    ensureEvaluations();
+    const size_t width = coeffs.width();
+    return BigInt::fromLimbs(evals.data() + bitReverse(i, domain.logN) * width, width);
+}
+
+std::vector<BigInt> DomainPolynomial::evaluations() const {
+    ensureEvaluations();
+    const size_t width = coeffs.width();
+    std::vector<BigInt> values;
+    values.reserve(domain.size());
+    for (size_t i = 0; i < domain.size(); ++i) {
+        values.push_back(BigInt::fromLimbs(evals.data() + bitReverse(i, domain.logN) * width, width));
+    }
+    return values;
+}
+
+DomainPolynomial DomainPolynomial::combine(const DomainPolynomial& a, const DomainPolynomial& b, bool subtract) {
+    if (a.domain != b.domain) {
+        throw std::invalid_argument("Domains of the polynomials must be the same.");
+    }
+    DomainPolynomial sum(a.domain, std::max(a.sizeBound, b.sizeBound));
+    if (a.hasCoefficients && b.hasCoefficients && !(a.hasEvaluations && b.hasEvaluations)) {
+        if (subtract) subtractPolynomials(sum.coeffs, a.coeffs, b.coeffs);
+        else addPolynomials(sum.coeffs, a.coeffs, b.coeffs);
+        sum.hasCoefficients = true;
+        return sum;
+    }
+    // at most one operand needs a forward transform, which it keeps for later operations
+    a.ensureEvaluations();
+    b.ensureEvaluations();
+    const VecModulus m(a.domain.getMod());
+    sum.evals = LimbBuffer(a.evals.size());
+    if (subtract) vecSubMod(sum.evals.data(), a.evals.data(), b.evals.data(), a.domain.size(), m);
+    else vecAddMod(sum.evals.data(), a.evals.data(), b.evals.data(), a.domain.size(), m);
+    sum.hasEvaluations = true;
+    return sum;
+}
+
+void addPolynomials(DomainPolynomial &result, const DomainPolynomial &a, const DomainPolynomial &b) {
+    result = DomainPolynomial::combine(a, b, false);
+}
+
+void subtractPolynomials(DomainPolynomial &result, const DomainPolynomial &a, const DomainPolynomial &b) {
+    result = DomainPolynomial::combine(a, b, true);
+}
+
+void multiplyPolynomials(DomainPolynomial &result, const DomainPolynomial &a, const DomainPolynomial &b) {
+    if (a.domain != b.domain) {
+        throw std::invalid_argument("Domains of the polynomials must be the same.");
+    }
+    const size_t bound = a.sizeBound == 0 || b.sizeBound == 0 ? 0 : a.sizeBound + b.sizeBound - 1;
+    if (bound > a.domain.size()) {
+        throw std::invalid_argument("Product has more coefficients than the domain has points.");
+    }
+    a.ensureEvaluations();
+    b.ensureEvaluations();
+    DomainPolynomial product(a.domain, bound);
+    product.evals = LimbBuffer(a.evals.size());
+    vecMulMod(product.evals.data(), a.evals.data(), b.evals.data(), a.domain.size(), VecModulus(a.domain.getMod()));
+    product.hasEvaluations = true;
+    result = std::move(product);
+}
+
+void multiplyPolynomialByScalar(DomainPolynomial &result, const DomainPolynomial &poly, const BigInt &scalar) {
+    DomainPolynomial scaled(poly.domain, poly.sizeBound);
+    if (poly.hasCoefficients) {
+        multiplyPolynomialByScalar(scaled.coeffs, poly.coeffs, scalar);
+        scaled.hasCoefficients = true;
+    }
+    if (poly.hasEvaluations) {
+        const size_t width = poly.coeffs.width();
+        std::vector<mp_limb_t> s(width);
+        (scalar % poly.domain.getMod()).toLimbs(s.data(), width);
+        scaled.evals = LimbBuffer(poly.evals.size());
+        vecMulScalarMod(scaled.evals.data(), poly.evals.data(), s.data(), poly.domain.size(),
+                        VecModulus(poly.domain.getMod()));
+        scaled.hasEvaluations = true;
+    }
+    result = std::move(scaled);
+}
@@ -1,114 +1,801 @@
 #include "../include/bigint.hpp"
 #include "../include/ecc.hpp"
-#include <iostream>
+#include "../include/instrument.hpp"
+#include "../include/msm.hpp"
+#include "../include/scalarmul.hpp"
+#include "../include/thread_pool.hpp"
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/random.h>
+#endif
+
+namespace {
+
+// Builds the BigInt view of a curve from its typed limb constants.
+template <class C>
+CurveParameters curveParameters() {
+    CurveParameters params;
+    params.a = BigInt::fromLimbs(C::A, C::LIMBS);
+    params.b = BigInt::fromLimbs(C::B, C::LIMBS);
+    params.p = BigInt::fromLimbs(C::P, C::LIMBS);
+    params.Gx = BigInt::fromLimbs(C::GX, C::LIMBS);
+    params.Gy = BigInt::fromLimbs(C::GY, C::LIMBS);
+    params.n = BigInt::fromLimbs(C::N, C::LIMBS);
+    return params;
+}
+
+// The point already holds field elements, so both directions are copies of C::LIMBS limbs.
+template <class C>
+AffinePoint<typename C::Field> toField(const Ecc_Point& P) {
+    static_assert(C::LIMBS <= CURVE_MAX_LIMBS, "Ecc_Point coordinates are too narrow for the curve");
+    AffinePoint<typename C::Field> r;
+    r.infinity = P.isInfinity;
+    if (P.isInfinity) {
+        r.x = C::field().zero();
+        r.y = C::field().zero();
+    } else {
+        std::memcpy(r.x.limbs, P.xLimbs(), sizeof(r.x.limbs));
+        std::memcpy(r.y.limbs, P.yLimbs(), sizeof(r.y.limbs));
+    }
+    return r;
+}
+
+template <class C>
+Ecc_Point fromField(const AffinePoint<typename C::Field>& P) {
+    if (P.infinity) return Ecc_Point(C::ID);
+    return Ecc_Point::fromLimbs(P.x.limbs, P.y.limbs, C::ID);
+}
+
+template <class C>
+bool isGenerator(const Ecc_Point& P) {
+    return !P.isInfinity && mpn_cmp(P.xLimbs(), C::GX, C::LIMBS) == 0 && mpn_cmp(P.yLimbs(), C::GY, C::LIMBS) == 0;
+}
+
+// Bytes of one coordinate in a SEC1 encoding.
+template <class C>
+size_t coordinateBytes() {
+    return (C::field().getMod().bitSize() + 7) / 8;
+}
+
+// Writes a canonical element big-endian into bytes bytes.
+template <size_t N>
+void writeBigEndian(unsigned char* out, size_t bytes, const FieldElement<N>& e) {
+    for (size_t i = 0; i < bytes; ++i) {
+        out[bytes - 1 - i] = static_cast<unsigned char>(e.limbs[i / 8] >> (8 * (i % 8)));
+    }
+}
+
+// Reads a big-endian coordinate; false if it is not below p.
+template <class F>
+bool readBigEndian(const F& field, typename F::Element& e, const unsigned char* in, size_t bytes) {
+    std::memset(e.limbs, 0, sizeof(e.limbs));
+    for (size_t i = 0; i < bytes; ++i) {
+        e.limbs[i / 8] |= static_cast<mp_limb_t>(in[bytes - 1 - i]) << (8 * (i % 8));
+    }
+    return mpn_cmp(e.limbs, field.modLimbs(), F::LIMBS) < 0;
+}
+
+// x^3 + ax + b
+template <class C>
+typename C::Field::Element curveRhs(const typename C::Field::Element& x) {
+    const typename C::Field& F = C::field();
+    typename C::Field::Element r, b;
+    std::memcpy(b.limbs, C::B, sizeof(b.limbs));
+    F.sqr(r, x);
+    F.add(r, r, C::arithmetic().a());
+    F.mul(r, r, x);
+    F.add(r, r, b);
+    return r;
+}
+
+// Reads a little-endian coordinate; false if it is not below p.
+template <class F>
+bool readLittleEndian(const F& field, typename F::Element& e, const unsigned char* in, size_t bytes) {
+    std::memset(e.limbs, 0, sizeof(e.limbs));
+    for (size_t i = 0; i < bytes; ++i) {
+        e.limbs[i / 8] |= static_cast<mp_limb_t>(in[i]) << (8 * (i % 8));
+    }
+    return mpn_cmp(e.limbs, field.modLimbs(), F::LIMBS) < 0;
+}
+
+// Decodes a SEC1 encoding; false if it is malformed or off the curve.
+template <class C>
+bool decodePoint(AffinePoint<typename C::Field>& R, const unsigned char* data, size_t size) {
+    const typename C::Field& F = C::field();
+    const size_t bytes = coordinateBytes<C>();
+    if (size == 1 && data[0] == 0) {
+        R.x = F.zero();
+        R.y = F.zero();
+        R.infinity = true;
+        return true;
+    }
+    R.infinity = false;
+    if ((data[0] == 2 || data[0] == 3) && size == 1 + bytes) {
+        if (!readBigEndian(F, R.x, data + 1, bytes) || !F.sqrt(R.y, curveRhs<C>(R.x))) return false;
+        if ((R.y.limbs[0] & 1) != (data[0] & 1)) {
+            if (R.y.isZero()) return false;
+            F.neg(R.y, R.y);
+        }
+        return true;
+    }
+    if (data[0] == 4 && size == 1 + 2 * bytes) {
+        typename C::Field::Element yy;
+        if (!readBigEndian(F, R.x, data + 1, bytes) || !readBigEndian(F, R.y, data + 1 + bytes, bytes)) return false;
+        F.sqr(yy, R.y);
+        return yy == curveRhs<C>(R.x);
+    }
+    return false;
+}
+
+// 2P with lambda = (3x^2 + a) / 2y
+template <class F>
+void affineDouble(const F& field, const typename F::Element& a, AffinePoint<F>& R, const AffinePoint<F>& P) {
+    if (P.infinity || P.y.isZero()) {
+        R.infinity = true;
+        return;
+    }
+    INSTRUMENT_COUNT(PointDouble);
+    typename F::Element num, den, lambda, t, y3;
+    field.sqr(t, P.x);
+    field.add(num, t, t);
+    field.add(num, num, t);
+    field.add(num, num, a);
+    field.add(den, P.y, P.y);
+    field.inv(den, den);
+    field.mul(lambda, num, den);
+
+    field.sqr(t, lambda);
+    field.sub(t, t, P.x);
+    field.sub(t, t, P.x);
+    field.sub(y3, P.x, t);
+    field.mul(y3, y3, lambda);
+    field.sub(R.y, y3, P.y);
+    R.x = t;
+    R.infinity = false;
+}
+
+// P + Q with lambda = (y2 - y1) / (x2 - x1)
+template <class F>
+void affineAdd(const F& field, const typename F::Element& a, AffinePoint<F>& R, const AffinePoint<F>& P, const AffinePoint<F>& Q) {
+    if (P.infinity) { R = Q; return; }
+    if (Q.infinity) { R = P; return; }
+    if (P.x == Q.x) {
+        if (P.y == Q.y) {
+            affineDouble(field, a, R, P);
+        } else {
+            R.infinity = true;
+        }
+        return;
+    }
+    INSTRUMENT_COUNT(PointAdd);
+    typename F::Element num, den, lambda, x3, y3;
+    field.sub(num, Q.y, P.y);
+    field.sub(den, Q.x, P.x);
+    field.inv(den, den);
+    field.mul(lambda, num, den);
+
+    field.sqr(x3, lambda);
+    field.sub(x3, x3, P.x);
+    field.sub(x3, x3, Q.x);
+    field.sub(y3, P.x, x3);
+    field.mul(y3, y3, lambda);
+    field.sub(R.y, y3, P.y);
+    R.x = x3;
+    R.infinity = false;
+}
+
+struct EncodedSizeVisitor {
+    typedef size_t result_type;
+    bool compressed;
+
+    template <class C>
+    size_t run() const { return 1 + (compressed ? 1 : 2) * coordinateBytes<C>(); }
+};
+
+struct EncodeVisitor {
+    typedef std::vector<unsigned char> result_type;
+    const Ecc_Point& P;
+    bool compressed;
+
+    template <class C>
+    std::vector<unsigned char> run() const {
+        if (P.isInfinity) return std::vector<unsigned char>(1, 0);
+        const AffinePoint<typename C::Field> a = toField<C>(P);
+        const size_t bytes = coordinateBytes<C>();
+        std::vector<unsigned char> out(1 + (compressed ? 1 : 2) * bytes);
+        out[0] = compressed ? static_cast<unsigned char>(2 | (a.y.limbs[0] & 1)) : 4;
+        writeBigEndian(&out[1], bytes, a.x);
+        if (!compressed) writeBigEndian(&out[1 + bytes], bytes, a.y);
+        return out;
+    }
+};
+
+struct RawEncodeVisitor {
+    typedef std::vector<unsigned char> result_type;
+    const Ecc_Point& P;
+
+    template <class C>
+    std::vector<unsigned char> run() const {
+        const AffinePoint<typename C::Field> a = toField<C>(P);
+        const size_t bytes = coordinateBytes<C>();
+        std::vector<unsigned char> out(2 * bytes);
+        for (size_t i = 0; i < bytes; ++i) {
+            out[i] = static_cast<unsigned char>(a.x.limbs[i / 8] >> (8 * (i % 8)));
+            out[bytes + i] = static_cast<unsigned char>(a.y.limbs[i / 8] >> (8 * (i % 8)));
+        }
+        return out;
+    }
+};
+
+struct RawDecodeVisitor {
+    typedef Ecc_Point result_type;
+    const unsigned char* data;
+    size_t size;
+
+    template <class C>
+    Ecc_Point run() const {
+        const typename C::Field& F = C::field();
+        const size_t bytes = coordinateBytes<C>();
+        AffinePoint<typename C::Field> a;
+        typename C::Field::Element yy;
+        if (size != 2 * bytes || !readLittleEndian(F, a.x, data, bytes) || !readLittleEndian(F, a.y, data + bytes, bytes)) {
+            throw std::invalid_argument("Invalid raw point encoding.");
+        }
+        if (a.x.isZero() && a.y.isZero()) return Ecc_Point(C::ID);
+        F.sqr(yy, a.y);
+        if (yy != curveRhs<C>(a.x)) {
+            throw std::invalid_argument("Invalid raw point encoding.");
+        }
+        a.infinity = false;
+        return fromField<C>(a);
+    }
+};
+
+struct DecodeVisitor {
+    typedef Ecc_Point result_type;
+    const unsigned char* data;
+    size_t size;
+
+    template <class C>
+    Ecc_Point run() const {
+        AffinePoint<typename C::Field> a;
+        if (size == 0 || !decodePoint<C>(a, data, size)) {
+            throw std::invalid_argument("Invalid point encoding.");
+        }
+        return fromField<C>(a);
+    }
+};
+
+struct DecompressVisitor {
+    typedef std::vector<Ecc_Point> result_type;
+    const std::vector<unsigned char>& data;
+    ThreadPool& pool;
+
+    template <class C>
+    std::vector<Ecc_Point> run() const {
+        const size_t size = 1 + coordinateBytes<C>();
+        if (data.size() % size != 0) {
+            throw std::invalid_argument("Data is not a whole number of compressed points.");
+        }
+        std::vector<Ecc_Point> points(data.size() / size, Ecc_Point(C::ID));
+        pool.parallelFor(points.size(), [&](size_t i) {
+            AffinePoint<typename C::Field> a;
+            const unsigned char* encoding = &data[i * size];
+            if (encoding[0] == 0 || !decodePoint<C>(a, encoding, size)) {
+                throw std::invalid_argument("Invalid point encoding.");
+            }
+            points[i] = fromField<C>(a);
+        });
+        return points;
+    }
+};
+
+struct GeneratorVisitor {
+    typedef Ecc_Point result_type;
+
+    template <class C>
+    Ecc_Point run() const { return Ecc_Point::fromLimbs(C::GX, C::GY, C::ID); }
+};
+
+struct IsGeneratorVisitor {
+    typedef bool result_type;
+    const Ecc_Point& P;
+
+    template <class C>
+    bool run() const { return isGenerator<C>(P); }
+};
+
+struct NegateVisitor {
+    typedef Ecc_Point result_type;
+    const Ecc_Point& P;
+
+    template <class C>
+    Ecc_Point run() const {
+        AffinePoint<typename C::Field> r = toField<C>(P);
+        C::field().neg(r.y, r.y);
+        return fromField<C>(r);
+    }
+};
+
+struct AddVisitor {
+    typedef Ecc_Point result_type;
+    const Ecc_Point& P;
+    const Ecc_Point& Q;
+
+    template <class C>
+    Ecc_Point run() const {
+        AffinePoint<typename C::Field> r;
+        affineAdd(C::field(), C::arithmetic().a(), r, toField<C>(P), toField<C>(Q));
+        return fromField<C>(r);
+    }
+};
+
+struct DoubleVisitor {
+    typedef Ecc_Point result_type;
+    const Ecc_Point& P;
+
+    template <class C>
+    Ecc_Point run() const {
+        AffinePoint<typename C::Field> r;
+        affineDouble(C::field(), C::arithmetic().a(), r, toField<C>(P));
+        return fromField<C>(r);
+    }
+};
+
+// Width-w NAF in Jacobian coordinates: the only inversions are the one that
+// normalizes the odd-multiples table and the final conversion back to affine.
+struct ScalarMulVisitor {
+    typedef Ecc_Point result_type;
+    const Ecc_Point& P;
+    const BigInt& k;
+    unsigned width;
+
+    template <class C>
+    Ecc_Point run() const {
+        const JacobianCurve<typename C::Field>& curve = C::arithmetic();
+        std::vector<mp_limb_t> limbs((k.bitSize() + 63) / 64);
+        k.toLimbs(limbs.data(), limbs.size());
+
+        JacobianPoint<typename C::Field> result;
+        wnafMultiply(curve, result, toField<C>(P), limbs.data(), limbs.size(), width);
+
+        AffinePoint<typename C::Field> affine;
+        curve.toAffine(affine, result);
+        return fromField<C>(affine);
+    }
+};
+
+// Scalar reduced mod n into exactly LIMBS limbs, so the constant-time loops have a fixed length.
+template <class C>
+std::vector<mp_limb_t> fixedWidthScalar(const BigInt& k) {
+    std::vector<mp_limb_t> limbs(C::LIMBS);
+    (k % CurveContext::instance(C::ID).params().n).toLimbs(limbs.data(), limbs.size());
+    return limbs;
+}
+
+// Montgomery ladder over the complete projective formulas, bits(n) steps for every scalar.
+struct LadderMulVisitor {
+    typedef Ecc_Point result_type;
+    const Ecc_Point& P;
+    const BigInt& k;
+
+    template <class C>
+    Ecc_Point run() const {
+        const std::vector<mp_limb_t> limbs = fixedWidthScalar<C>(k);
+        ProjectivePoint<typename C::Field> result;
+        ladderMultiply(C::completeArithmetic(), result, toField<C>(P), limbs.data(), limbs.size(),
+                       CurveContext::instance(C::ID).params().n.bitSize());
+
+        AffinePoint<typename C::Field> affine;
+        C::completeArithmetic().toAffine(affine, result);
+        return fromField<C>(affine);
+    }
+};
+
+// Fixed-base table of the generator, built once per curve on first use.
+template <class C>
+const FixedBaseTable<typename C::Field>& generatorTable() {
+    static const FixedBaseTable<typename C::Field> table(
+        C::arithmetic(), toField<C>(Ecc_Point::generator(C::ID)), CurveContext::instance(C::ID).params().n.bitSize());
+    return table;
+}
+
+// G * k from the precomputed generator table: additions only, no doublings.
+struct GeneratorMulVisitor {
+    typedef Ecc_Point result_type;
+    const BigInt& k;
+
+    template <class C>
+    Ecc_Point run() const {
+        const BigInt reduced = k % CurveContext::instance(C::ID).params().n;
+        std::vector<mp_limb_t> limbs((reduced.bitSize() + 63) / 64);
+        reduced.toLimbs(limbs.data(), limbs.size());
+
+        JacobianPoint<typename C::Field> result;
+        generatorTable<C>().multiply(result, limbs.data(), limbs.size());
+
+        AffinePoint<typename C::Field> affine;
+        C::arithmetic().toAffine(affine, result);
+        return fromField<C>(affine);
+    }
+};
+
+// G * k scanning every row of the generator table in full.
+struct ConstantTimeGeneratorMulVisitor {
+    typedef Ecc_Point result_type;
+    const BigInt& k;
+
+    template <class C>
+    Ecc_Point run() const {
+        const std::vector<mp_limb_t> limbs = fixedWidthScalar<C>(k);
+        ProjectivePoint<typename C::Field> result;
+        generatorTable<C>().multiplyConstantTime(C::completeArithmetic(), result, limbs.data(), limbs.size());
+
+        AffinePoint<typename C::Field> affine;
+        C::completeArithmetic().toAffine(affine, result);
+        return fromField<C>(affine);
+    }
+};
+
+// Width of the precomputed odd multiples of the generator used by doubleScalarMul().
+const unsigned GENERATOR_WNAF_WIDTH = 8;
+
+// Odd multiples G, 3G, ..., 127G, built once per curve on first use.
+template <class C>
+const std::vector<AffinePoint<typename C::Field> >& generatorOddMultiples() {
+    static const std::vector<AffinePoint<typename C::Field> > table =
+        oddMultiples(C::arithmetic(), toField<C>(Ecc_Point::generator(C::ID)), GENERATOR_WNAF_WIDTH);
+    return table;
+}
+
+// k1 * P1 + k2 * P2 with interleaved wNAF; the generator takes its wide cached table.
+struct DoubleMulVisitor {
+    typedef Ecc_Point result_type;
+    const BigInt* k[2];
+    const Ecc_Point* P[2];
+
+    template <class C>
+    Ecc_Point run() const {
+        const JacobianCurve<typename C::Field>& curve = C::arithmetic();
+        const CurveParameters& params = CurveContext::instance(C::ID).params();
+        std::vector<AffinePoint<typename C::Field> > built[2];
+        const AffinePoint<typename C::Field>* tables[2];
+        std::vector<int> digits[2];
+        for (int t = 0; t < 2; ++t) {
+            const bool generator = isGenerator<C>(*P[t]);
+            const unsigned width = generator ? GENERATOR_WNAF_WIDTH : WNAF_DEFAULT_WIDTH;
+            std::vector<mp_limb_t> limbs(C::LIMBS);
+            (*k[t] % params.n).toLimbs(limbs.data(), limbs.size());
+            digits[t] = wnafRecode(limbs.data(), limbs.size(), width);
+            if (generator) {
+                tables[t] = generatorOddMultiples<C>().data();
+            } else {
+                built[t] = oddMultiples(curve, toField<C>(*P[t]), width);
+                tables[t] = built[t].data();
+            }
+        }
+
+        JacobianPoint<typename C::Field> result;
+        strausMultiply(curve, result, tables, digits, 2);
+
+        AffinePoint<typename C::Field> affine;
+        curve.toAffine(affine, result);
+        return fromField<C>(affine);
+    }
+};
+
+// Pippenger over the affine points with every scalar reduced mod n into LIMBS limbs.
+struct MsmVisitor {
+    typedef Ecc_Point result_type;
+    const std::vector<Ecc_Point>& points;
+    const std::vector<BigInt>& scalars;
+    ThreadPool& pool;
+
+    template <class C>
+    Ecc_Point run() const {
+        const BigInt& n = CurveContext::instance(C::ID).params().n;
+        const size_t count = points.size();
+        std::vector<AffinePoint<typename C::Field> > affine(count);
+        std::vector<mp_limb_t> limbs(count * C::LIMBS);
+
+        // Points at infinity and zero scalars need no special casing: both contribute nothing.
+        pool.parallelFor(count, [&](size_t i) {
+            affine[i] = toField<C>(points[i]);
+            (scalars[i] % n).toLimbs(&limbs[i * C::LIMBS], C::LIMBS);
+        });
+
+        JacobianPoint<typename C::Field> result;
+        pippengerMsm(C::arithmetic(), result, affine.data(), limbs.data(), count, C::LIMBS, n.bitSize(), 0, &pool);
+
+        AffinePoint<typename C::Field> r;
+        C::arithmetic().toAffine(r, result);
+        return fromField<C>(r);
+    }
+};
+
+struct BatchAddVisitor {
+    typedef void result_type;
+    const std::vector<Ecc_Point>& a;
+    const std::vector<Ecc_Point>& b;
+    std::vector<Ecc_Point>& out;
+
+    template <class C>
+    void run() const {
+        const size_t n = a.size();
+        std::vector<AffinePoint<typename C::Field> > P(n), Q(n);
+        for (size_t i = 0; i < n; ++i) {
+            P[i] = toField<C>(a[i]);
+            Q[i] = toField<C>(b[i]);
+        }
+        C::arithmetic().batchAdd(P.data(), P.data(), Q.data(), n);
+
+        std::vector<Ecc_Point> sums;
+        sums.reserve(n);
+        for (size_t i = 0; i < n; ++i) sums.push_back(fromField<C>(P[i]));
+        out.swap(sums);
+    }
+};
+
+// Limbs from the operating system's cryptographic random source, which a caller cannot predict.
+void secureRandomLimbs(mp_limb_t* limbs, size_t count) {
+#ifdef __linux__
+    char* p = reinterpret_cast<char*>(limbs);
+    size_t left = count * sizeof(mp_limb_t);
+    while (left > 0) {
+        const ssize_t got = getrandom(p, left, 0);
+        if (got < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error("Failed to read random bytes from the operating system.");
+        }
+        p += got;
+        left -= static_cast<size_t>(got);
+    }
+#else
+    // one draw per 32 bits of every limb
+    std::random_device device;
+    for (size_t i = 0; i < count; ++i) {
+        limbs[i] = 0;
+        for (size_t shift = 0; shift < sizeof(mp_limb_t) * 8; shift += 32) {
+            limbs[i] |= static_cast<mp_limb_t>(device()) << shift;
+        }
+    }
+#endif
+}
+
+} // namespace
+
+const CurveContext& CurveContext::instance(CurveId id) {
+    switch (id) {
+        case CurveId::P256: {
+            static const CurveContext context(id, curveParameters<Curve<P256> >(), Curve<P256>::LIMBS);
+            return context;
+        }
+        case CurveId::Secp256k1: {
+            static const CurveContext context(id, curveParameters<Curve<Secp256k1> >(), Curve<Secp256k1>::LIMBS);
+            return context;
+        }
+        case CurveId::P521: {
+            static const CurveContext context(id, curveParameters<Curve<P521> >(), Curve<P521>::LIMBS);
+            return context;
+        }
+    }
+    throw std::invalid_argument("Unsupported elliptic curve.");
+}
+
+Ecc_Point::Ecc_Point(const BigInt& x, const BigInt& y, CurveId id)
+    : isInfinity(false), curve(&CurveContext::instance(id)), xField(), yField() {
+    setX(x);
+    setY(y);
+}
+
+void Ecc_Point::setX(const BigInt& x) {
+    (x % curve->params().p).toLimbs(xField, curve->limbs());
+}
+
+void Ecc_Point::setY(const BigInt& y) {
+    (y % curve->params().p).toLimbs(yField, curve->limbs());
+}
+
+Ecc_Point Ecc_Point::generator(CurveId id) {
+    GeneratorVisitor visitor;
+    return visitCurve(id, visitor);
+}
+
+size_t Ecc_Point::encodedSize(CurveId id, bool compressed) {
+    EncodedSizeVisitor visitor = {compressed};
+    return visitCurve(id, visitor);
+}
+
+std::vector<unsigned char> Ecc_Point::toBytes(bool compressed) const {
+    EncodeVisitor visitor = {*this, compressed};
+    return visitCurve(curve->id(), visitor);
+}
+
+Ecc_Point Ecc_Point::fromBytes(const unsigned char* data, size_t size, CurveId id) {
+    DecodeVisitor visitor = {data, size};
+    return visitCurve(id, visitor);
+}
+
+size_t Ecc_Point::rawSize(CurveId id) {
+    EncodedSizeVisitor visitor = {false};
+    return visitCurve(id, visitor) - 1;
+}
+
+std::vector<unsigned char> Ecc_Point::toRawBytes() const {
+    RawEncodeVisitor visitor = {*this};
+    return visitCurve(curve->id(), visitor);
+}
+
+Ecc_Point Ecc_Point::fromRawBytes(const unsigned char* data, size_t size, CurveId id) {
+    RawDecodeVisitor visitor = {data, size};
+    return visitCurve(id, visitor);
+}
 
 Ecc_Point Ecc_Point::operator+(const Ecc_Point& other) const {
     if (this->isInfinity) return other;
     if (other.isInfinity) return *this;
-    if (*this == -other) return Ecc_Point();
-
-    if (*this == other) {
-        return this->doublePoint();
+    if (curve != other.curve) {
+        throw std::invalid_argument("Points belong to different curves.");
     }
-    BigInt lambda = (other.yCoord - yCoord) * ((other.xCoord - xCoord).modInverse(curveParams.p));
-    BigInt x3 = (lambda * lambda - xCoord - other.xCoord) % curveParams.p;
-    BigInt y3 = (lambda * (xCoord - x3) - yCoord) % curveParams.p;
 
-    return Ecc_Point(x3, y3);
+    AddVisitor visitor = {*this, other};
+    return visitCurve(curve->id(), visitor);
 }
 
 
 Ecc_Point Ecc_Point::operator-() const {
     if (this->isInfinity) return *this;
-    return Ecc_Point(xCoord, curveParams.p - yCoord);
+    NegateVisitor visitor = {*this};
+    return visitCurve(curve->id(), visitor);
 }
 
 
 Ecc_Point Ecc_Point::operator*(const BigInt& scalar) const {
-if (scalar.isZero() || this->isInfinity) {
-    return Ecc_Point();
+    INSTRUMENT_PHASE(ScalarMul);
+    IsGeneratorVisitor visitor = {*this};
+    if (visitCurve(curve->id(), visitor)) {
+        return multiplyGenerator(scalar, curve->id());
+    }
+    return multiply(scalar, WNAF_DEFAULT_WIDTH);
 }
-    Ecc_Point result;
-    Ecc_Point point = *this;
 
-    BigInt k = scalar;
-    while (k > BigInt(static_cast<unsigned long int>(0))) {
-        if (k % BigInt(static_cast<unsigned long int>(2)) != BigInt(static_cast<unsigned long int>(0))) {
-            result = result + point;
-        }
-        point = point.doublePoint();
-        k /= BigInt(static_cast<unsigned long int>(2));
+
+Ecc_Point Ecc_Point::multiplyGenerator(const BigInt& scalar, CurveId id, ScalarMulMode mode) {
+    if (scalar.isNegative()) {
+        return Ecc_Point(id);
+    }
+    if (mode == ScalarMulMode::ConstantTime) {
+        ConstantTimeGeneratorMulVisitor visitor = {scalar};
+        return visitCurve(id, visitor);
+    }
+    if (scalar.isZero()) {
+        return Ecc_Point(id);
     }
-    return result;
+    GeneratorMulVisitor visitor = {scalar};
+    return visitCurve(id, visitor);
+}
+
+
+Ecc_Point Ecc_Point::multiply(const BigInt& scalar, unsigned windowWidth) const {
+    if (scalar.isZero() || scalar.isNegative() || this->isInfinity) {
+        return Ecc_Point(curve->id());
+    }
+    ScalarMulVisitor visitor = {*this, scalar, windowWidth};
+    return visitCurve(curve->id(), visitor);
+}
+
+
+Ecc_Point Ecc_Point::multiply(const BigInt& scalar, ScalarMulMode mode) const {
+    if (mode == ScalarMulMode::Fast) {
+        return *this * scalar;
+    }
+    if (scalar.isNegative()) {
+        return Ecc_Point(curve->id());
+    }
+    LadderMulVisitor visitor = {*this, scalar};
+    return visitCurve(curve->id(), visitor);
 }
 
 
 bool Ecc_Point::operator==(const Ecc_Point& other) const {
+    if (curve != other.curve) return false;
     if (isInfinity && other.isInfinity) return true;
     if (isInfinity || other.isInfinity) return false;
-    return (xCoord == other.xCoord) && (yCoord == other.yCoord);
+    const size_t n = curve->limbs();
+    return mpn_cmp(xField, other.xField, n) == 0 && mpn_cmp(yField, other.yField, n) == 0;
 }
 
 Ecc_Point Ecc_Point::doublePoint() const {
-    if (this->isInfinity || yCoord.isZero()) {
-        return Ecc_Point();
+    if (this->isInfinity || mpn_zero_p(yField, curve->limbs())) {
+        return Ecc_Point(curve->id());
     }
 
-    BigInt lambda = (BigInt(static_cast<unsigned long int>(3)) * xCoord * xCoord + curveParams.a) * 
-                    (BigInt(static_cast<unsigned long int>(2)) * yCoord).modInverse(curveParams.p);
-    BigInt x3 = (lambda * lambda - BigInt(static_cast<unsigned long int>(2)) * xCoord) % curveParams.p;
-    BigInt y3 = (lambda * (xCoord - x3) - yCoord) % curveParams.p;
-
-    return Ecc_Point(x3, y3);
+    DoubleVisitor visitor = {*this};
+    return visitCurve(curve->id(), visitor);
 }
 
-int main() {
-    Ecc_Point G;
-    G=Ecc_Point(BigInt("6b17d1f2e12c4247f8bce6e563a440f277037d812deb33a0f4a13945d898c296",16),BigInt("4fe342e2fe1a7f9b8ee7eb4a7c0f9e162bce33576b315ececbb6406837bf51f5",16));
-
-    // std::cout << "Prime p = " << G.getP().toString(16) << std::endl;
-    // std::cout << "x = " << G.getX().toString(16) << std::endl;
-    // std::cout << "y = " << G.getY().toString(16) << std::endl;
-
-    // Test vector for Point Addition
-    // Let's add G to itself and compare with 2*G
-    Ecc_Point pointAdditionResult = G + G;
-    // Output the results of Point Addition
-    std::cout << "Point Addition Result:" << std::endl;
-    std::cout << "x = " << pointAdditionResult.getX().toString(16) << std::endl;
-    std::cout << "y = " << pointAdditionResult.getY().toString(16) << std::endl;
-
-    Ecc_Point G1;
-    G1=Ecc_Point(BigInt("6b17d1f2e12c4247f8bce6e563a440f277037d812deb33a0f4a13945d898c296",16),BigInt("4fe342e2fe1a7f9b8ee7eb4a7c0f9e162bce33576b315ececbb6406837bf51f5",16));
+Ecc_Point multiScalarMul(const std::vector<Ecc_Point>& points, const std::vector<BigInt>& scalars, unsigned threads) {
+    if (points.size() != scalars.size()) {
+        throw std::invalid_argument("Number of points and scalars must match.");
+    }
+    if (points.empty()) return Ecc_Point();
+    const CurveContext& curve = points[0].getCurve();
+    for (size_t i = 1; i < points.size(); ++i) {
+        if (&points[i].getCurve() != &curve) {
+            throw std::invalid_argument("Points belong to different curves.");
+        }
+    }
 
-    Ecc_Point expectedAdditionResult = G1 * BigInt(static_cast<unsigned long int>(2));
-    std::cout << "Scalar Multiplication Result:" << std::endl;
-    std::cout << "x = " << expectedAdditionResult.getX().toString(16) << std::endl;
-    std::cout << "y = " << expectedAdditionResult.getY().toString(16) << std::endl;
+    std::unique_ptr<ThreadPool> local;
+    MsmVisitor visitor = {points, scalars, selectThreadPool(threads, local)};
+    return visitCurve(curve.id(), visitor);
+}
 
+Ecc_Point doubleScalarMul(const BigInt& k1, const Ecc_Point& P1, const BigInt& k2, const Ecc_Point& P2) {
+    if (&P1.getCurve() != &P2.getCurve()) {
+        throw std::invalid_argument("Points belong to different curves.");
+    }
+    DoubleMulVisitor visitor = {{&k1, &k2}, {&P1, &P2}};
+    return visitCurve(P1.getCurve().id(), visitor);
+}
 
-    // Comparing and output the test result for Point Addition
-    bool isAdditionCorrect = pointAdditionResult == expectedAdditionResult;
-    std::cout << "Point Addition Test " << (isAdditionCorrect ? "PASSED" : "FAILED") << std::endl;
+bool batchVerify(const std::vector<SignatureCheck>& checks, unsigned threads) {
+    if (checks.empty()) return true;
+    const CurveId id = checks[0].Q.getCurve().id();
+    const BigInt& n = CurveContext::instance(id).params().n;
+    const size_t count = checks.size();
 
+    // the weights must be unpredictable to whoever chose the checks, so every one is fresh OS randomness
+    std::vector<mp_limb_t> weights(2 * count);
+    secureRandomLimbs(weights.data(), weights.size());
 
-    // Test vector for Scalar Multiplication
-    // Scalar value k = 3
-    // G.print();
-    Ecc_Point scalarMultiplicationResult = G * BigInt(static_cast<unsigned long int>(3));
-    // Expected values for 3*G (you can compute this using an external ECC calculator or library)
-    std::string expected_x_str = "5ecbe4d1a6330a44c8f7ef951d4bf165e6c6b721efada985fb41661bc6e7fd6c";
-    std::string expected_y_str = "8734640c4998ff7e374b06ce1a64a2ecd82ab036384fb83d9a79b127a27d5032";
+    // points G, Q_i and R_i with scalars sum z_i u1_i, z_i u2_i and n - z_i
+    std::vector<Ecc_Point> points;
+    std::vector<BigInt> scalars;
+    points.reserve(2 * count + 1);
+    scalars.reserve(2 * count + 1);
+    points.push_back(Ecc_Point::generator(id));
+    scalars.push_back(BigInt());
+    for (size_t i = 0; i < count; ++i) {
+        const mp_limb_t limbs[2] = {weights[2 * i] | 1, weights[2 * i + 1]};
+        const BigInt z = BigInt::fromLimbs(limbs, 2);
+        scalars[0].addmul(z, checks[i].u1);
+        points.push_back(checks[i].Q);
+        scalars.push_back(mulMod(z, checks[i].u2, n));
+        points.push_back(checks[i].R);
+        scalars.push_back(n - z);
+    }
+    scalars[0] %= n;
+    return multiScalarMul(points, scalars, threads).isInfinity;
+}
 
-    // Output of the results of Scalar Multiplication
-    std::cout << "Scalar Multiplication Result:" << std::endl;
-    std::cout << "x = " << scalarMultiplicationResult.getX().toString(16) << std::endl;
-    std::cout << "y = " << scalarMultiplicationResult.getY().toString(16) << std::endl;
+std::vector<Ecc_Point> decompressPoints(const std::vector<unsigned char>& data, CurveId id, unsigned threads) {
+    std::unique_ptr<ThreadPool> local;
+    DecompressVisitor visitor = {data, selectThreadPool(threads, local)};
+    return visitCurve(id, visitor);
+}
 
-    // Comparing and output the test result for Scalar Multiplication
-    bool isMultiplicationCorrect = (scalarMultiplicationResult.getX().toString(16) == expected_x_str) &&
-                                   (scalarMultiplicationResult.getY().toString(16) == expected_y_str);
-    std::cout << "Scalar Multiplication Test " << (isMultiplicationCorrect ? "PASSED" : "FAILED") << std::endl;
+void batchAdd(const std::vector<Ecc_Point>& a, const std::vector<Ecc_Point>& b, std::vector<Ecc_Point>& out) {
+    if (a.size() != b.size()) {
+        throw std::invalid_argument("Batches to add must have the same size.");
+    }
+    if (a.empty()) {
+        out.clear();
+        return;
+    }
+    const CurveContext& curve = a[0].getCurve();
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (&a[i].getCurve() != &curve || &b[i].getCurve() != &curve) {
+            throw std::invalid_argument("Points belong to different curves.");
+        }
+    }
 
-    return 0;
-}
\ No newline at end of file
+    BatchAddVisitor visitor = {a, b, out};
+    visitCurve(curve.id(), visitor);
+}
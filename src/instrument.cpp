@@ -0,0 +1,207 @@
+#include "../include/instrument.hpp"
+#include <gmp.h>
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+// The live thread blocks and the totals of the threads that have exited. Never
+// destroyed, so threads may still exit during static destruction.
+struct Registry {
+    std::mutex mutex;
+    std::vector<ThreadInstrumentation*> live;
+    InstrumentationSnapshot retired;
+
+    Registry() { std::memset(&retired, 0, sizeof(retired)); }
+};
+
+Registry& registry() {
+    static Registry* r = new Registry;
+    return *r;
+}
+
+void* (*heapAllocate)(size_t) = nullptr;
+void* (*heapReallocate)(void*, size_t, size_t) = nullptr;
+void (*heapFree)(void*, size_t) = nullptr;
+
+void* countingAllocate(size_t size) {
+    ThreadInstrumentation& block = ThreadInstrumentation::local();
+    block.add(Counter::GmpAllocations, 1);
+    block.add(Counter::GmpAllocatedBytes, size);
+    return heapAllocate(size);
+}
+
+void* countingReallocate(void* p, size_t oldSize, size_t newSize) {
+    ThreadInstrumentation& block = ThreadInstrumentation::local();
+    block.add(Counter::GmpAllocations, 1);
+    block.add(Counter::GmpAllocatedBytes, newSize);
+    return heapReallocate(p, oldSize, newSize);
+}
+
+void countingFree(void* p, size_t size) { heapFree(p, size); }
+
+void zero(std::atomic<uint64_t>* values, size_t n) {
+    for (size_t i = 0; i < n; ++i) values[i].store(0, std::memory_order_relaxed);
+}
+
+#ifdef ZKSNARKS_INSTRUMENTATION
+// Installs the GMP hooks before main() and prints the report after it.
+struct ReportAtExit {
+    ReportAtExit() { Instrumentation::installGmpHooks(); }
+    ~ReportAtExit() { Instrumentation::report(std::cerr); }
+};
+
+const ReportAtExit reportAtExit;
+#endif
+
+} // namespace
+
+ThreadInstrumentation::ThreadInstrumentation() {
+    zero(counters, COUNTER_COUNT);
+    zero(phaseCalls, PHASE_COUNT);
+    zero(phaseNanoseconds, PHASE_COUNT);
+    for (size_t p = 0; p < PHASE_COUNT; ++p) {
+        zero(phaseCounters[p], COUNTER_COUNT);
+        depth[p] = 0;
+    }
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.live.push_back(this);
+}
+
+ThreadInstrumentation::~ThreadInstrumentation() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (size_t c = 0; c < COUNTER_COUNT; ++c) r.retired.counters[c] += counters[c].load(std::memory_order_relaxed);
+    for (size_t p = 0; p < PHASE_COUNT; ++p) {
+        PhaseStats& stats = r.retired.phases[p];
+        stats.calls += phaseCalls[p].load(std::memory_order_relaxed);
+        stats.nanoseconds += phaseNanoseconds[p].load(std::memory_order_relaxed);
+        for (size_t c = 0; c < COUNTER_COUNT; ++c) stats.counters[c] += phaseCounters[p][c].load(std::memory_order_relaxed);
+    }
+    r.live.erase(std::find(r.live.begin(), r.live.end(), this));
+}
+
+ScopedPhaseTimer::ScopedPhaseTimer(Phase phase)
+    : block(ThreadInstrumentation::local()), index(static_cast<size_t>(phase)), outermost(block.depth[index]++ == 0) {
+    if (!outermost) return;
+    for (size_t c = 0; c < COUNTER_COUNT; ++c) startCounters[c] = block.counters[c].load(std::memory_order_relaxed);
+    start = std::chrono::steady_clock::now();
+}
+
+ScopedPhaseTimer::~ScopedPhaseTimer() {
+    --block.depth[index];
+    if (!outermost) return;
+    const uint64_t elapsed = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    std::atomic<uint64_t>& ns = block.phaseNanoseconds[index];
+    ns.store(ns.load(std::memory_order_relaxed) + elapsed, std::memory_order_relaxed);
+    std::atomic<uint64_t>& calls = block.phaseCalls[index];
+    calls.store(calls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    for (size_t c = 0; c < COUNTER_COUNT; ++c) {
+        const uint64_t delta = block.counters[c].load(std::memory_order_relaxed) - startCounters[c];
+        std::atomic<uint64_t>& v = block.phaseCounters[index][c];
+        v.store(v.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    }
+}
+
+bool Instrumentation::enabled() {
+#ifdef ZKSNARKS_INSTRUMENTATION
+    return true;
+#else
+    return false;
+#endif
+}
+
+InstrumentationSnapshot Instrumentation::snapshot() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    InstrumentationSnapshot total = r.retired;
+    for (const ThreadInstrumentation* block : r.live) {
+        for (size_t c = 0; c < COUNTER_COUNT; ++c) total.counters[c] += block->counters[c].load(std::memory_order_relaxed);
+        for (size_t p = 0; p < PHASE_COUNT; ++p) {
+            PhaseStats& stats = total.phases[p];
+            stats.calls += block->phaseCalls[p].load(std::memory_order_relaxed);
+            stats.nanoseconds += block->phaseNanoseconds[p].load(std::memory_order_relaxed);
+            for (size_t c = 0; c < COUNTER_COUNT; ++c) {
+                stats.counters[c] += block->phaseCounters[p][c].load(std::memory_order_relaxed);
+            }
+        }
+    }
+    return total;
+}
+
+void Instrumentation::reset() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    std::memset(&r.retired, 0, sizeof(r.retired));
+    for (ThreadInstrumentation* block : r.live) {
+        zero(block->counters, COUNTER_COUNT);
+        zero(block->phaseCalls, PHASE_COUNT);
+        zero(block->phaseNanoseconds, PHASE_COUNT);
+        for (size_t p = 0; p < PHASE_COUNT; ++p) zero(block->phaseCounters[p], COUNTER_COUNT);
+    }
+}
+
+void Instrumentation::report(std::ostream& os) {
+    const InstrumentationSnapshot s = snapshot();
+    if (!enabled()) {
+        os << "instrumentation: disabled, build with ZKSNARKS_INSTRUMENTATION" << std::endl;
+        return;
+    }
+    os << "instrumentation: counters over all threads" << std::endl;
+    for (size_t c = 0; c < COUNTER_COUNT; ++c) {
+        os << "  " << std::left << std::setw(20) << name(static_cast<Counter>(c)) << std::right << std::setw(16)
+           << s.counters[c] << std::endl;
+    }
+    os << "instrumentation: phases, counters of the entering thread" << std::endl;
+    for (size_t p = 0; p < PHASE_COUNT; ++p) {
+        const PhaseStats& stats = s.phases[p];
+        if (stats.calls == 0) continue;
+        os << "  " << std::left << std::setw(20) << name(static_cast<Phase>(p)) << std::right << std::setw(10)
+           << stats.calls << " calls " << std::fixed << std::setprecision(3) << std::setw(12)
+           << stats.nanoseconds / 1e6 << " ms" << std::endl;
+        for (size_t c = 0; c < COUNTER_COUNT; ++c) {
+            if (stats.counters[c] == 0) continue;
+            os << "    " << std::left << std::setw(18) << name(static_cast<Counter>(c)) << std::right << std::setw(16)
+               << stats.counters[c] << std::endl;
+        }
+    }
+}
+
+const char* Instrumentation::name(Counter c) {
+    switch (c) {
+    case Counter::BigIntMul: return "bigint.mul";
+    case Counter::BigIntMod: return "bigint.mod";
+    case Counter::BigIntInvert: return "bigint.invert";
+    case Counter::FieldMul: return "field.mul";
+    case Counter::FieldSqr: return "field.sqr";
+    case Counter::FieldInv: return "field.inv";
+    case Counter::PointAdd: return "point.add";
+    case Counter::PointDouble: return "point.double";
+    case Counter::GmpAllocations: return "gmp.allocations";
+    case Counter::GmpAllocatedBytes: return "gmp.allocatedBytes";
+    }
+    return "unknown";
+}
+
+const char* Instrumentation::name(Phase p) {
+    switch (p) {
+    case Phase::ScalarMul: return "scalarMul";
+    case Phase::MultiplyPolynomials: return "multiplyPolynomials";
+    case Phase::Interpolate: return "interpolate";
+    }
+    return "unknown";
+}
+
+void Instrumentation::installGmpHooks() {
+    static std::once_flag once;
+    std::call_once(once, [] {
+        mp_get_memory_functions(&heapAllocate, &heapReallocate, &heapFree);
+        mp_set_memory_functions(&countingAllocate, &countingReallocate, &countingFree);
+    });
+}
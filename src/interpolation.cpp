@@ -1,53 +1,479 @@
-#include "../include/bigint.hpp"
+#include "../include/instrument.hpp"
+#include "../include/interpolation.hpp"
+#include "../include/thread_pool.hpp"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <stdexcept>
 #include <vector>
-#include <iostream>
 
-struct Data {
-    BigInt x, y;
+namespace {
 
-    Data(const std::string& xStr, const std::string& yStr, const std::string& modStr) {
-        x = BigInt(xStr, 10);
-        y = BigInt(yStr, 10);
-        // Assuming modulus is applied for each operation
-        x %= BigInt(modStr, 10);
-        y %= BigInt(modStr, 10);
+// Points per leaf group; below this the quadratic leaf work beats going further down the tree.
+const size_t LEAF_SIZE = 32;
+
+// Below this many points the quadratic barycentric weights beat building a subproduct tree.
+const size_t DIRECT_WEIGHTS = 256;
+
+// base^e mod modulus by square and multiply.
+BigInt powerMod(const BigInt& base, size_t e, const BigInt& modulus) {
+    BigInt result = BigInt(1UL) % modulus;
+    BigInt square = base % modulus;
+    for (; e > 0; e >>= 1) {
+        if (e & 1) result = mulMod(result, square, modulus);
+        if (e > 1) square = mulMod(square, square, modulus);
+    }
+    return result;
+}
+
+// Runs body(i, threads) over the nodes of a tree level: spread across the pool when there are enough
+// nodes, otherwise one node at a time with the products themselves multithreaded.
+void forEachNode(ThreadPool& pool, unsigned threads, size_t nodes, const std::function<void(size_t, unsigned)>& body) {
+    if (nodes >= pool.size()) {
+        pool.parallelFor(nodes, [&](size_t i) { body(i, 1); });
+    } else {
+        for (size_t i = 0; i < nodes; ++i) body(i, threads);
+    }
+}
+
+void broadcast(mp_limb_t* r, const mp_limb_t* value, size_t n, size_t width) {
+    for (size_t i = 0; i < n; ++i) std::memcpy(r + i * width, value, width * sizeof(mp_limb_t));
+}
+
+// prod_i (X - xs[i]) over n points, multiplying in one linear factor at a time.
+Polynomial linearProduct(const mp_limb_t* xs, size_t n, const BigInt& mod, const VecModulus& m) {
+    const size_t width = m.width();
+    Polynomial result(n + 1, mod);
+    mp_limb_t* p = result.coefficients().data();
+    LimbBuffer scaled(n * width);
+    p[0] = 1;
+    for (size_t k = 0; k < n; ++k) {
+        // p <- X * p - x_k * p, p having k + 1 coefficients
+        vecMulScalarMod(scaled.data(), p, xs + k * width, k + 1, m);
+        std::memmove(p + width, p, (k + 1) * width * sizeof(mp_limb_t));
+        std::memset(p, 0, width * sizeof(mp_limb_t));
+        vecSubMod(p, p, scaled.data(), k + 1, m);
     }
-};
+    return result;
+}
+
+// values[i] = r(xs[i]) for n points, one Horner step across all points per coefficient.
+void hornerLeaf(mp_limb_t* values, ConstLimbView r, const mp_limb_t* xs, size_t n, const VecModulus& m) {
+    const size_t width = m.width();
+    std::memset(values, 0, n * width * sizeof(mp_limb_t));
+    LimbBuffer coefficient(n * width);
+    for (size_t k = r.size(); k-- > 0;) {
+        vecMulMod(values, values, xs, n, m);
+        broadcast(coefficient.data(), r[k], n, width);
+        vecAddMod(values, values, coefficient.data(), n, m);
+    }
+}
+
+// sum_i c[i] * M / (X - xs[i]) for the monic M = prod_i (X - xs[i]) of n points. The quotients
+// come from synthetic division run for all points at once: q_{k-1} = M_k + x_i * q_k.
+Polynomial leafCombination(const mp_limb_t* xs, const mp_limb_t* c, size_t n, const Polynomial& vanishing,
+                           const VecModulus& m) {
+    const size_t width = m.width();
+    ConstLimbView M = vanishing.coefficients();
+    Polynomial result(n, vanishing.getMod());
+    LimbView f = result.coefficients();
+    LimbBuffer quotients(n * width), terms(n * width), coefficient(n * width);
+    broadcast(quotients.data(), M[n], n, width);
+    for (size_t k = n; k-- > 0;) {
+        // f_k = sum_i c_i * q_k(x_i), summed by halving
+        vecMulMod(terms.data(), c, quotients.data(), n, m);
+        for (size_t len = n; len > 1;) {
+            const size_t half = (len + 1) / 2;
+            vecAddMod(terms.data(), terms.data(), terms.data() + half * width, len - half, m);
+            len = half;
+        }
+        std::memcpy(f[k], terms.data(), width * sizeof(mp_limb_t));
+        if (k == 0) break;
+        vecMulMod(quotients.data(), quotients.data(), xs, n, m);
+        broadcast(coefficient.data(), M[k], n, width);
+        vecAddMod(quotients.data(), quotients.data(), coefficient.data(), n, m);
+    }
+    return result;
+}
+
+// n coefficients of a starting at first, zero past its end, in reverse order if requested.
+Polynomial window(const Polynomial& a, size_t first, size_t n, bool reverse) {
+    const size_t width = a.width();
+    Polynomial result(n, a.getMod());
+    ConstLimbView src = a.coefficients();
+    LimbView dst = result.coefficients();
+    for (size_t i = 0; i < n && first + i < src.size(); ++i) {
+        std::memcpy(dst[reverse ? n - 1 - i : i], src[first + i], width * sizeof(mp_limb_t));
+    }
+    return result;
+}
+
+// a mod b for a monic b, given inverse = 1 / rev(b) to at least a.size() - b.size() + 1 terms:
+// rev(q) = rev(a) * inverse mod X^m, then r = a - q * b on the low b.size() - 1 coefficients.
+Polynomial reduceMonic(const Polynomial& a, const Polynomial& b, const Polynomial& inverse, unsigned threads) {
+    const size_t na = a.size(), nb = b.size();
+    if (na < nb) return window(a, 0, nb - 1, false);
+    const size_t m = na - nb + 1;
+    Polynomial q(static_cast<size_t>(0), a.getMod());
+    multiplyPolynomials(q, window(a, nb - 1, m, true), window(inverse, 0, m, false), threads);
+    q = window(q, 0, m, true);
+    Polynomial low(static_cast<size_t>(0), a.getMod());
+    multiplyPolynomials(low, q, window(b, 0, nb - 1, false), threads);
+    Polynomial remainder(static_cast<size_t>(0), a.getMod());
+    subtractPolynomials(remainder, window(a, 0, nb - 1, false), window(low, 0, nb - 1, false));
+    return remainder;
+}
 
+} // namespace
+
+Data::Data(const std::string& xStr, const std::string& yStr, const std::string& modStr) {
+    x = BigInt(xStr, 10);
+    y = BigInt(yStr, 10);
+    // Assuming modulus is applied for each operation
+    x %= BigInt(modStr, 10);
+    y %= BigInt(modStr, 10);
+}
+
+// Lagrange form sum_i y_i * prod_{j != i} (xi - x_j) / (x_i - x_j). The numerators come from
+// prefix and suffix products and all denominators share one inversion through batchInvert().
 BigInt interpolate(const std::vector<Data>& f, const BigInt& xi, const std::string& modStr) {
+    INSTRUMENT_PHASE(Interpolate);
     BigInt result("0", 10);
     BigInt mod(modStr, 10);
+    const size_t n = f.size();
 
-    for (size_t i = 0; i < f.size(); i++) {
-        BigInt term = f[i].y;
-        for (size_t j = 0; j < f.size(); j++) {
+    std::vector<BigInt> denominators(n, BigInt(static_cast<unsigned long int>(1)));
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
             if (j != i) {
-                BigInt denom = f[i].x - f[j].x;
-                denom %= mod; // Apply modulus
-                // Ensure denom is invertible in mod
-                term *= (xi - f[j].x) * denom.modInverse(mod);
-                term %= mod;
+                denominators[i] = mulMod(denominators[i], subMod(f[i].x, f[j].x, mod), mod);
             }
         }
-        result += term;
-        result %= mod;
+    }
+    // Ensure every denominator is invertible in mod
+    batchInvert(denominators, mod);
+
+    // suffix[i] = prod_{j >= i} (xi - x_j)
+    std::vector<BigInt> suffix(n + 1, BigInt(static_cast<unsigned long int>(1)));
+    for (size_t i = n; i-- > 0;) {
+        suffix[i] = mulMod(suffix[i + 1], subMod(xi, f[i].x, mod), mod);
+    }
+
+    BigInt prefix(static_cast<unsigned long int>(1));
+    for (size_t i = 0; i < n; i++) {
+        BigInt term = mulMod(mulMod(f[i].y, prefix, mod), suffix[i + 1], mod);
+        result = addMod(result, mulMod(term, denominators[i], mod), mod);
+        prefix = mulMod(prefix, subMod(xi, f[i].x, mod), mod);
     }
     return result;
 }
 
-int main() {
-    std::vector<Data> points = {
-        Data("1", "1", "101"),   // 1^2 = 1
-        Data("2", "4", "101"),   // 2^2 = 4
-        Data("3", "9", "101"),   // 3^2 = 9
-        Data("4", "16", "101"),  // 4^2 = 16
-        Data("5", "25", "101")   // 5^2 = 25
-    };
+Interpolator::Interpolator(const std::vector<BigInt>& xs, const BigInt& modulus, unsigned threads)
+    : Interpolator(xs, modulus, threads, true) {}
+
+Interpolator::Interpolator(const std::vector<Data>& points, const BigInt& modulus, unsigned threads)
+    : Interpolator([&points]() {
+          std::vector<BigInt> xs;
+          xs.reserve(points.size());
+          for (const Data& point : points) xs.push_back(point.x);
+          return xs;
+      }(), modulus, threads, true) {}
+
+Interpolator::Interpolator(const std::vector<BigInt>& xs, const BigInt& modulus, unsigned threads, bool weighted)
+    : mod(modulus), vecMod(modulus), threads(threads), width(vecMod.width()), count(xs.size()),
+      points(xs.size() * vecMod.width()) {
+    for (size_t i = 0; i < count; ++i) (xs[i] % mod).toLimbs(points.data() + i * width, width);
+
+    if (count == 0) {
+        tree.push_back(std::vector<Polynomial>(1, Polynomial(std::vector<BigInt>(1, BigInt(1UL)), mod)));
+        return;
+    }
+
+    std::unique_ptr<ThreadPool> local;
+    ThreadPool& pool = selectThreadPool(threads, local);
+
+    const size_t groups = (count + LEAF_SIZE - 1) / LEAF_SIZE;
+    tree.push_back(std::vector<Polynomial>(groups, Polynomial(static_cast<size_t>(0), mod)));
+    pool.parallelFor(groups, [&](size_t g) {
+        const size_t first = g * LEAF_SIZE;
+        tree[0][g] = linearProduct(points.data() + first * width, std::min(LEAF_SIZE, count - first), mod, vecMod);
+    });
+
+    while (tree.back().size() > 1) {
+        const std::vector<Polynomial>& children = tree.back();
+        std::vector<Polynomial> level((children.size() + 1) / 2, Polynomial(static_cast<size_t>(0), mod));
+        forEachNode(pool, threads, level.size(), [&](size_t i, unsigned inner) {
+            // an odd last child is carried up unchanged
+            if (2 * i + 1 == children.size()) level[i] = children[2 * i];
+            else multiplyPolynomials(level[i], children[2 * i], children[2 * i + 1], inner);
+        });
+        tree.push_back(std::move(level));
+    }
+
+    // Every node divides remainders of its parent, shorter than the parent, so its inverse
+    // is needed to parent.size() - node.size() terms. It is the reversed quotient of
+    // X^(deg + k - 1) by the node, and saves the Newton iteration of every later division.
+    inverses.resize(tree.size() - 1);
+    for (size_t depth = 0; depth + 1 < tree.size(); ++depth) {
+        const std::vector<Polynomial>& nodes = tree[depth];
+        inverses[depth].assign(nodes.size(), Polynomial(static_cast<size_t>(0), mod));
+        forEachNode(pool, threads, nodes.size(), [&](size_t i, unsigned inner) {
+            const size_t k = tree[depth + 1][i / 2].size() - nodes[i].size();
+            if (k == 0) return;
+            Polynomial power(nodes[i].size() + k - 1, mod), quotient(power), remainder(power);
+            power.setCoefficient(power.size() - 1, BigInt(1UL));
+            dividePolynomials(quotient, remainder, power, nodes[i], inner);
+            inverses[depth][i] = window(quotient, 0, k, true);
+        });
+    }
+
+    if (!weighted) return;
+
+    // w_i = 1 / M'(x_i) = 1 / prod_{j != i} (x_i - x_j)
+    Polynomial derivative(static_cast<size_t>(0), mod);
+    derivePolynomial(derivative, vanishing());
+    weights = LimbBuffer(count * width);
+    evaluateLimbs(derivative, weights.data());
+    std::vector<BigInt> values(count);
+    for (size_t i = 0; i < count; ++i) values[i] = BigInt::fromLimbs(weights.data() + i * width, width);
+    try {
+        batchInvert(values, mod);
+    } catch (const std::runtime_error&) {
+        throw std::invalid_argument("The x-coordinates must be distinct and their differences invertible.");
+    }
+    for (size_t i = 0; i < count; ++i) values[i].toLimbs(weights.data() + i * width, width);
+}
+
+void Interpolator::evaluateLimbs(const Polynomial& f, mp_limb_t* values) const {
+    if (count == 0) return;
+    std::unique_ptr<ThreadPool> local;
+    ThreadPool& pool = selectThreadPool(threads, local);
+
+    // remainders of f modulo the nodes of the current level
+    Polynomial quotient(static_cast<size_t>(0), mod);
+    std::vector<Polynomial> remainders(1, Polynomial(static_cast<size_t>(0), mod));
+    dividePolynomials(quotient, remainders[0], f, vanishing(), threads);
+    for (size_t depth = tree.size() - 1; depth-- > 0;) {
+        const std::vector<Polynomial>& nodes = tree[depth];
+        std::vector<Polynomial> next(nodes.size(), Polynomial(static_cast<size_t>(0), mod));
+        forEachNode(pool, threads, nodes.size(), [&](size_t i, unsigned inner) {
+            const Polynomial& parent = remainders[i / 2];
+            // a child carried up alone already has the remainder of its parent
+            if (nodes.size() % 2 == 1 && i + 1 == nodes.size()) next[i] = parent;
+            else next[i] = reduceMonic(parent, nodes[i], inverses[depth][i], inner);
+        });
+        remainders = std::move(next);
+    }
+
+    pool.parallelFor(remainders.size(), [&](size_t g) {
+        const size_t first = g * LEAF_SIZE;
+        const Polynomial& remainder = remainders[g];
+        hornerLeaf(values + first * width, remainder.coefficients(), points.data() + first * width,
+                   std::min(LEAF_SIZE, count - first), vecMod);
+    });
+}
 
-    BigInt xi("6", 10);  // Expecting 6^2 = 36
-    BigInt interpolatedValue = interpolate(points, xi, "101");
-    std::cout << "Interpolated Value at x=6: ";
-    interpolatedValue.print();
+std::vector<BigInt> Interpolator::evaluate(const Polynomial& f) const {
+    if (f.getMod() != mod) {
+        throw std::invalid_argument("Moduli of the polynomial and the points must be the same.");
+    }
+    LimbBuffer values(count * width);
+    evaluateLimbs(f, values.data());
+    std::vector<BigInt> result(count);
+    for (size_t i = 0; i < count; ++i) result[i] = BigInt::fromLimbs(values.data() + i * width, width);
+    return result;
+}
+
+Polynomial Interpolator::interpolate(const std::vector<BigInt>& ys) const {
+    return interpolate(ys, threads);
+}
+
+Polynomial Interpolator::interpolate(const std::vector<BigInt>& ys, unsigned threads) const {
+    INSTRUMENT_PHASE(Interpolate);
+    if (ys.size() != count) {
+        throw std::invalid_argument("The number of values must match the number of points.");
+    }
+    if (count == 0) return Polynomial(static_cast<size_t>(0), mod);
+
+    LimbBuffer scaled(count * width);
+    for (size_t i = 0; i < count; ++i) (ys[i] % mod).toLimbs(scaled.data() + i * width, width);
+    vecMulMod(scaled.data(), scaled.data(), weights.data(), count, vecMod);
+
+    std::unique_ptr<ThreadPool> local;
+    ThreadPool& pool = selectThreadPool(threads, local);
+
+    std::vector<Polynomial> parts(tree[0].size(), Polynomial(static_cast<size_t>(0), mod));
+    pool.parallelFor(parts.size(), [&](size_t g) {
+        const size_t first = g * LEAF_SIZE;
+        parts[g] = leafCombination(points.data() + first * width, scaled.data() + first * width,
+                                   std::min(LEAF_SIZE, count - first), tree[0][g], vecMod);
+    });
+
+    for (size_t depth = 0; depth + 1 < tree.size(); ++depth) {
+        const std::vector<Polynomial>& nodes = tree[depth];
+        std::vector<Polynomial> merged(tree[depth + 1].size(), Polynomial(static_cast<size_t>(0), mod));
+        forEachNode(pool, threads, merged.size(), [&](size_t i, unsigned inner) {
+            if (2 * i + 1 == nodes.size()) {
+                merged[i] = std::move(parts[2 * i]);
+                return;
+            }
+            // f = f_left * M_right + f_right * M_left
+            Polynomial right(static_cast<size_t>(0), mod);
+            multiplyPolynomials(merged[i], parts[2 * i], nodes[2 * i + 1], inner);
+            multiplyPolynomials(right, parts[2 * i + 1], nodes[2 * i], inner);
+            addPolynomials(merged[i], merged[i], right);
+        });
+        parts = std::move(merged);
+    }
+    return std::move(parts[0]);
+}
+
+Polynomial Interpolator::interpolate(const std::vector<Data>& points) const {
+    std::vector<BigInt> ys;
+    ys.reserve(points.size());
+    for (const Data& point : points) ys.push_back(point.y);
+    return interpolate(ys);
+}
+
+std::vector<BigInt> multipointEvaluate(const Polynomial& f, const std::vector<BigInt>& points) {
+    return Interpolator(points, f.getMod(), 0, false).evaluate(f);
+}
+
+std::vector<Polynomial> batchInterpolate(const Interpolator& interpolator, const std::vector<std::vector<BigInt> >& columns,
+                                         unsigned threads, size_t grain) {
+    std::vector<Polynomial> result(columns.size(), Polynomial(static_cast<size_t>(0), interpolator.mod));
+    // few columns: one after the other, each spread over the interpolator's threads
+    if (threads == 1 || columns.size() <= std::max<size_t>(grain, 1)) {
+        for (size_t c = 0; c < columns.size(); ++c) result[c] = interpolator.interpolate(columns[c]);
+        return result;
+    }
+    std::unique_ptr<ThreadPool> local;
+    selectThreadPool(threads, local).parallelFor(columns.size(), [&](size_t c) {
+        result[c] = interpolator.interpolate(columns[c], 1);
+    }, grain);
+    return result;
+}
+
+std::vector<BigInt> batchInterpolate(const std::vector<std::vector<Data> >& columns, const BigInt& xi,
+                                     const std::string& modStr, unsigned threads, size_t grain) {
+    std::vector<BigInt> values(columns.size());
+    if (threads == 1) {
+        for (size_t c = 0; c < columns.size(); ++c) values[c] = interpolate(columns[c], xi, modStr);
+        return values;
+    }
+    std::unique_ptr<ThreadPool> local;
+    selectThreadPool(threads, local).parallelFor(columns.size(), [&](size_t c) {
+        values[c] = interpolate(columns[c], xi, modStr);
+    }, grain);
+    return values;
+}
+
+LagrangeDomain::LagrangeDomain(const std::vector<BigInt>& xs, const BigInt& modulus, unsigned threads)
+    : mod(modulus), rootsOfUnity(false) {
+    const size_t n = xs.size();
+    points.reserve(n);
+    for (const BigInt& x : xs) points.push_back(x % mod);
+
+    if (n > DIRECT_WEIGHTS) {
+        const Interpolator tree(points, mod, threads);
+        weights.reserve(n);
+        for (size_t i = 0; i < n; ++i) weights.push_back(BigInt::fromLimbs(tree.weights.data() + i * tree.width, tree.width));
+        return;
+    }
+
+    weights.assign(n, BigInt(1UL));
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            if (j != i) weights[i] = mulMod(weights[i], subMod(points[i], points[j], mod), mod);
+        }
+    }
+    try {
+        batchInvert(weights, mod);
+    } catch (const std::runtime_error&) {
+        throw std::invalid_argument("The x-coordinates must be distinct and their differences invertible.");
+    }
+}
+
+LagrangeDomain::LagrangeDomain(size_t n, const BigInt& omega, const BigInt& modulus)
+    : mod(modulus), rootsOfUnity(true) {
+    if (n == 0) {
+        throw std::invalid_argument("The number of points must be positive.");
+    }
+    const BigInt one = BigInt(1UL) % mod;
+    const BigInt root = omega % mod;
+    if (powerMod(root, n, mod) != one) {
+        throw std::invalid_argument("omega must be a primitive n-th root of unity.");
+    }
+    // the order is exactly n iff omega^(n / q) != 1 for every prime q dividing n
+    for (size_t q = 2, rest = n; rest > 1; ++q) {
+        if (q * q > rest) q = rest;
+        if (rest % q != 0) continue;
+        if (powerMod(root, n / q, mod) == one) {
+            throw std::invalid_argument("omega must be a primitive n-th root of unity.");
+        }
+        while (rest % q == 0) rest /= q;
+    }
+
+    // M = X^n - 1, so M'(x_i) = n * x_i^(n - 1) = n / x_i
+    const BigInt nInverse = BigInt(static_cast<unsigned long int>(n)).modInverse(mod);
+    points.reserve(n);
+    weights.reserve(n);
+    BigInt power = one;
+    for (size_t i = 0; i < n; ++i) {
+        weights.push_back(mulMod(power, nInverse, mod));
+        points.push_back(power);
+        power = mulMod(power, root, mod);
+    }
+}
+
+size_t LagrangeDomain::prepare(const BigInt& z, std::vector<BigInt>& terms, BigInt& vanishingAtZ) const {
+    const size_t n = points.size();
+    const BigInt position = z % mod;
+    terms.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        terms[i] = subMod(position, points[i], mod);
+        if (terms[i].isZero()) {
+            terms.clear();
+            return i;
+        }
+    }
+
+    if (rootsOfUnity) {
+        vanishingAtZ = subMod(powerMod(position, n, mod), BigInt(1UL), mod);
+    } else {
+        vanishingAtZ = BigInt(1UL) % mod;
+        for (size_t i = 0; i < n; ++i) vanishingAtZ = mulMod(vanishingAtZ, terms[i], mod);
+    }
+    batchInvert(terms, mod);
+    for (size_t i = 0; i < n; ++i) terms[i] = mulMod(terms[i], weights[i], mod);
+    return n;
+}
+
+std::vector<BigInt> LagrangeDomain::basis(const BigInt& z) const {
+    std::vector<BigInt> terms;
+    BigInt vanishingAtZ;
+    const size_t k = prepare(z, terms, vanishingAtZ);
+    if (k < points.size()) {
+        // z is the point x_k itself
+        std::vector<BigInt> unit(points.size());
+        unit[k] = BigInt(1UL) % mod;
+        return unit;
+    }
+    for (BigInt& term : terms) term = mulMod(term, vanishingAtZ, mod);
+    return terms;
+}
+
+BigInt LagrangeDomain::evaluate(const std::vector<BigInt>& ys, const BigInt& z) const {
+    if (ys.size() != points.size()) {
+        throw std::invalid_argument("The number of values must match the number of points.");
+    }
+    std::vector<BigInt> terms;
+    BigInt vanishingAtZ;
+    const size_t k = prepare(z, terms, vanishingAtZ);
+    if (k < points.size()) return ys[k] % mod;
 
-    return 0;
+    BigInt sum;
+    for (size_t i = 0; i < terms.size(); ++i) sum = addMod(sum, mulMod(terms[i], ys[i] % mod, mod), mod);
+    return mulMod(sum, vanishingAtZ, mod);
 }
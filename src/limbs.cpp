@@ -0,0 +1,53 @@
+#include "../include/limbs.hpp"
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+LimbBuffer::LimbBuffer(size_t limbs) : raw(nullptr), ptr(nullptr), n(limbs) {
+    if (n == 0) return;
+    // Over-allocate by one alignment unit and round the start up.
+    raw = ::operator new(n * sizeof(mp_limb_t) + LIMB_ALIGNMENT);
+    uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+    start = (start + LIMB_ALIGNMENT - 1) & ~static_cast<uintptr_t>(LIMB_ALIGNMENT - 1);
+    ptr = reinterpret_cast<mp_limb_t*>(start);
+    std::memset(ptr, 0, n * sizeof(mp_limb_t));
+}
+
+LimbBuffer::LimbBuffer(const LimbBuffer& other) : LimbBuffer(other.n) {
+    if (n) std::memcpy(ptr, other.ptr, n * sizeof(mp_limb_t));
+}
+
+LimbBuffer::LimbBuffer(LimbBuffer&& other) noexcept : raw(other.raw), ptr(other.ptr), n(other.n) {
+    other.raw = nullptr;
+    other.ptr = nullptr;
+    other.n = 0;
+}
+
+LimbBuffer& LimbBuffer::operator=(const LimbBuffer& other) {
+    if (this != &other) {
+        LimbBuffer copy(other);
+        swap(copy);
+    }
+    return *this;
+}
+
+LimbBuffer& LimbBuffer::operator=(LimbBuffer&& other) noexcept {
+    swap(other);
+    return *this;
+}
+
+LimbBuffer::~LimbBuffer() {
+    ::operator delete(raw);
+}
+
+void LimbBuffer::swap(LimbBuffer& other) noexcept {
+    void* r = raw;
+    raw = other.raw;
+    other.raw = r;
+    mp_limb_t* p = ptr;
+    ptr = other.ptr;
+    other.ptr = p;
+    size_t s = n;
+    n = other.n;
+    other.n = s;
+}
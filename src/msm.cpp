@@ -0,0 +1,37 @@
+#include "../include/msm.hpp"
+#include "../include/scalarmul.hpp"
+#include <cmath>
+#include <stdexcept>
+
+unsigned msmWindowBits(size_t n) {
+    if (n < 32) return 3;
+    unsigned c = static_cast<unsigned>(std::log(static_cast<double>(n))) + 2;
+    return c > MSM_MAX_WINDOW ? MSM_MAX_WINDOW : c;
+}
+
+std::vector<int16_t> msmSignedDigits(const mp_limb_t* scalars, size_t count, size_t limbs, size_t bits, unsigned c) {
+    if (c < 2 || c > MSM_MAX_WINDOW) {
+        throw std::invalid_argument("MSM window width out of range.");
+    }
+    const size_t windowCount = msmWindowCount(bits, c);
+    const mp_limb_t half = static_cast<mp_limb_t>(1) << (c - 1);
+    std::vector<int16_t> digits(windowCount * count);
+
+    for (size_t i = 0; i < count; ++i) {
+        const mp_limb_t* k = scalars + i * limbs;
+        mp_limb_t carry = 0;
+        for (size_t j = 0; j < windowCount; ++j) {
+            mp_limb_t raw = scalarWindow(k, limbs, j * c, c) + carry;
+            carry = raw > half ? 1 : 0;
+            digits[j * count + i] = static_cast<int16_t>(static_cast<int64_t>(raw) - static_cast<int64_t>(carry << c));
+        }
+    }
+    return digits;
+}
+
+size_t msmChunkCount(size_t count, size_t windows, unsigned c, unsigned threads) {
+    size_t chunks = (2 * static_cast<size_t>(threads) + windows - 1) / windows;
+    const size_t maxChunks = count >> c;
+    if (chunks > maxChunks) chunks = maxChunks;
+    return chunks == 0 ? 1 : chunks;
+}
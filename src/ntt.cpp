@@ -0,0 +1,17 @@
+#include "../include/ntt.hpp"
+
+bool nttFriendly(const BigInt& p, size_t size) {
+    if (size == 0 || (size & (size - 1)) != 0) return false;
+    if (!p.testBit(0) || p <= BigInt(static_cast<unsigned long int>(2))) return false;
+    // size = 2^k divides p - 1 iff the k lowest bits of p - 1 are zero
+    const BigInt pMinus1 = p - BigInt(static_cast<unsigned long int>(1));
+    for (size_t bit = 1, k = 0; bit < size; bit <<= 1, ++k) {
+        if (pMinus1.testBit(k)) return false;
+    }
+    // products and domains ask again for every transform, so each thread remembers its last prime
+    thread_local BigInt lastPrime;
+    if (p == lastPrime) return true;
+    if (p.isPrime(25) == 0) return false;
+    lastPrime = p;
+    return true;
+}
@@ -0,0 +1,48 @@
+#include "../include/pairing.hpp"
+
+namespace {
+
+const PairingParameters BN254_PARAMETERS = {
+    "21888242871839275222246405745257275088696311157297823662689037894645226208583",
+    "21888242871839275222246405745257275088548364400416034343698204186575808495617",
+    4965661367192848881ULL,
+    false,
+    true,
+    false,
+    9,
+    3,
+    {"1", "2"},
+    {"10857046999023057135944570762232829481370756359578518086990519993285655852781",
+     "11559732032986387107991004021392285783925812861821192530917403151452391805634",
+     "8495653923123431417604973247489272438418190587263600148770280649306958101930",
+     "4082367875863433681332203403145435568316851327593401208105741076214120093531"},
+};
+
+const PairingParameters BLS12_381_PARAMETERS = {
+    "0x1a0111ea397fe69a4b1ba7b6434bacd764774b84f38512bf6730d2a0f6b0f6241eabfffeb153ffffb9feffffffffaaab",
+    "0x73eda753299d7d483339d80809a1d80553bda402fffe5bfeffffffff00000001",
+    0xd201000000010000ULL,
+    true,
+    false,
+    true,
+    1,
+    4,
+    {"0x17f1d3a73197d7942695638c4fa9ac0fc3688c4f9774b905a14e3a3f171bac586c55e83ff97a1aeffb3af00adb22c6bb",
+     "0x08b3f481e3aaa0f1a09e30ed741d8ae4fcf5e095d5d00af600db18cb2c04b3edd03cc744a2888ae40caa232946c5e7e1"},
+    {"0x024aa2b2f08f0a91260805272dc51051c6e47ad4fa403b02b4510b647ae3d1770bac0326a805bbefd48056c8c121bdb8",
+     "0x13e02b6052719f607dacd3a088274f65596bd0d09920b61ab5da61bbdc7f5049334cf11213945d57e5ac7d055d042b7e",
+     "0x0ce5d527727d6e118cc9cdc6da2e351aadfd9baa8cbdd3a76d429a695160d12c923ac9cc3baca289e193548608b82801",
+     "0x0606c4a02ea734cc32acd2b02bc28b99cb3e287e85a763af267492ab572e99ab3f370d275cec1da1aaa9075ff05f79be"},
+};
+
+} // namespace
+
+const PairingEngine<PairingCurve<BN254>::Field>& PairingCurve<BN254>::engine() {
+    static const PairingEngine<Field> instance(BN254_PARAMETERS);
+    return instance;
+}
+
+const PairingEngine<PairingCurve<BLS12_381>::Field>& PairingCurve<BLS12_381>::engine() {
+    static const PairingEngine<Field> instance(BLS12_381_PARAMETERS);
+    return instance;
+}
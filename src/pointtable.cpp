@@ -0,0 +1,208 @@
+#include "../include/pointtable.hpp"
+#include "../include/msm.hpp"
+#include "../include/thread_pool.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char MAGIC[8] = {'E', 'C', 'P', 'T', 'A', 'B', 'L', 'E'};
+const uint32_t VERSION = 1;
+
+// Points written per block, to bound the staging buffer.
+const size_t WRITE_BLOCK = 1 << 14;
+
+struct PointSizeVisitor {
+    typedef size_t result_type;
+
+    template <class C>
+    size_t run() const { return sizeof(AffinePoint<typename C::Field>); }
+};
+
+struct WriteVisitor {
+    typedef void result_type;
+    std::ofstream& out;
+    const std::vector<Ecc_Point>& points;
+
+    template <class C>
+    void run() const {
+        typedef AffinePoint<typename C::Field> Affine;
+        std::vector<Affine> block;
+        for (size_t begin = 0; begin < points.size(); begin += WRITE_BLOCK) {
+            const size_t end = std::min(begin + WRITE_BLOCK, points.size());
+            block.resize(end - begin);
+            // zero the padding too, so equal tables are equal files
+            std::memset(static_cast<void*>(block.data()), 0, block.size() * sizeof(Affine));
+            for (size_t i = begin; i < end; ++i) {
+                Affine& a = block[i - begin];
+                a.infinity = points[i].isInfinity;
+                if (a.infinity) continue;
+                std::memcpy(a.x.limbs, points[i].xLimbs(), sizeof(a.x.limbs));
+                std::memcpy(a.y.limbs, points[i].yLimbs(), sizeof(a.y.limbs));
+            }
+            out.write(reinterpret_cast<const char*>(block.data()), block.size() * sizeof(Affine));
+        }
+    }
+};
+
+struct PointVisitor {
+    typedef Ecc_Point result_type;
+    const PointTable& table;
+    size_t i;
+
+    template <class C>
+    Ecc_Point run() const {
+        const AffinePoint<typename C::Field>& a = table.points<C>()[i];
+        if (a.infinity) return Ecc_Point(C::ID);
+        return Ecc_Point::fromLimbs(a.x.limbs, a.y.limbs, C::ID);
+    }
+};
+
+struct TableMsmVisitor {
+    typedef Ecc_Point result_type;
+    const PointTable& table;
+    const std::vector<BigInt>& scalars;
+    ThreadPool& pool;
+
+    template <class C>
+    Ecc_Point run() const {
+        const BigInt& n = CurveContext::instance(C::ID).params().n;
+        const size_t count = scalars.size();
+        std::vector<mp_limb_t> limbs(count * C::LIMBS);
+        pool.parallelFor(count, [&](size_t i) { (scalars[i] % n).toLimbs(&limbs[i * C::LIMBS], C::LIMBS); });
+
+        JacobianPoint<typename C::Field> result;
+        pippengerMsm(C::arithmetic(), result, table.points<C>(), limbs.data(), count, C::LIMBS, n.bitSize(), 0, &pool);
+
+        AffinePoint<typename C::Field> r;
+        C::arithmetic().toAffine(r, result);
+        if (r.infinity) return Ecc_Point(C::ID);
+        return Ecc_Point(C::field().toBigInt(r.x), C::field().toBigInt(r.y), C::ID);
+    }
+};
+
+} // namespace
+
+void PointTable::write(const std::string& path, const std::vector<Ecc_Point>& points, CurveId id) {
+    if (!points.empty()) id = points[0].getCurve().id();
+    for (size_t i = 0; i < points.size(); ++i) {
+        if (points[i].getCurve().id() != id) {
+            throw std::invalid_argument("Points belong to different curves.");
+        }
+    }
+
+    PointTableHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.curve = static_cast<uint32_t>(id);
+    header.count = points.size();
+    PointSizeVisitor size;
+    header.pointSize = visitCurve(id, size);
+
+    std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Cannot create point table file " + path + ".");
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    WriteVisitor visitor = {out, points};
+    visitCurve(id, visitor);
+    out.close();
+    if (!out) {
+        throw std::runtime_error("Cannot write point table file " + path + ".");
+    }
+}
+
+PointTable::PointTable(const std::string& path) : base(nullptr), length(0), curveId(CurveId::P256), count(0) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Cannot open point table file " + path + ".");
+    }
+    LARGE_INTEGER fileSize;
+    length = GetFileSizeEx(file, &fileSize) ? static_cast<size_t>(fileSize.QuadPart) : 0;
+    HANDLE mapping = length ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+    CloseHandle(file);
+    if (mapping) {
+        base = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        CloseHandle(mapping);
+    }
+#else
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open point table file " + path + ".");
+    }
+    struct stat info;
+    length = fstat(fd, &info) == 0 ? static_cast<size_t>(info.st_size) : 0;
+    void* mapped = length ? mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (mapped != MAP_FAILED) base = static_cast<const unsigned char*>(mapped);
+#endif
+    if (!base) {
+        throw std::runtime_error("Cannot map point table file " + path + ".");
+    }
+
+    PointTableHeader header;
+    bool valid = length >= sizeof(header);
+    if (valid) {
+        std::memcpy(&header, base, sizeof(header));
+        valid = std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 && header.version == VERSION &&
+                header.curve <= static_cast<uint32_t>(CurveId::P521);
+    }
+    if (valid) {
+        curveId = static_cast<CurveId>(header.curve);
+        PointSizeVisitor size;
+        valid = header.pointSize == visitCurve(curveId, size) &&
+                header.count <= (length - sizeof(header)) / header.pointSize;
+    }
+    if (!valid) {
+        unmap();
+        throw std::runtime_error("File " + path + " is not a point table of this build.");
+    }
+    count = static_cast<size_t>(header.count);
+}
+
+PointTable::~PointTable() {
+    unmap();
+}
+
+void PointTable::unmap() {
+    if (!base) return;
+#ifdef _WIN32
+    UnmapViewOfFile(base);
+#else
+    munmap(const_cast<unsigned char*>(base), length);
+#endif
+    base = nullptr;
+}
+
+Ecc_Point PointTable::point(size_t i) const {
+    if (i >= count) {
+        throw std::out_of_range("Point index out of range.");
+    }
+    PointVisitor visitor = {*this, i};
+    return visitCurve(curveId, visitor);
+}
+
+Ecc_Point multiScalarMul(const PointTable& table, const std::vector<BigInt>& scalars, unsigned threads) {
+    if (scalars.size() > table.size()) {
+        throw std::invalid_argument("More scalars than points in the table.");
+    }
+    if (scalars.empty()) return Ecc_Point(table.curve());
+
+    std::unique_ptr<ThreadPool> local;
+    TableMsmVisitor visitor = {table, scalars, selectThreadPool(threads, local)};
+    return visitCurve(table.curve(), visitor);
+}
@@ -1,27 +1,320 @@
 #include "../include/bigint.hpp"
+#include "../include/field.hpp"
+#include "../include/instrument.hpp"
+#include "../include/ntt.hpp"
 #include "../include/polynomial.hpp"
+#include "../include/thread_pool.hpp"
+#include "../include/vecmod.hpp"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <memory>
 #include <vector>
 #include <iostream>
 #include <sstream>
+#include <utility>
+
+namespace {
+
+// Below this many coefficients in the shorter factor the quadratic loop wins.
+const size_t SCHOOLBOOK_THRESHOLD = 16;
+
+// Smallest product size worth three transforms.
+const size_t NTT_THRESHOLD = 2048;
+
+// Coefficients converted or multiplied per thread pool task.
+const size_t NTT_CHUNK = 1 << 12;
+
+// Below this many quotient or divisor coefficients long division beats Newton iteration.
+const size_t NEWTON_THRESHOLD = 64;
+
+// Runs body(begin, n) over [0, count) in chunks of grain, on a pool when there is more than one chunk.
+void forEachChunk(size_t count, unsigned threads, size_t grain, const std::function<void(size_t, size_t)>& body) {
+    grain = std::max<size_t>(grain, 1);
+    if (threads == 1 || count <= grain) {
+        body(0, count);
+        return;
+    }
+    std::unique_ptr<ThreadPool> local;
+    ThreadPool& pool = selectThreadPool(threads, local);
+    pool.parallelFor((count + grain - 1) / grain, [&](size_t c) {
+        const size_t begin = c * grain;
+        body(begin, std::min(grain, count - begin));
+    });
+}
+
+// Reduces n-limb values (n >= width) modulo the width-limb modulus, with the quotient
+// scratch shared by all of them.
+class Reducer {
+public:
+    Reducer(const mp_limb_t* mod, size_t width, size_t n) : mod(mod), width(width), n(n), q(n - width + 1) {}
+
+    void operator()(mp_limb_t* r, const mp_limb_t* t) { mpn_tdiv_qr(q.data(), r, 0, t, n, mod, width); }
+
+private:
+    const mp_limb_t* mod;
+    size_t width;
+    size_t n;
+    std::vector<mp_limb_t> q;
+};
+
+// Limbs holding a sum of terms products of two values below 2^bits.
+size_t productSumLimbs(size_t bits, size_t terms) {
+    return (2 * bits + BigInt(static_cast<unsigned long int>(terms)).bitSize() + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS;
+}
+
+// Product scanning: each output coefficient sums its double-width products unreduced and
+// is reduced once. The carries out of 2 * width limbs go to one more limb, which the bit
+// bound of the modulus often shows to stay zero, so the division can skip it.
+void schoolbookProduct(LimbView r, ConstLimbView a, ConstLimbView b, const BigInt& mod, const mp_limb_t* m) {
+    const size_t width = a.width();
+    const size_t wide = std::max(2 * width, productSumLimbs(mod.bitSize(), std::min(a.size(), b.size())));
+    Reducer reduce(m, width, wide);
+    std::vector<mp_limb_t> acc(2 * width + 1), t(2 * width);
+    for (size_t k = 0; k < r.size(); ++k) {
+        std::fill(acc.begin(), acc.end(), 0);
+        const size_t first = k >= b.size() ? k - b.size() + 1 : 0;
+        const size_t last = std::min(k, a.size() - 1);
+        for (size_t i = first; i <= last; ++i) {
+            mpn_mul_n(t.data(), a[i], b[k - i], width);
+            acc[2 * width] += mpn_add_n(acc.data(), acc.data(), t.data(), 2 * width);
+        }
+        reduce(r[k], acc.data());
+    }
+}
+
+// Kronecker substitution: both factors are packed into one integer with slots wide
+// enough that no coefficient of the integer product overflows into the next, so a
+// single mpn_mul (Karatsuba, Toom-Cook or FFT depending on the size) does the work.
+void kroneckerProduct(LimbView r, ConstLimbView a, ConstLimbView b, const BigInt& mod, const mp_limb_t* m) {
+    const ConstLimbView& longer = a.size() >= b.size() ? a : b;
+    const ConstLimbView& shorter = a.size() >= b.size() ? b : a;
+    const size_t width = a.width();
+    const size_t slot = productSumLimbs(mod.bitSize(), shorter.size());
+
+    std::vector<mp_limb_t> x(longer.size() * slot, 0), y(shorter.size() * slot, 0);
+    for (size_t i = 0; i < longer.size(); ++i) std::memcpy(&x[i * slot], longer[i], width * sizeof(mp_limb_t));
+    for (size_t i = 0; i < shorter.size(); ++i) std::memcpy(&y[i * slot], shorter[i], width * sizeof(mp_limb_t));
+
+    std::vector<mp_limb_t> z(x.size() + y.size());
+    mpn_mul(z.data(), x.data(), x.size(), y.data(), y.size());
+    Reducer reduce(m, width, slot);
+    for (size_t k = 0; k < r.size(); ++k) reduce(r[k], &z[k * slot]);
+}
+
+// Forward NTT of both factors, pointwise product, inverse NTT, in Montgomery form.
+struct NttProductVisitor {
+    typedef void result_type;
+    LimbView r;
+    ConstLimbView a;
+    ConstLimbView b;
+    const BigInt& mod;
+    size_t size;
+    ThreadPool& pool;
+
+    template <size_t N>
+    void run() const {
+        typedef MontgomeryField<N> Field;
+        typedef typename Field::Element Element;
+        const Field field(mod);
+        const NttDomain<Field> domain(field, size);
+        const size_t chunks = (size + NTT_CHUNK - 1) / NTT_CHUNK;
+
+        std::vector<Element> x(size, field.zero()), y(size, field.zero());
+        pool.parallelFor(chunks, [&](size_t c) {
+            for (size_t i = c * NTT_CHUNK; i < std::min((c + 1) * NTT_CHUNK, size); ++i) {
+                if (i < a.size()) {
+                    std::memcpy(x[i].limbs, a[i], sizeof(x[i].limbs));
+                    field.toMontgomery(x[i], x[i]);
+                }
+                if (i < b.size()) {
+                    std::memcpy(y[i].limbs, b[i], sizeof(y[i].limbs));
+                    field.toMontgomery(y[i], y[i]);
+                }
+            }
+        });
+        domain.forward(x.data(), &pool);
+        domain.forward(y.data(), &pool);
+        pool.parallelFor(chunks, [&](size_t c) {
+            for (size_t i = c * NTT_CHUNK; i < std::min((c + 1) * NTT_CHUNK, size); ++i) field.mul(x[i], x[i], y[i]);
+        });
+        domain.inverse(x.data(), &pool);
+
+        pool.parallelFor(chunks, [&](size_t c) {
+            for (size_t k = c * NTT_CHUNK; k < std::min((c + 1) * NTT_CHUNK, r.size()); ++k) {
+                Element v;
+                field.fromMontgomery(v, x[k]);
+                std::memcpy(r[k], v.limbs, sizeof(v.limbs));
+            }
+        });
+    }
+};
+
+// Number of coefficients up to the highest non-zero one.
+size_t trimmedSize(ConstLimbView a) {
+    size_t n = a.size();
+    while (n > 0 && mpn_zero_p(a[n - 1], a.width())) --n;
+    return n;
+}
+
+// The first n coefficients of a, zero padded.
+Polynomial truncated(const Polynomial& a, size_t n) {
+    Polynomial r(n, a.getMod());
+    const size_t copied = std::min(n, a.size());
+    if (copied > 0) std::memcpy(r.coefficients()[0], a.coefficients()[0], copied * a.width() * sizeof(mp_limb_t));
+    return r;
+}
+
+// r[i] = a[len - 1 - i] for i < n: the first len coefficients of a reversed, truncated or padded to n.
+Polynomial reversed(const Polynomial& a, size_t len, size_t n) {
+    Polynomial r(n, a.getMod());
+    LimbView rv = r.coefficients();
+    ConstLimbView av = a.coefficients();
+    for (size_t i = 0; i < std::min(n, len); ++i) {
+        if (len - 1 - i < av.size()) std::memcpy(rv[i], av[len - 1 - i], a.width() * sizeof(mp_limb_t));
+    }
+    return r;
+}
+
+// g with f * g = 1 mod X^k; each Newton step doubles the number of correct coefficients.
+Polynomial inverseSeries(const Polynomial& f, size_t k, unsigned threads) {
+    const BigInt& mod = f.getMod();
+    Polynomial g(1, mod), two(1, mod);
+    g.setCoefficient(0, f.coefficient(0).modInverse(mod));
+    two.setCoefficient(0, BigInt(static_cast<unsigned long int>(2)));
+    for (size_t len = 1; len < k;) {
+        len = std::min(2 * len, k);
+        Polynomial t = truncated(f, len);
+        multiplyPolynomials(t, t, g, threads);
+        subtractPolynomials(t, two, truncated(t, len));
+        multiplyPolynomials(g, g, t, threads);
+        g = truncated(g, len);
+    }
+    return g;
+}
+
+// Quotient and remainder of the first na coefficients of a by the first nb of b, one
+// quotient coefficient and one vector multiply-subtract at a time.
+void longDivision(Polynomial& quotient, Polynomial& remainder, const Polynomial& a, size_t na, const Polynomial& b, size_t nb) {
+    const BigInt& mod = a.getMod();
+    const size_t width = a.width();
+    const VecModulus m(mod);
+    std::vector<mp_limb_t> inverse(width), t(nb * width);
+    b.coefficient(nb - 1).modInverse(mod).toLimbs(inverse.data(), width);
+
+    Polynomial rem = truncated(a, na);
+    Polynomial quo(na - nb + 1, mod);
+    LimbView r = rem.coefficients();
+    LimbView q = quo.coefficients();
+    ConstLimbView d = b.coefficients();
+    for (size_t k = na - nb + 1; k-- > 0;) {
+        vecMulScalarMod(q[k], r[k + nb - 1], inverse.data(), 1, m);
+        vecMulScalarMod(t.data(), d[0], q[k], nb, m);
+        vecSubMod(r[k], r[k], t.data(), nb, m);
+    }
+    quotient = std::move(quo);
+    remainder = truncated(rem, nb - 1);
+}
+
+// Points Horner's rule advances together; their multiplications are independent.
+const size_t HORNER_BLOCK = 8;
+
+// Horner's rule in Montgomery arithmetic on normal-form accumulators: with x in Montgomery
+// form mul(acc, x) = acc * x, so only the points are converted. If quotient is set, the
+// accumulators of the first point are the coefficients of a / (X - x).
+struct HornerVisitor {
+    typedef void result_type;
+    ConstLimbView a;
+    const mp_limb_t* points;
+    size_t count;
+    mp_limb_t* values;
+    mp_limb_t* quotient;
+    const BigInt& mod;
+
+    template <size_t N>
+    void run() const {
+        typedef MontgomeryField<N> Field;
+        typedef typename Field::Element Element;
+        const Field field(mod);
+        for (size_t first = 0; first < count; first += HORNER_BLOCK) {
+            const size_t n = std::min(HORNER_BLOCK, count - first);
+            Element x[HORNER_BLOCK], acc[HORNER_BLOCK], c;
+            for (size_t j = 0; j < n; ++j) {
+                std::memcpy(x[j].limbs, points + (first + j) * N, sizeof(x[j].limbs));
+                field.toMontgomery(x[j], x[j]);
+                acc[j] = field.zero();
+            }
+            for (size_t k = a.size(); k-- > 0;) {
+                std::memcpy(c.limbs, a[k], sizeof(c.limbs));
+                for (size_t j = 0; j < n; ++j) {
+                    field.mul(acc[j], acc[j], x[j]);
+                    field.add(acc[j], acc[j], c);
+                }
+                if (quotient && k > 0) std::memcpy(quotient + (k - 1) * N, acc[0].limbs, sizeof(acc[0].limbs));
+            }
+            for (size_t j = 0; j < n; ++j) std::memcpy(values + (first + j) * N, acc[j].limbs, sizeof(acc[j].limbs));
+        }
+    }
+};
+
+// Evaluates a at count reduced points, see HornerVisitor.
+void horner(ConstLimbView a, const BigInt& mod, const mp_limb_t* points, size_t count, mp_limb_t* values,
+            mp_limb_t* quotient) {
+    const size_t width = a.width();
+    if (mod.testBit(0) && mod.bitSize() > 1 && width <= MONTGOMERY_MAX_LIMBS) {
+        HornerVisitor visitor = {a, points, count, values, quotient, mod};
+        visitMontgomeryField(width, visitor);
+        return;
+    }
+    for (size_t j = 0; j < count; ++j) {
+        const BigInt x = BigInt::fromLimbs(points + j * width, width);
+        BigInt acc;
+        for (size_t k = a.size(); k-- > 0;) {
+            acc = addMod(mulMod(acc, x, mod), BigInt::fromLimbs(a[k], width), mod);
+            if (quotient && j == 0 && k > 0) acc.toLimbs(quotient + (k - 1) * width, width);
+        }
+        acc.toLimbs(values + j * width, width);
+    }
+}
+
+} // namespace
 
 Polynomial::Polynomial(const std::vector<std::string>& coeff_array, const std::string& modulusStr) {
-    mod = BigInt(modulusStr, 10);
-    for (const auto& coeff : coeff_array) {
-        coefficients.emplace_back(coeff, 10);
+    reset(BigInt(modulusStr, 10), coeff_array.size());
+    for (size_t i = 0; i < coeff_array.size(); ++i) {
+        setCoefficient(i, BigInt(coeff_array[i], 10));
     }
 }
 
+Polynomial::Polynomial(const std::vector<BigInt>& coeff_array, const BigInt& modulus) {
+    reset(modulus, coeff_array.size());
+    for (size_t i = 0; i < coeff_array.size(); ++i) {
+        setCoefficient(i, coeff_array[i]);
+    }
+}
+
+Polynomial::Polynomial(size_t size, const BigInt& modulus) {
+    reset(modulus, size);
+}
+
+void Polynomial::reset(const BigInt& modulus, size_t size) {
+    if (modulus.isZero() || modulus.isNegative()) {
+        throw std::invalid_argument("Modulus must be positive.");
+    }
+    mod = modulus;
+    limbsPerCoefficient = (mod.bitSize() + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS;
+    count = size;
+    LimbBuffer zero(count * limbsPerCoefficient);
+    limbs.swap(zero);
+}
+
 void Polynomial::print() const {
-    bool first = true;
-    for (size_t i = 0; i < coefficients.size(); ++i) {
-        if (!first) {
-            std::cout << (coefficients[i].isNegative() ? " - " : " + ");
-        } else if (coefficients[i].isNegative()) {
-            std::cout << "-";
+    for (size_t i = 0; i < count; ++i) {
+        if (i > 0) {
+            std::cout << " + ";
         }
-        first = false;
 
-        coefficients[i].printAbsolute();
+        coefficient(i).printAbsolute();
 
         if (i > 0) {
             std::cout << "*x^" << i;
@@ -31,76 +324,154 @@ void Polynomial::print() const {
 }
 
 int Polynomial::deg() const {
-    return coefficients.size() - 1;
+    return static_cast<int>(count) - 1;
+}
+
+BigInt Polynomial::coefficient(size_t i) const {
+    return BigInt::fromLimbs(coefficients()[i], limbsPerCoefficient);
 }
 
-std::vector<BigInt> Polynomial::getCoefficients() const {
-    return coefficients;
+void Polynomial::setCoefficient(size_t i, const BigInt& value) {
+    (value % mod).toLimbs(coefficients()[i], limbsPerCoefficient);
 }
 
-BigInt Polynomial::getMod() const {
+const BigInt& Polynomial::getMod() const {
     return mod;
 }
 
+BigInt Polynomial::evaluate(const BigInt& x) const {
+    std::vector<mp_limb_t> point(limbsPerCoefficient), value(limbsPerCoefficient);
+    (x % mod).toLimbs(point.data(), limbsPerCoefficient);
+    horner(coefficients(), mod, point.data(), 1, value.data(), nullptr);
+    return BigInt::fromLimbs(value.data(), limbsPerCoefficient);
+}
+
+std::vector<BigInt> Polynomial::evaluate(const std::vector<BigInt>& xs) const {
+    LimbBuffer points(xs.size() * limbsPerCoefficient), values(xs.size() * limbsPerCoefficient);
+    for (size_t j = 0; j < xs.size(); ++j) (xs[j] % mod).toLimbs(points.data() + j * limbsPerCoefficient, limbsPerCoefficient);
+    horner(coefficients(), mod, points.data(), xs.size(), values.data(), nullptr);
+    std::vector<BigInt> result;
+    result.reserve(xs.size());
+    for (size_t j = 0; j < xs.size(); ++j) {
+        result.push_back(BigInt::fromLimbs(values.data() + j * limbsPerCoefficient, limbsPerCoefficient));
+    }
+    return result;
+}
+
 void addPolynomials(Polynomial &result, const Polynomial &a, const Polynomial &b) {
+    addPolynomials(result, a, b, 1, POLYNOMIAL_GRAIN);
+}
+
+void addPolynomials(Polynomial &result, const Polynomial &a, const Polynomial &b, unsigned threads, size_t grain) {
     if (a.mod != b.mod) {
         throw std::invalid_argument("Moduli of the polynomials must be the same.");
     }
 
-    size_t max_degree = std::max(a.coefficients.size(), b.coefficients.size());
-    result.coefficients.resize(max_degree);
-    result.mod = a.mod; 
-
-    for (size_t i = 0; i < max_degree; ++i) {
-        BigInt sum = (i < a.coefficients.size() ? a.coefficients[i] : BigInt(static_cast<unsigned long int>(0))) +
-                     (i < b.coefficients.size() ? b.coefficients[i] : BigInt(static_cast<unsigned long int>(0)));
-        sum %= a.mod;
-        result.coefficients[i] = sum;
-    }
+    const Polynomial& longer = a.count >= b.count ? a : b;
+    const Polynomial& shorter = a.count >= b.count ? b : a;
+    const VecModulus m(a.mod);
+    const size_t width = a.limbsPerCoefficient;
+    Polynomial sum(longer);
+    forEachChunk(shorter.count, threads, grain, [&](size_t begin, size_t n) {
+        mp_limb_t* s = sum.limbs.data() + begin * width;
+        vecAddMod(s, s, shorter.limbs.data() + begin * width, n, m);
+    });
+    result = std::move(sum);
 }
 
 void subtractPolynomials(Polynomial &result, const Polynomial &a, const Polynomial &b) {
+    subtractPolynomials(result, a, b, 1, POLYNOMIAL_GRAIN);
+}
+
+void subtractPolynomials(Polynomial &result, const Polynomial &a, const Polynomial &b, unsigned threads, size_t grain) {
     if (a.mod != b.mod) {
         throw std::invalid_argument("Moduli of the polynomials must be the same.");
     }
 
-    size_t max_degree = std::max(a.coefficients.size(), b.coefficients.size());
-    result.coefficients.resize(max_degree);
-    result.mod = a.mod;  // Set the modulus for the result polynomial
-
-    for (size_t i = 0; i < max_degree; ++i) {
-        BigInt diff = (i < a.coefficients.size() ? a.coefficients[i] : BigInt(static_cast<unsigned long int>(0))) -
-                      (i < b.coefficients.size() ? b.coefficients[i] : BigInt(static_cast<unsigned long int>(0)));
-        diff %= a.mod;
-        result.coefficients[i] = diff;
-    }
+    // the overlap, then the tail of the longer operand against zero
+    const VecModulus m(a.mod);
+    const size_t width = a.limbsPerCoefficient;
+    const size_t common = std::min(a.count, b.count);
+    Polynomial diff(std::max(a.count, b.count), a.mod);
+    forEachChunk(diff.count, threads, grain, [&](size_t begin, size_t n) {
+        const size_t overlap = begin < common ? std::min(n, common - begin) : 0;
+        const size_t offset = begin * width;
+        vecSubMod(diff.limbs.data() + offset, a.limbs.data() + offset, b.limbs.data() + offset, overlap, m);
+        const size_t tail = (begin + overlap) * width, rest = n - overlap;
+        if (rest == 0) return;
+        if (a.count > common) {
+            std::memcpy(diff.limbs.data() + tail, a.limbs.data() + tail, rest * width * sizeof(mp_limb_t));
+        } else {
+            vecSubMod(diff.limbs.data() + tail, diff.limbs.data() + tail, b.limbs.data() + tail, rest, m);
+        }
+    });
+    result = std::move(diff);
 }
 
 void multiplyPolynomials(Polynomial &result, const Polynomial &a, const Polynomial &b) {
+    multiplyPolynomials(result, a, b, 1);
+}
+
+void multiplyPolynomials(Polynomial &result, const Polynomial &a, const Polynomial &b, unsigned threads) {
+    INSTRUMENT_PHASE(MultiplyPolynomials);
     if (a.mod != b.mod) {
         throw std::invalid_argument("Moduli of the polynomials must be the same.");
     }
 
-    size_t result_degree = a.coefficients.size() + b.coefficients.size() - 1;
-    result.coefficients.resize(result_degree, BigInt(static_cast<unsigned long int>(0)));
-    result.mod = a.mod;
-
-    for (size_t i = 0; i < a.coefficients.size(); ++i) {
-        for (size_t j = 0; j < b.coefficients.size(); ++j) {
-            result.coefficients[i + j] += a.coefficients[i] * b.coefficients[j];
-            result.coefficients[i + j] %= a.mod;
-        }
+    if (a.count == 0 || b.count == 0) {
+        result = Polynomial(static_cast<size_t>(0), a.mod);
+        return;
     }
+    const size_t width = a.limbsPerCoefficient;
+    const size_t productSize = a.count + b.count - 1;
+    const size_t smaller = std::min(a.count, b.count);
+    size_t nttSize = 1;
+    while (nttSize < productSize) nttSize <<= 1;
+
+    Polynomial product(productSize, a.mod);
+    std::vector<mp_limb_t> m(width);
+    a.mod.toLimbs(m.data(), width);
+
+    if (smaller < SCHOOLBOOK_THRESHOLD) {
+        schoolbookProduct(product.coefficients(), a.coefficients(), b.coefficients(), a.mod, m.data());
+    } else if (productSize >= NTT_THRESHOLD && width <= MONTGOMERY_MAX_LIMBS && nttFriendly(a.mod, nttSize)) {
+        std::unique_ptr<ThreadPool> local;
+        NttProductVisitor visitor = {product.coefficients(), a.coefficients(), b.coefficients(), a.mod, nttSize,
+                                     selectThreadPool(threads, local)};
+        visitMontgomeryField(width, visitor);
+    } else {
+        kroneckerProduct(product.coefficients(), a.coefficients(), b.coefficients(), a.mod, m.data());
+    }
+    result = std::move(product);
 }
 
 void multiplyPolynomialByScalar(Polynomial &result, const Polynomial &poly, const BigInt &scalar) {
-    result.coefficients.resize(poly.coefficients.size());
-    result.mod = poly.mod;
+    multiplyPolynomialByScalar(result, poly, scalar, 1, POLYNOMIAL_GRAIN);
+}
 
-    for (size_t i = 0; i < poly.coefficients.size(); ++i) {
-        result.coefficients[i] = poly.coefficients[i] * scalar;
-        result.coefficients[i] %= poly.mod;
+void multiplyPolynomialByScalar(Polynomial &result, const Polynomial &poly, const BigInt &scalar, unsigned threads,
+                                size_t grain) {
+    const size_t width = poly.limbsPerCoefficient;
+    const VecModulus m(poly.mod);
+    Polynomial scaled(poly.count, poly.mod);
+    std::vector<mp_limb_t> s(width);
+    (scalar % poly.mod).toLimbs(s.data(), width);
+
+    forEachChunk(poly.count, threads, grain, [&](size_t begin, size_t n) {
+        vecMulScalarMod(scaled.limbs.data() + begin * width, poly.limbs.data() + begin * width, s.data(), n, m);
+    });
+    result = std::move(scaled);
+}
+
+std::vector<BigInt> batchEvaluate(const std::vector<Polynomial>& polys, const BigInt& x, unsigned threads, size_t grain) {
+    std::vector<BigInt> values(polys.size());
+    if (threads == 1) {
+        for (size_t i = 0; i < polys.size(); ++i) values[i] = polys[i].evaluate(x);
+        return values;
     }
+    std::unique_ptr<ThreadPool> local;
+    selectThreadPool(threads, local).parallelFor(polys.size(), [&](size_t i) { values[i] = polys[i].evaluate(x); }, grain);
+    return values;
 }
 
 void dividePolynomialByScalar(Polynomial &result, const Polynomial &poly, const BigInt &scalar) {
@@ -108,67 +479,163 @@ void dividePolynomialByScalar(Polynomial &result, const Polynomial &poly, const
         throw std::invalid_argument("Division by zero is not allowed.");
     }
 
-    result.coefficients.resize(poly.coefficients.size());
-    result.mod = poly.mod;
-
-    for (size_t i = 0; i < poly.coefficients.size(); ++i) {
-        // Ensure scalar is invertible in mod before division
-        result.coefficients[i] = poly.coefficients[i] * scalar.modInverse(poly.mod);
-        result.coefficients[i] %= poly.mod;
-    }
+    // Ensure scalar is invertible in mod before division; one inversion serves every coefficient
+    const BigInt inverse = scalar.modInverse(poly.mod);
+    multiplyPolynomialByScalar(result, poly, inverse);
 }
 
-int main() {
-    std::vector<std::string> coeffs1 = {"1", "-2", "3","15"};
-    Polynomial poly1(coeffs1, "7");
-
-    std::cout << "Polynomial 1: ";
-    poly1.print();
-
-    std::vector<std::string> coeffs2 = {"-3", "4", "2"};
-    Polynomial poly2(coeffs2, "7");
-
-    std::cout << "Polynomial 2: ";
-    poly2.print();
+void dividePolynomials(Polynomial &quotient, Polynomial &remainder, const Polynomial &a, const Polynomial &b) {
+    dividePolynomials(quotient, remainder, a, b, 1);
+}
 
-    Polynomial result({}, "7");
+void dividePolynomials(Polynomial &quotient, Polynomial &remainder, const Polynomial &a, const Polynomial &b,
+                       unsigned threads) {
+    if (a.mod != b.mod) {
+        throw std::invalid_argument("Moduli of the polynomials must be the same.");
+    }
+    const size_t na = trimmedSize(a.coefficients());
+    const size_t nb = trimmedSize(b.coefficients());
+    if (nb == 0) {
+        throw std::invalid_argument("Division by the zero polynomial is not allowed.");
+    }
 
-    addPolynomials(result, poly1, poly2);
+    if (na < nb) {
+        Polynomial rem = truncated(a, nb - 1);
+        quotient = Polynomial(static_cast<size_t>(0), a.mod);
+        remainder = std::move(rem);
+        return;
+    }
+    const size_t m = na - nb + 1;
+    if (std::min(m, nb) < NEWTON_THRESHOLD) {
+        longDivision(quotient, remainder, a, na, b, nb);
+        return;
+    }
 
-    std::cout << "Result of addition: ";
-    result.print();
+    // rev(q) = rev(a) / rev(b) mod X^m, and only the low nb - 1 coefficients of q * b are needed
+    Polynomial quo = reversed(a, na, m);
+    multiplyPolynomials(quo, quo, inverseSeries(reversed(b, nb, m), m, threads), threads);
+    quo = reversed(quo, m, m);
+    Polynomial low(static_cast<size_t>(0), a.mod);
+    multiplyPolynomials(low, truncated(quo, nb - 1), truncated(b, nb - 1), threads);
+    Polynomial rem(static_cast<size_t>(0), a.mod);
+    subtractPolynomials(rem, truncated(a, nb - 1), truncated(low, nb - 1));
+    quotient = std::move(quo);
+    remainder = std::move(rem);
+}
 
-    subtractPolynomials(result, poly1, poly2);
+void derivePolynomial(Polynomial &result, const Polynomial &poly) {
+    const size_t width = poly.limbsPerCoefficient;
+    Polynomial derivative(poly.count > 0 ? poly.count - 1 : 0, poly.mod);
+    std::vector<mp_limb_t> m(width), t(width + 1);
+    poly.mod.toLimbs(m.data(), width);
+
+    LimbView d = derivative.coefficients();
+    ConstLimbView c = poly.coefficients();
+    Reducer reduce(m.data(), width, width + 1);
+    for (size_t i = 1; i < poly.count; ++i) {
+        t[width] = mpn_mul_1(t.data(), c[i], width, i);
+        reduce(d[i - 1], t.data());
+    }
+    result = std::move(derivative);
+}
 
-    std::cout << "Result of substraction: ";
-    result.print();
+void dividePolynomialByLinear(Polynomial &quotient, BigInt &remainder, const Polynomial &poly, const BigInt &z) {
+    const size_t width = poly.limbsPerCoefficient;
+    Polynomial quo(poly.count > 0 ? poly.count - 1 : 0, poly.mod);
+    std::vector<mp_limb_t> point(width), value(width);
+    (z % poly.mod).toLimbs(point.data(), width);
+    horner(poly.coefficients(), poly.mod, point.data(), 1, value.data(), quo.limbs.data());
+    quotient = std::move(quo);
+    remainder = BigInt::fromLimbs(value.data(), width);
+}
 
-    Polynomial result1({}, "7");
+void dividePolynomialByVanishing(Polynomial &quotient, Polynomial &remainder, const Polynomial &poly, size_t n) {
+    if (n == 0) {
+        throw std::invalid_argument("The vanishing polynomial must have a positive degree.");
+    }
+    const size_t width = poly.limbsPerCoefficient;
+    Polynomial folded(std::max(poly.count, n), poly.mod);
+    std::copy(poly.limbs.data(), poly.limbs.data() + poly.count * width, folded.limbs.data());
+
+    // X^n = 1, so coefficient j + n adds into j; folding from the top block down makes every
+    // block final before it is added, leaving the quotient above n and the remainder below
+    const VecModulus m(poly.mod);
+    mp_limb_t* t = folded.limbs.data();
+    for (size_t hi = folded.count; hi > n;) {
+        const size_t lo = std::max(n, hi - n);
+        vecAddMod(t + (lo - n) * width, t + (lo - n) * width, t + lo * width, hi - lo, m);
+        hi = lo;
+    }
 
-    multiplyPolynomials(result1, poly1, poly2);
+    Polynomial quo(folded.count - n, poly.mod), rem(n, poly.mod);
+    std::copy(t + n * width, t + folded.count * width, quo.limbs.data());
+    std::copy(t, t + n * width, rem.limbs.data());
+    quotient = std::move(quo);
+    remainder = std::move(rem);
+}
 
-    std::cout << "Result of multiplication: ";
-    result1.print();
+PolynomialAccumulator::PolynomialAccumulator(const BigInt& modulus) : mod(modulus), count(0) {
+    if (mod.isZero() || mod.isNegative()) {
+        throw std::invalid_argument("Modulus must be positive.");
+    }
+    width = (mod.bitSize() + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS;
+    slot = 2 * width + 1;
+    modLimbs = LimbBuffer(width);
+    mod.toLimbs(modLimbs.data(), width);
+}
 
+void PolynomialAccumulator::extend(const Polynomial& poly) {
+    if (poly.getMod() != mod) {
+        throw std::invalid_argument("Moduli of the polynomials must be the same.");
+    }
+    if (poly.size() <= count) return;
+    LimbBuffer wider(poly.size() * slot);
+    std::copy(sums.data(), sums.data() + count * slot, wider.data());
+    sums = std::move(wider);
+    count = poly.size();
+}
 
-    std::vector<std::string> coeffs = {"1", "2", "3"};
-    Polynomial poly(coeffs, "7"); // Modulus is 7
+void PolynomialAccumulator::add(const Polynomial& poly) {
+    extend(poly);
+    ConstLimbView c = poly.coefficients();
+    for (size_t k = 0; k < c.size(); ++k) {
+        mp_limb_t* sum = sums.data() + k * slot;
+        mpn_add(sum, sum, slot, c[k], width);
+    }
+}
 
-    // Define scalars for multiplication and division
-    BigInt scalarMult("2", 10);
-    BigInt scalarDiv("3", 10);
+void PolynomialAccumulator::add(const Polynomial& poly, const BigInt& scalar) {
+    extend(poly);
+    std::vector<mp_limb_t> s(width), t(2 * width);
+    (scalar % mod).toLimbs(s.data(), width);
+    ConstLimbView c = poly.coefficients();
+    for (size_t k = 0; k < c.size(); ++k) {
+        mp_limb_t* sum = sums.data() + k * slot;
+        mpn_mul_n(t.data(), c[k], s.data(), width);
+        sum[2 * width] += mpn_add_n(sum, sum, t.data(), 2 * width);
+    }
+}
 
-    // Test multiplication by scalar
-    Polynomial resultMult({}, "7");
-    multiplyPolynomialByScalar(resultMult, poly, scalarMult);
-    std::cout << "Result of multiplication by scalar: ";
-    resultMult.print();
+void PolynomialAccumulator::subtract(const Polynomial& poly) {
+    // adds mod - c, which is at most mod
+    extend(poly);
+    std::vector<mp_limb_t> t(width);
+    ConstLimbView c = poly.coefficients();
+    for (size_t k = 0; k < c.size(); ++k) {
+        mp_limb_t* sum = sums.data() + k * slot;
+        mpn_sub_n(t.data(), modLimbs.data(), c[k], width);
+        mpn_add(sum, sum, slot, t.data(), width);
+    }
+}
 
-    // Test division by scalar
-    Polynomial resultDiv({}, "7");
-    dividePolynomialByScalar(resultDiv, poly, scalarDiv);
-    std::cout << "Result of division by scalar: ";
-    resultDiv.print();
+void PolynomialAccumulator::subtract(const Polynomial& poly, const BigInt& scalar) {
+    add(poly, (mod - scalar % mod) % mod);
+}
 
-    return 0;
+Polynomial PolynomialAccumulator::result() const {
+    Polynomial sum(count, mod);
+    LimbView r = sum.coefficients();
+    Reducer reduce(modLimbs.data(), width, slot);
+    for (size_t k = 0; k < count; ++k) reduce(r[k], sums.data() + k * slot);
+    return sum;
 }
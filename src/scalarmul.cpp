@@ -0,0 +1,47 @@
+#include "../include/scalarmul.hpp"
+#include <stdexcept>
+
+std::vector<int> wnafRecode(const mp_limb_t* k, size_t n, unsigned w) {
+    if (w < WNAF_MIN_WIDTH || w > WNAF_MAX_WIDTH) {
+        throw std::invalid_argument("wNAF window width out of range.");
+    }
+
+    // Work on a copy with one spare limb: subtracting a negative digit can carry upwards.
+    std::vector<mp_limb_t> d(k, k + n);
+    d.push_back(0);
+    while (d.size() > 1 && d.back() == 0) d.pop_back();
+
+    const mp_limb_t window = static_cast<mp_limb_t>(1) << w;
+    const mp_limb_t mask = window - 1;
+    std::vector<int> digits;
+    digits.reserve(64 * n + 1);
+    while (d.size() > 1 || d[0] != 0) {
+        int digit = 0;
+        if (d[0] & 1) {
+            mp_limb_t low = d[0] & mask;
+            if (low >= (window >> 1)) {
+                digit = static_cast<int>(low) - static_cast<int>(window);
+                d.push_back(0);
+                mpn_add_1(d.data(), d.data(), d.size(), static_cast<mp_limb_t>(-digit));
+            } else {
+                digit = static_cast<int>(low);
+                mpn_sub_1(d.data(), d.data(), d.size(), low);
+            }
+        }
+        digits.push_back(digit);
+        mpn_rshift(d.data(), d.data(), d.size(), 1);
+        while (d.size() > 1 && d.back() == 0) d.pop_back();
+    }
+    return digits;
+}
+
+mp_limb_t scalarWindow(const mp_limb_t* k, size_t n, size_t pos, unsigned w) {
+    const size_t limb = pos / 64;
+    const unsigned shift = pos % 64;
+    if (limb >= n) return 0;
+    mp_limb_t bits = k[limb] >> shift;
+    if (shift + w > 64 && limb + 1 < n) {
+        bits |= k[limb + 1] << (64 - shift);
+    }
+    return bits & ((static_cast<mp_limb_t>(1) << w) - 1);
+}
@@ -0,0 +1,154 @@
+#include "../include/thread_pool.hpp"
+#include <algorithm>
+
+namespace {
+
+// Set while a thread executes loop iterations, so nested loops run inline.
+thread_local bool insideLoop = false;
+
+// Blocks are numbered in 32 bits so that a range fits in one atomic word.
+const size_t MAX_BLOCKS = 0xffffffffULL;
+
+uint64_t pack(size_t begin, size_t end) { return static_cast<uint64_t>(begin) | (static_cast<uint64_t>(end) << 32); }
+
+size_t rangeBegin(uint64_t range) { return static_cast<size_t>(range & 0xffffffffULL); }
+
+size_t rangeEnd(uint64_t range) { return static_cast<size_t>(range >> 32); }
+
+} // namespace
+
+ThreadPool::ThreadPool(unsigned threads)
+    : job(nullptr), jobCount(0), jobGrain(1), cancelled(false), generation(0), busy(0), stopping(false) {
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+    slots.reset(new Slot[threads]);
+    for (unsigned i = 0; i < threads; ++i) slots[i].range.store(0);
+    workers.reserve(threads - 1);
+    for (unsigned i = 1; i < threads; ++i) {
+        workers.push_back(std::thread(&ThreadPool::workerLoop, this, i));
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (size_t i = 0; i < workers.size(); ++i) workers[i].join();
+}
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& body, size_t grain) {
+    if (count == 0) return;
+    grain = std::max<size_t>(grain, 1);
+    if (workers.empty() || count <= grain || insideLoop) {
+        for (size_t i = 0; i < count; ++i) body(i);
+        return;
+    }
+    grain = std::max(grain, (count + MAX_BLOCKS - 1) / MAX_BLOCKS);
+
+    std::lock_guard<std::mutex> call(callMutex);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &body;
+        jobCount = count;
+        jobGrain = grain;
+        // an even share of the blocks for every thread to start from
+        const size_t blocks = (count + grain - 1) / grain, threads = size();
+        for (size_t t = 0; t < threads; ++t) slots[t].range.store(pack(blocks * t / threads, blocks * (t + 1) / threads));
+        cancelled.store(false);
+        error = nullptr;
+        busy = static_cast<unsigned>(workers.size());
+        ++generation;
+    }
+    wake.notify_all();
+
+    runBlocks(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this] { return busy == 0; });
+    job = nullptr;
+    if (error) {
+        std::exception_ptr e = error;
+        error = nullptr;
+        std::rethrow_exception(e);
+    }
+}
+
+void ThreadPool::workerLoop(unsigned slot) {
+    unsigned seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this, seen] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+
+        runBlocks(slot);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--busy == 0) finished.notify_one();
+    }
+}
+
+// Runs the blocks of its own range, then stolen ones, until no thread has any left;
+// the first exception cancels the rest.
+void ThreadPool::runBlocks(unsigned slot) {
+    insideLoop = true;
+    size_t block;
+    for (;;) {
+        if (!claim(slot, block)) {
+            if (steal(slot)) continue;
+            break;
+        }
+        if (cancelled.load(std::memory_order_relaxed)) break;
+        const size_t end = std::min(jobCount, (block + 1) * jobGrain);
+        try {
+            for (size_t i = block * jobGrain; i < end; ++i) (*job)(i);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error) error = std::current_exception();
+            cancelled.store(true);
+        }
+    }
+    insideLoop = false;
+}
+
+// Takes the first block of the thread's own range.
+bool ThreadPool::claim(unsigned slot, size_t& block) {
+    std::atomic<uint64_t>& range = slots[slot].range;
+    uint64_t r = range.load();
+    while (rangeBegin(r) < rangeEnd(r)) {
+        if (range.compare_exchange_weak(r, pack(rangeBegin(r) + 1, rangeEnd(r)))) {
+            block = rangeBegin(r);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Moves the back half of another thread's range into the thread's own, empty, range.
+// Blocks are only ever handed out once, so a stale range can never compare equal
+// again and the compare-and-swap needs no ABA protection.
+bool ThreadPool::steal(unsigned slot) {
+    const unsigned threads = size();
+    for (unsigned k = 1; k < threads; ++k) {
+        std::atomic<uint64_t>& victim = slots[(slot + k) % threads].range;
+        uint64_t r = victim.load();
+        while (rangeBegin(r) < rangeEnd(r)) {
+            const size_t begin = rangeBegin(r), end = rangeEnd(r);
+            const size_t split = end - (end - begin + 1) / 2;
+            if (victim.compare_exchange_weak(r, pack(begin, split))) {
+                slots[slot].range.store(pack(split, end));
+                return true;
+            }
+        }
+    }
+    return false;
+}
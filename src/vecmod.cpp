@@ -0,0 +1,519 @@
+#include "../include/vecmod.hpp"
+#include "../include/field.hpp"
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define VECMOD_X86 1
+#include <immintrin.h>
+// GCC 12 reports the _mm512_undefined_epi32() passthrough of the AVX-512 shifts
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+namespace {
+
+// -p^-1 mod 2^bits by Newton iteration, each step doubles the correct bits.
+uint64_t negInverse(mp_limb_t p0, unsigned bits) {
+    uint64_t inv = p0;
+    for (int i = 0; i < 5; ++i) inv *= 2 - p0 * inv;
+    return (0 - inv) & ((static_cast<uint64_t>(1) << bits) - 1);
+}
+
+// Splits the width-limb integer x into k digits of the given size.
+void splitDigits(uint64_t* out, const mp_limb_t* x, size_t width, unsigned bits, size_t k) {
+    const uint64_t mask = (static_cast<uint64_t>(1) << bits) - 1;
+    for (size_t j = 0, bit = 0; j < k; ++j, bit += bits) {
+        const size_t limb = bit / 64;
+        const unsigned shift = bit % 64;
+        uint64_t v = limb < width ? x[limb] >> shift : 0;
+        if (shift + bits > 64 && limb + 1 < width) v |= x[limb + 1] << (64 - shift);
+        out[j] = v & mask;
+    }
+}
+
+void digitsOf(uint64_t* out, const BigInt& x, unsigned bits, size_t k) {
+    std::vector<mp_limb_t> limbs((k * bits + 63) / 64 + 1);
+    x.toLimbs(limbs.data(), limbs.size());
+    splitDigits(out, limbs.data(), limbs.size(), bits, k);
+}
+
+// Reduces the n-limb value t (n >= width) modulo the width-limb modulus into r.
+void reduceLimbs(mp_limb_t* r, const mp_limb_t* t, size_t n, const mp_limb_t* m, size_t width) {
+    mp_limb_t q[2 * 64];
+    std::vector<mp_limb_t> big;
+    mp_limb_t* qp = q;
+    if (n - width + 1 > sizeof(q) / sizeof(q[0])) {
+        big.resize(n - width + 1);
+        qp = big.data();
+    }
+    mpn_tdiv_qr(qp, r, 0, t, n, m, width);
+}
+
+// Products of canonical operands with MontgomeryField<N>: mul(toMontgomery(a), b) = a * b.
+struct ScalarMulVisitor {
+    typedef void result_type;
+    mp_limb_t* r;
+    const mp_limb_t* a;
+    const mp_limb_t* b;
+    size_t count;
+    bool scalar;
+    const BigInt& mod;
+
+    template <size_t N>
+    void run() const {
+        typedef typename MontgomeryField<N>::Element Element;
+        const MontgomeryField<N> field(mod);
+        Element s;
+        if (scalar) {
+            std::memcpy(s.limbs, b, sizeof(s.limbs));
+            field.toMontgomery(s, s);
+        }
+        for (size_t i = 0; i < count; ++i) {
+            Element x, y;
+            std::memcpy(x.limbs, a + i * N, sizeof(x.limbs));
+            if (scalar) {
+                field.mul(x, x, s);
+            } else {
+                std::memcpy(y.limbs, b + i * N, sizeof(y.limbs));
+                field.toMontgomery(x, x);
+                field.mul(x, x, y);
+            }
+            std::memcpy(r + i * N, x.limbs, sizeof(x.limbs));
+        }
+    }
+};
+
+void scalarAdd(mp_limb_t* r, const mp_limb_t* a, const mp_limb_t* b, size_t count, const VecModulus& m) {
+    const size_t w = m.width();
+    std::vector<mp_limb_t> scratch(w);
+    for (size_t i = 0; i < count; ++i) {
+        mp_limb_t* ri = r + i * w;
+        mp_limb_t carry = mpn_add_n(ri, a + i * w, b + i * w, w);
+        mp_limb_t borrow = mpn_sub_n(scratch.data(), ri, m.data(), w);
+        if (carry || !borrow) std::memcpy(ri, scratch.data(), w * sizeof(mp_limb_t));
+    }
+}
+
+void scalarSub(mp_limb_t* r, const mp_limb_t* a, const mp_limb_t* b, size_t count, const VecModulus& m) {
+    const size_t w = m.width();
+    for (size_t i = 0; i < count; ++i) {
+        mp_limb_t* ri = r + i * w;
+        if (mpn_sub_n(ri, a + i * w, b + i * w, w)) mpn_add_n(ri, ri, m.data(), w);
+    }
+}
+
+void scalarMul(mp_limb_t* r, const mp_limb_t* a, const mp_limb_t* b, size_t count, const VecModulus& m, bool scalar) {
+    const size_t w = m.width();
+    if (m.odd() && w <= MONTGOMERY_MAX_LIMBS) {
+        ScalarMulVisitor visitor = {r, a, b, count, scalar, m.value()};
+        visitMontgomeryField(w, visitor);
+        return;
+    }
+    std::vector<mp_limb_t> t(2 * w);
+    for (size_t i = 0; i < count; ++i) {
+        mpn_mul_n(t.data(), a + i * w, scalar ? b : b + i * w, w);
+        reduceLimbs(r + i * w, t.data(), 2 * w, m.data(), w);
+    }
+}
+
+std::atomic<int>& selectedBackend() {
+    static std::atomic<int> backend(static_cast<int>(
+        vecBackendSupported(VecBackend::Avx512Ifma) ? VecBackend::Avx512Ifma :
+        vecBackendSupported(VecBackend::Avx2) ? VecBackend::Avx2 : VecBackend::Scalar));
+    return backend;
+}
+
+} // namespace
+
+#ifdef VECMOD_X86
+
+// The kernels below read the private constants of VecModulus.
+struct VecKernels {
+    // ---- AVX-512: add and subtract one element per register, limbs in lanes ----
+    //
+    // Carries between lanes are resolved on the compare masks with the carry-lookahead
+    // identity carriesIn = ((generate << 1) + propagate) ^ propagate, whose bit w is the
+    // carry out of the whole element.
+
+    __attribute__((target("avx512f")))
+    static void add512(mp_limb_t* r, const mp_limb_t* a, const mp_limb_t* b, size_t count, const VecModulus& m) {
+        const size_t w = m.width();
+        const __mmask8 lanes = static_cast<__mmask8>((1u << w) - 1);
+        const __m512i p = _mm512_maskz_loadu_epi64(lanes, m.data());
+        const __m512i ones = _mm512_set1_epi64(-1);
+        for (size_t i = 0; i < count; ++i) {
+            const __m512i x = _mm512_maskz_loadu_epi64(lanes, a + i * w);
+            const __m512i y = _mm512_maskz_loadu_epi64(lanes, b + i * w);
+            __m512i s = _mm512_add_epi64(x, y);
+            unsigned gen = _mm512_mask_cmplt_epu64_mask(lanes, s, x);
+            unsigned prop = _mm512_mask_cmpeq_epi64_mask(lanes, s, ones);
+            unsigned carries = ((gen << 1) + prop) ^ prop;
+            s = _mm512_mask_sub_epi64(s, static_cast<__mmask8>(carries), s, ones);
+
+            __m512i d = _mm512_sub_epi64(s, p);
+            unsigned bgen = _mm512_mask_cmplt_epu64_mask(lanes, s, p);
+            unsigned bprop = _mm512_mask_cmpeq_epi64_mask(lanes, s, p);
+            unsigned borrows = ((bgen << 1) + bprop) ^ bprop;
+            d = _mm512_mask_add_epi64(d, static_cast<__mmask8>(borrows), d, ones);
+
+            // branch free select, random operands would mispredict half the time
+            const unsigned reduce = ((carries >> w) | ~(borrows >> w)) & 1;
+            const __mmask8 pick = static_cast<__mmask8>(0 - reduce);
+            _mm512_mask_storeu_epi64(r + i * w, lanes, _mm512_mask_blend_epi64(pick, s, d));
+        }
+    }
+
+    __attribute__((target("avx512f")))
+    static void sub512(mp_limb_t* r, const mp_limb_t* a, const mp_limb_t* b, size_t count, const VecModulus& m) {
+        const size_t w = m.width();
+        const __mmask8 lanes = static_cast<__mmask8>((1u << w) - 1);
+        const __m512i p = _mm512_maskz_loadu_epi64(lanes, m.data());
+        const __m512i ones = _mm512_set1_epi64(-1);
+        for (size_t i = 0; i < count; ++i) {
+            const __m512i x = _mm512_maskz_loadu_epi64(lanes, a + i * w);
+            const __m512i y = _mm512_maskz_loadu_epi64(lanes, b + i * w);
+            __m512i d = _mm512_sub_epi64(x, y);
+            unsigned bgen = _mm512_mask_cmplt_epu64_mask(lanes, x, y);
+            unsigned bprop = _mm512_mask_cmpeq_epi64_mask(lanes, x, y);
+            unsigned borrows = ((bgen << 1) + bprop) ^ bprop;
+            d = _mm512_mask_add_epi64(d, static_cast<__mmask8>(borrows), d, ones);
+
+            // add p back if the difference wrapped below zero, dropping the carry out
+            const __m512i q = _mm512_maskz_mov_epi64(static_cast<__mmask8>(0 - ((borrows >> w) & 1)), p);
+            __m512i s = _mm512_add_epi64(d, q);
+            unsigned gen = _mm512_mask_cmplt_epu64_mask(lanes, s, d);
+            unsigned prop = _mm512_mask_cmpeq_epi64_mask(lanes, s, ones);
+            unsigned carries = ((gen << 1) + prop) ^ prop;
+            s = _mm512_mask_sub_epi64(s, static_cast<__mmask8>(carries), s, ones);
+            _mm512_mask_storeu_epi64(r + i * w, lanes, s);
+        }
+    }
+
+    // ---- AVX-512 IFMA: Montgomery multiplication of eight elements, 52-bit digits in lanes ----
+
+    template <size_t K>
+    __attribute__((target("avx512f,avx512ifma"), always_inline))
+    static inline void montMul52(__m512i* r, const __m512i* a, const __m512i* b, const __m512i* p, __m512i pInv) {
+        const __m512i mask = _mm512_set1_epi64((static_cast<long long>(1) << 52) - 1);
+        const __m512i zero = _mm512_setzero_si512();
+        __m512i t[K + 1];
+        for (size_t j = 0; j <= K; ++j) t[j] = zero;
+
+        // CIOS: digit products are split into their low and high 52 bits, the
+        // accumulators stay below 2^58 so no intermediate normalization is needed.
+        for (size_t i = 0; i < K; ++i) {
+            for (size_t j = 0; j < K; ++j) {
+                t[j] = _mm512_madd52lo_epu64(t[j], a[j], b[i]);
+                t[j + 1] = _mm512_madd52hi_epu64(t[j + 1], a[j], b[i]);
+            }
+            const __m512i q = _mm512_and_si512(_mm512_madd52lo_epu64(zero, t[0], pInv), mask);
+            for (size_t j = 0; j < K; ++j) {
+                t[j] = _mm512_madd52lo_epu64(t[j], p[j], q);
+                t[j + 1] = _mm512_madd52hi_epu64(t[j + 1], p[j], q);
+            }
+            t[1] = _mm512_add_epi64(t[1], _mm512_srli_epi64(t[0], 52));
+            for (size_t j = 0; j < K; ++j) t[j] = t[j + 1];
+            t[K] = zero;
+        }
+
+        // normalize, then subtract p once if the result is not below it
+        for (size_t j = 0; j + 1 < K; ++j) {
+            t[j + 1] = _mm512_add_epi64(t[j + 1], _mm512_srli_epi64(t[j], 52));
+            t[j] = _mm512_and_si512(t[j], mask);
+        }
+        __m512i d[K];
+        __m512i borrow = zero;
+        for (size_t j = 0; j < K; ++j) {
+            d[j] = _mm512_sub_epi64(_mm512_sub_epi64(t[j], p[j]), borrow);
+            borrow = _mm512_srli_epi64(d[j], 63);
+            d[j] = _mm512_and_si512(d[j], mask);
+        }
+        const __mmask8 keep = _mm512_cmpneq_epi64_mask(borrow, zero);
+        for (size_t j = 0; j < K; ++j) r[j] = _mm512_mask_blend_epi64(keep, d[j], t[j]);
+    }
+
+    // Gathers the limbs of eight elements, x + lane[l] for lane l, into K digit registers.
+    template <size_t K>
+    __attribute__((target("avx512f"), always_inline))
+    static inline void loadDigits52(__m512i* d, const mp_limb_t* x, size_t w, __m512i lane, __mmask8 lanes) {
+        const __m512i mask = _mm512_set1_epi64((static_cast<long long>(1) << 52) - 1);
+        const __m512i zero = _mm512_setzero_si512();
+        const long long* base = reinterpret_cast<const long long*>(x);
+        for (size_t j = 0; j < K; ++j) {
+            const size_t limb = 52 * j / 64;
+            const unsigned shift = 52 * j % 64;
+            __m512i v = _mm512_srli_epi64(_mm512_mask_i64gather_epi64(zero, lanes, lane, base + limb, 8), shift);
+            if (shift > 12 && limb + 1 < w) {
+                const __m512i hi = _mm512_mask_i64gather_epi64(zero, lanes, lane, base + limb + 1, 8);
+                v = _mm512_or_si512(v, _mm512_slli_epi64(hi, 64 - shift));
+            }
+            d[j] = _mm512_and_si512(v, mask);
+        }
+    }
+
+    // Inverse of loadDigits52() for normalized digits, scattering the limbs back.
+    template <size_t K>
+    __attribute__((target("avx512f"), always_inline))
+    static inline void storeDigits52(mp_limb_t* x, const __m512i* d, size_t w, __m512i lane, __mmask8 lanes) {
+        long long* base = reinterpret_cast<long long*>(x);
+        for (size_t i = 0; i < w; ++i) {
+            __m512i v = _mm512_setzero_si512();
+            for (size_t j = 64 * i / 52; j < K && 52 * j < 64 * (i + 1); ++j) {
+                const long long offset = static_cast<long long>(52 * j) - static_cast<long long>(64 * i);
+                v = _mm512_or_si512(v, offset >= 0 ? _mm512_slli_epi64(d[j], static_cast<unsigned>(offset))
+                                                   : _mm512_srli_epi64(d[j], static_cast<unsigned>(-offset)));
+            }
+            _mm512_mask_i64scatter_epi64(base + i, lanes, lane, v, 8);
+        }
+    }
+
+    template <size_t K>
+    __attribute__((target("avx512f,avx512ifma")))
+    static void mul52(mp_limb_t* r, const mp_limb_t* a, const mp_limb_t* b, size_t count, const VecModulus& m, bool scalar) {
+        const size_t w = m.width();
+        __m512i p[K], rr[K], s[K];
+        for (size_t j = 0; j < K; ++j) {
+            p[j] = _mm512_set1_epi64(static_cast<long long>(m.p52[j]));
+            rr[j] = _mm512_set1_epi64(static_cast<long long>(m.rr52[j]));
+        }
+        const __m512i pInv = _mm512_set1_epi64(static_cast<long long>(m.pInv52));
+        if (scalar) {
+            // s * R mod p, so that one Montgomery product a * sR * R^-1 gives a * s
+            uint64_t digits[K];
+            splitDigits(digits, b, w, 52, K);
+            for (size_t j = 0; j < K; ++j) s[j] = _mm512_set1_epi64(static_cast<long long>(digits[j]));
+            montMul52<K>(s, s, rr, p, pInv);
+        }
+
+        const long long ww = static_cast<long long>(w);
+        const __m512i lane = _mm512_set_epi64(7 * ww, 6 * ww, 5 * ww, 4 * ww, 3 * ww, 2 * ww, ww, 0);
+        for (size_t base = 0; base < count; base += 8) {
+            const size_t n = count - base < 8 ? count - base : 8;
+            const __mmask8 lanes = static_cast<__mmask8>((1u << n) - 1);
+            __m512i u[K], v[K];
+            loadDigits52<K>(u, a + base * w, w, lane, lanes);
+            if (scalar) {
+                montMul52<K>(u, u, s, p, pInv);
+            } else {
+                loadDigits52<K>(v, b + base * w, w, lane, lanes);
+                montMul52<K>(u, u, v, p, pInv);
+                montMul52<K>(u, u, rr, p, pInv);
+            }
+            storeDigits52<K>(r + base * w, u, w, lane, lanes);
+        }
+    }
+
+    // ---- AVX2: add and subtract, up to eight limbs in two registers ----
+
+    __attribute__((target("avx2")))
+    static inline unsigned lessMask256(__m256i x, __m256i y) {
+        const __m256i sign = _mm256_set1_epi64x(static_cast<long long>(0x8000000000000000ULL));
+        const __m256i lt = _mm256_cmpgt_epi64(_mm256_xor_si256(y, sign), _mm256_xor_si256(x, sign));
+        return static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(lt)));
+    }
+
+    __attribute__((target("avx2")))
+    static inline unsigned equalMask256(__m256i x, __m256i y) {
+        return static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(x, y))));
+    }
+
+    // One lane per set bit of bits, as 64-bit ones.
+    __attribute__((target("avx2")))
+    static inline __m256i laneBits256(unsigned bits) {
+        const __m256i shifts = _mm256_set_epi64x(3, 2, 1, 0);
+        const __m256i v = _mm256_srlv_epi64(_mm256_set1_epi64x(bits), shifts);
+        return _mm256_and_si256(v, _mm256_set1_epi64x(1));
+    }
+
+    struct Lanes256 {
+        __m256i lo, hi;
+    };
+
+    __attribute__((target("avx2")))
+    static inline Lanes256 load256(const mp_limb_t* x, __m256i maskLo, __m256i maskHi) {
+        Lanes256 v;
+        v.lo = _mm256_maskload_epi64(reinterpret_cast<const long long*>(x), maskLo);
+        v.hi = _mm256_maskload_epi64(reinterpret_cast<const long long*>(x + 4), maskHi);
+        return v;
+    }
+
+    __attribute__((target("avx2")))
+    static inline void laneMasks(size_t w, __m256i& maskLo, __m256i& maskHi) {
+        const __m256i idx = _mm256_set_epi64x(3, 2, 1, 0);
+        maskLo = _mm256_cmpgt_epi64(_mm256_set1_epi64x(static_cast<long long>(w)), idx);
+        maskHi = _mm256_cmpgt_epi64(_mm256_set1_epi64x(static_cast<long long>(w) - 4), idx);
+    }
+
+    // s = x + y + carries, returns the lookahead carry mask with the carry out at bit w
+    __attribute__((target("avx2")))
+    static inline unsigned add256(Lanes256& s, const Lanes256& x, const Lanes256& y, unsigned valid) {
+        const __m256i ones = _mm256_set1_epi64x(-1);
+        s.lo = _mm256_add_epi64(x.lo, y.lo);
+        s.hi = _mm256_add_epi64(x.hi, y.hi);
+        unsigned gen = (lessMask256(s.lo, x.lo) | (lessMask256(s.hi, x.hi) << 4)) & valid;
+        unsigned prop = (equalMask256(s.lo, ones) | (equalMask256(s.hi, ones) << 4)) & valid;
+        unsigned carries = ((gen << 1) + prop) ^ prop;
+        s.lo = _mm256_add_epi64(s.lo, laneBits256(carries & 0xf));
+        s.hi = _mm256_add_epi64(s.hi, laneBits256((carries >> 4) & 0xf));
+        return carries;
+    }
+
+    // d = x - y - borrows, returns the lookahead borrow mask with the borrow out at bit w
+    __attribute__((target("avx2")))
+    static inline unsigned sub256(Lanes256& d, const Lanes256& x, const Lanes256& y, unsigned valid) {
+        d.lo = _mm256_sub_epi64(x.lo, y.lo);
+        d.hi = _mm256_sub_epi64(x.hi, y.hi);
+        unsigned gen = (lessMask256(x.lo, y.lo) | (lessMask256(x.hi, y.hi) << 4)) & valid;
+        unsigned prop = (equalMask256(x.lo, y.lo) | (equalMask256(x.hi, y.hi) << 4)) & valid;
+        unsigned borrows = ((gen << 1) + prop) ^ prop;
+        d.lo = _mm256_sub_epi64(d.lo, laneBits256(borrows & 0xf));
+        d.hi = _mm256_sub_epi64(d.hi, laneBits256((borrows >> 4) & 0xf));
+        return borrows;
+    }
+
+    __attribute__((target("avx2")))
+    static void addAvx2(mp_limb_t* r, const mp_limb_t* a, const mp_limb_t* b, size_t count, const VecModulus& m) {
+        const size_t w = m.width();
+        const unsigned valid = (1u << w) - 1;
+        __m256i maskLo, maskHi;
+        laneMasks(w, maskLo, maskHi);
+        const Lanes256 p = load256(m.data(), maskLo, maskHi);
+        for (size_t i = 0; i < count; ++i) {
+            Lanes256 s, d;
+            unsigned carries = add256(s, load256(a + i * w, maskLo, maskHi), load256(b + i * w, maskLo, maskHi), valid);
+            unsigned borrows = sub256(d, s, p, valid);
+            const __m256i pick = _mm256_set1_epi64x(-static_cast<long long>(((carries >> w) | ~(borrows >> w)) & 1));
+            _mm256_maskstore_epi64(reinterpret_cast<long long*>(r + i * w), maskLo, _mm256_blendv_epi8(s.lo, d.lo, pick));
+            _mm256_maskstore_epi64(reinterpret_cast<long long*>(r + i * w + 4), maskHi, _mm256_blendv_epi8(s.hi, d.hi, pick));
+        }
+    }
+
+    __attribute__((target("avx2")))
+    static void subAvx2(mp_limb_t* r, const mp_limb_t* a, const mp_limb_t* b, size_t count, const VecModulus& m) {
+        const size_t w = m.width();
+        const unsigned valid = (1u << w) - 1;
+        __m256i maskLo, maskHi;
+        laneMasks(w, maskLo, maskHi);
+        const Lanes256 p = load256(m.data(), maskLo, maskHi);
+        for (size_t i = 0; i < count; ++i) {
+            Lanes256 d;
+            unsigned borrows = sub256(d, load256(a + i * w, maskLo, maskHi), load256(b + i * w, maskLo, maskHi), valid);
+            const __m256i wrap = _mm256_set1_epi64x(-static_cast<long long>((borrows >> w) & 1));
+            Lanes256 q, s;
+            q.lo = _mm256_and_si256(p.lo, wrap);
+            q.hi = _mm256_and_si256(p.hi, wrap);
+            add256(s, d, q, valid);
+            _mm256_maskstore_epi64(reinterpret_cast<long long*>(r + i * w), maskLo, s.lo);
+            _mm256_maskstore_epi64(reinterpret_cast<long long*>(r + i * w + 4), maskHi, s.hi);
+        }
+    }
+
+    // Runs the IFMA kernel if the backend and the modulus allow it; digits52 is 0 for even moduli.
+    static bool mul(VecBackend backend, mp_limb_t* r, const mp_limb_t* a, const mp_limb_t* b, size_t count,
+                    const VecModulus& m, bool scalar) {
+        if (backend == VecBackend::Avx512Ifma) {
+            switch (m.digits52) {
+                case 1: mul52<1>(r, a, b, count, m, scalar); return true;
+                case 2: mul52<2>(r, a, b, count, m, scalar); return true;
+                case 3: mul52<3>(r, a, b, count, m, scalar); return true;
+                case 4: mul52<4>(r, a, b, count, m, scalar); return true;
+                case 5: mul52<5>(r, a, b, count, m, scalar); return true;
+                case 6: mul52<6>(r, a, b, count, m, scalar); return true;
+                case 7: mul52<7>(r, a, b, count, m, scalar); return true;
+                case 8: mul52<8>(r, a, b, count, m, scalar); return true;
+                case 9: mul52<9>(r, a, b, count, m, scalar); return true;
+                case 10: mul52<10>(r, a, b, count, m, scalar); return true;
+            }
+        }
+        return false;
+    }
+};
+
+#endif // VECMOD_X86
+
+bool vecBackendSupported(VecBackend backend) {
+    switch (backend) {
+        case VecBackend::Scalar:
+            return true;
+#ifdef VECMOD_X86
+        case VecBackend::Avx2:
+            return __builtin_cpu_supports("avx2");
+        case VecBackend::Avx512Ifma:
+            return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512ifma");
+#else
+        default:
+            return false;
+#endif
+    }
+    return false;
+}
+
+VecBackend vecBackend() {
+    return static_cast<VecBackend>(selectedBackend().load());
+}
+
+void setVecBackend(VecBackend backend) {
+    if (!vecBackendSupported(backend)) {
+        throw std::invalid_argument("Vector backend not supported on this CPU.");
+    }
+    selectedBackend().store(static_cast<int>(backend));
+}
+
+VecModulus::VecModulus(const BigInt& modulus) : mod(modulus), digits52(0), pInv52(0) {
+    if (modulus.isZero() || modulus.isNegative()) {
+        throw std::invalid_argument("Modulus must be positive.");
+    }
+    limbs.resize((modulus.bitSize() + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS);
+    modulus.toLimbs(limbs.data(), limbs.size());
+    if (!odd()) return;
+
+    const size_t bits = modulus.bitSize();
+    const BigInt one(static_cast<unsigned long int>(1));
+    if ((bits + 51) / 52 <= MAX_DIGITS_52) {
+        digits52 = (bits + 51) / 52;
+        digitsOf(p52, modulus, 52, digits52);
+        pInv52 = negInverse(limbs[0], 52);
+        digitsOf(rr52, one.leftShift(2 * 52 * digits52) % modulus, 52, digits52);
+    }
+}
+
+void vecAddMod(mp_limb_t* r, const mp_limb_t* a, const mp_limb_t* b, size_t count, const VecModulus& m) {
+#ifdef VECMOD_X86
+    if (m.width() <= 8) {
+        switch (vecBackend()) {
+            case VecBackend::Avx512Ifma: VecKernels::add512(r, a, b, count, m); return;
+            case VecBackend::Avx2: VecKernels::addAvx2(r, a, b, count, m); return;
+            case VecBackend::Scalar: break;
+        }
+    }
+#endif
+    scalarAdd(r, a, b, count, m);
+}
+
+void vecSubMod(mp_limb_t* r, const mp_limb_t* a, const mp_limb_t* b, size_t count, const VecModulus& m) {
+#ifdef VECMOD_X86
+    if (m.width() <= 8) {
+        switch (vecBackend()) {
+            case VecBackend::Avx512Ifma: VecKernels::sub512(r, a, b, count, m); return;
+            case VecBackend::Avx2: VecKernels::subAvx2(r, a, b, count, m); return;
+            case VecBackend::Scalar: break;
+        }
+    }
+#endif
+    scalarSub(r, a, b, count, m);
+}
+
+void vecMulMod(mp_limb_t* r, const mp_limb_t* a, const mp_limb_t* b, size_t count, const VecModulus& m) {
+#ifdef VECMOD_X86
+    if (VecKernels::mul(vecBackend(), r, a, b, count, m, false)) return;
+#endif
+    scalarMul(r, a, b, count, m, false);
+}
+
+void vecMulScalarMod(mp_limb_t* r, const mp_limb_t* a, const mp_limb_t* s, size_t count, const VecModulus& m) {
+#ifdef VECMOD_X86
+    if (VecKernels::mul(vecBackend(), r, a, s, count, m, true)) return;
+#endif
+    scalarMul(r, a, s, count, m, true);
+}
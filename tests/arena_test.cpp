@@ -0,0 +1,146 @@
+#include "../include/arena.hpp"
+#include <gmp.h>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+// Fills the first chunk of an arena exactly, opens the next one with a small
+// block and frees or grows across the boundary. The top block of the old
+// chunk ends where the new chunk starts at offset 0, and must not be taken
+// for the top block of the new chunk.
+
+namespace {
+
+int failures = 0;
+
+void check(bool ok, const char* what) {
+    if (!ok) {
+        std::cerr << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+struct Gmp {
+    void* (*allocate)(size_t);
+    void* (*reallocate)(void*, size_t, size_t);
+    void (*free)(void*, size_t);
+
+    Gmp() { mp_get_memory_functions(&allocate, &reallocate, &free); }
+};
+
+// A chunk filled exactly by three 64 KiB blocks, a filler and 32 bytes, and a
+// 32-byte block opening the chunk right after it.
+struct Boundary {
+    void* blocks[4];
+    size_t filler;
+    void* last;
+    void* next;
+};
+
+void freeFill(const Gmp& gmp, const Boundary& b) {
+    for (int i = 3; i >= 0; --i) gmp.free(b.blocks[i], i == 3 ? b.filler : 1 << 16);
+}
+
+// Recycled chunks need not be adjacent, so fill until the next chunk starts where the filled one ends.
+// The arena must be fresh: the first attempt starts at offset 0, every retry after the block of the last one.
+bool openBoundary(const Gmp& gmp, Boundary& b, std::vector<Boundary>& discarded) {
+    for (int attempt = 0; attempt < 16; ++attempt) {
+        b.filler = attempt == 0 ? 65504 : 65472;
+        for (int i = 0; i < 3; ++i) b.blocks[i] = gmp.allocate(1 << 16);
+        b.blocks[3] = gmp.allocate(b.filler);
+        b.last = gmp.allocate(32);
+        b.next = gmp.allocate(32);
+        if (b.next == static_cast<char*>(b.last) + 32) return true;
+        discarded.push_back(b);
+    }
+    return false;
+}
+
+void freeDiscarded(const Gmp& gmp, const std::vector<Boundary>& discarded) {
+    for (size_t i = discarded.size(); i-- > 0;) {
+        gmp.free(discarded[i].next, 32);
+        gmp.free(discarded[i].last, 32);
+        freeFill(gmp, discarded[i]);
+    }
+}
+
+void testRewindAcrossChunks() {
+    Gmp gmp;
+    BigIntArena arena;
+    Boundary b;
+    std::vector<Boundary> discarded;
+    check(openBoundary(gmp, b, discarded), "no adjacent chunks for the rewind test");
+
+    gmp.free(b.next, 32);
+    gmp.free(b.last, 32);
+    void* again = gmp.allocate(32);
+    check(again != b.last, "rewind reuses a freed block of the previous chunk");
+    check(again == b.next, "rewind reuses the top block of the open chunk");
+
+    gmp.free(again, 32);
+    freeFill(gmp, b);
+    freeDiscarded(gmp, discarded);
+}
+
+void testGrowAcrossChunks() {
+    Gmp gmp;
+    BigIntArena arena;
+    Boundary b;
+    std::vector<Boundary> discarded;
+    check(openBoundary(gmp, b, discarded), "no adjacent chunks for the grow test");
+    gmp.free(b.next, 32);
+
+    std::memset(b.last, 0x5a, 32);
+    void* grown = gmp.reallocate(b.last, 32, 64);
+    check(grown != b.last, "grow extends a block of the previous chunk in place");
+    const unsigned char* bytes = static_cast<const unsigned char*>(grown);
+    bool kept = true;
+    for (int i = 0; i < 32; ++i) kept = kept && bytes[i] == 0x5a;
+    check(kept, "grow keeps the contents of a moved block");
+
+    gmp.free(grown, 64);
+    freeFill(gmp, b);
+    freeDiscarded(gmp, discarded);
+}
+
+// The reported corruption: a value whose chunk is recycled by another arena while it is live.
+void testValueSurvivesRecycling() {
+    Gmp gmp;
+    mpz_t value;
+    {
+        BigIntArena arena;
+        Boundary b;
+        std::vector<Boundary> discarded;
+        check(openBoundary(gmp, b, discarded), "no adjacent chunks for the recycling test");
+        gmp.free(b.next, 32);
+        gmp.free(b.last, 32);
+        mpz_init(value);
+        mpz_setbit(value, 255);
+        freeFill(gmp, b);
+        freeDiscarded(gmp, discarded);
+    }
+    {
+        BigIntArena other;
+        for (int i = 0; i < 64; ++i) std::memset(gmp.allocate(1 << 14), 0xff, 1 << 14);
+    }
+    mpz_t expected;
+    mpz_init(expected);
+    mpz_setbit(expected, 255);
+    check(mpz_cmp(value, expected) == 0, "a live value is overwritten after its chunk is recycled");
+    mpz_clear(expected);
+    mpz_clear(value);
+}
+
+} // namespace
+
+int main() {
+    if (!BigIntArena::install()) {
+        std::cout << "arena unavailable, skipped" << std::endl;
+        return 0;
+    }
+    testRewindAcrossChunks();
+    testGrowAcrossChunks();
+    testValueSurvivesRecycling();
+    if (failures == 0) std::cout << "arena tests passed" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
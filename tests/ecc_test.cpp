@@ -0,0 +1,277 @@
+#include "../include/ecc.hpp"
+#include "test_common.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+// Point arithmetic and SEC1 encodings on every supported curve against a textbook affine reference in BigInt.
+
+namespace {
+
+const CurveId CURVES[] = {CurveId::P256, CurveId::Secp256k1, CurveId::P521};
+
+// An affine point of the reference arithmetic.
+struct RefPoint {
+    BigInt x, y;
+    bool infinity;
+};
+
+RefPoint refAdd(const RefPoint& P, const RefPoint& Q, const CurveParameters& c) {
+    if (P.infinity) return Q;
+    if (Q.infinity) return P;
+    BigInt lambda;
+    if (P.x == Q.x) {
+        if (!(P.y == Q.y) || P.y == BigInt()) return RefPoint{BigInt(), BigInt(), true};
+        // (3x^2 + a) / 2y
+        const BigInt num = addMod(mulMod(BigInt(3UL), mulMod(P.x, P.x, c.p), c.p), c.a, c.p);
+        lambda = mulMod(num, addMod(P.y, P.y, c.p).modInverse(c.p), c.p);
+    } else {
+        lambda = mulMod(subMod(Q.y, P.y, c.p), subMod(Q.x, P.x, c.p).modInverse(c.p), c.p);
+    }
+    RefPoint R;
+    R.infinity = false;
+    R.x = subMod(subMod(mulMod(lambda, lambda, c.p), P.x, c.p), Q.x, c.p);
+    R.y = subMod(mulMod(lambda, subMod(P.x, R.x, c.p), c.p), P.y, c.p);
+    return R;
+}
+
+// Double and add from the most significant bit.
+RefPoint refMul(const RefPoint& P, const BigInt& k, const CurveParameters& c) {
+    RefPoint R = {BigInt(), BigInt(), true};
+    for (size_t i = k.bitSize(); i-- > 0;) {
+        R = refAdd(R, R, c);
+        if (k.testBit(i)) R = refAdd(R, P, c);
+    }
+    return R;
+}
+
+RefPoint refOf(const Ecc_Point& P) {
+    RefPoint R = {P.getX(), P.getY(), P.isInfinity};
+    return R;
+}
+
+bool same(const Ecc_Point& P, const RefPoint& R) {
+    if (P.isInfinity || R.infinity) return P.isInfinity == R.infinity;
+    return P.getX() == R.x && P.getY() == R.y;
+}
+
+// Random scalars below n and the edge cases around 0 and n.
+std::vector<BigInt> testScalars(const BigInt& n) {
+    std::vector<BigInt> scalars = randomVector(4, n);
+    scalars.push_back(BigInt());
+    scalars.push_back(BigInt(1UL));
+    scalars.push_back(BigInt(2UL));
+    scalars.push_back(n - BigInt(1UL));
+    scalars.push_back(n);
+    scalars.push_back(n + BigInt(1UL));
+    scalars.push_back(BigInt(1UL).leftShift(n.bitSize()) - BigInt(1UL));
+    return scalars;
+}
+
+void testConstantTimeMultiplication() {
+    for (CurveId id : CURVES) {
+        const CurveParameters& c = CurveContext::instance(id).params();
+        const Ecc_Point G = Ecc_Point::generator(id);
+        const RefPoint base = refMul(refOf(G), randomBelow(c.n), c);
+        const Ecc_Point P(base.x, base.y, id);
+        bool ladder = true, table = true, fast = true;
+        for (const BigInt& k : testScalars(c.n)) {
+            const RefPoint expected = refMul(refOf(P), k, c);
+            ladder = ladder && same(P.multiply(k, ScalarMulMode::ConstantTime), expected);
+            fast = fast && same(P.multiply(k, ScalarMulMode::Fast), expected);
+            table = table && same(Ecc_Point::multiplyGenerator(k, id, ScalarMulMode::ConstantTime),
+                                  refMul(refOf(G), k, c));
+        }
+        check(ladder, "constant-time ladder against double and add");
+        check(fast, "wNAF multiplication against double and add");
+        check(table, "constant-time generator table against double and add");
+        check(Ecc_Point(id).multiply(randomBelow(c.n), ScalarMulMode::ConstantTime).isInfinity,
+              "constant-time multiple of the point at infinity");
+    }
+}
+
+void testCoordinates() {
+    for (CurveId id : CURVES) {
+        const CurveParameters& c = CurveContext::instance(id).params();
+        const RefPoint R = refMul(refOf(Ecc_Point::generator(id)), randomBelow(c.n), c);
+        const Ecc_Point P(R.x, R.y, id);
+        check(P.getX() == R.x && P.getY() == R.y && P.getCurve().limbs() * 64 >= c.p.bitSize(),
+              "coordinates read back from the field elements");
+        check(Ecc_Point(R.x + c.p, R.y - c.p, id) == P, "coordinates are reduced modulo p");
+        check(Ecc_Point::fromLimbs(P.xLimbs(), P.yLimbs(), id) == P, "a point rebuilt from its limbs");
+        check(same(-P, RefPoint{R.x, subMod(BigInt(), R.y, c.p), false}), "negation");
+        check(same(P + -P, RefPoint{BigInt(), BigInt(), true}), "P + -P is the point at infinity");
+        Ecc_Point Q = P;
+        Q.setY(R.y + BigInt(1UL));
+        check(!(Q == P) && Q.getY() == addMod(R.y, BigInt(1UL), c.p), "setY()");
+        check(Ecc_Point(id).getX() == BigInt() && Ecc_Point(id).toRawBytes() == std::vector<unsigned char>(
+                  Ecc_Point::rawSize(id), 0), "coordinates of the point at infinity");
+    }
+}
+
+// n checks u1 G + u2 Q = R with Q = d G and R computed by the reference.
+std::vector<SignatureCheck> validChecks(CurveId id, size_t n) {
+    const CurveParameters& c = CurveContext::instance(id).params();
+    const RefPoint G = refOf(Ecc_Point::generator(id));
+    std::vector<SignatureCheck> checks;
+    for (size_t i = 0; i < n; ++i) {
+        const RefPoint Q = refMul(G, randomBelow(c.n - BigInt(1UL)) + BigInt(1UL), c);
+        SignatureCheck s;
+        s.u1 = randomBelow(c.n);
+        s.u2 = randomBelow(c.n);
+        const RefPoint R = refAdd(refMul(G, s.u1, c), refMul(Q, s.u2, c), c);
+        s.Q = Ecc_Point(Q.x, Q.y, id);
+        s.R = R.infinity ? Ecc_Point(id) : Ecc_Point(R.x, R.y, id);
+        checks.push_back(s);
+    }
+    return checks;
+}
+
+void testBatchVerify() {
+    for (CurveId id : CURVES) {
+        std::vector<SignatureCheck> checks = validChecks(id, 6);
+        for (unsigned threads : {1u, 0u}) {
+            check(batchVerify(checks, threads), "batch of valid equations");
+            check(batchVerify(std::vector<SignatureCheck>(1, checks[0]), threads), "a single valid equation");
+        }
+        check(batchVerify(std::vector<SignatureCheck>(), 1), "empty batch");
+
+        // one wrong equation in the middle, then a wrong scalar
+        std::vector<SignatureCheck> bad = checks;
+        bad[3].R = bad[3].R + Ecc_Point::generator(id);
+        check(!batchVerify(bad, 1) && !batchVerify(bad, 0), "batch with a wrong point");
+        bad = checks;
+        bad[5].u2 = bad[5].u2 + BigInt(1UL);
+        check(!batchVerify(bad, 1), "batch with a wrong scalar");
+        bad = checks;
+        bad[0].R = -bad[0].R;
+        check(!batchVerify(bad, 1), "batch with a negated point");
+    }
+
+    std::vector<SignatureCheck> mixed = validChecks(CurveId::P256, 2);
+    mixed.push_back(validChecks(CurveId::Secp256k1, 1)[0]);
+    bool thrown = false;
+    try {
+        batchVerify(mixed, 1);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    check(thrown, "a batch over two curves is rejected");
+}
+
+// A SEC1 encoding written from the reference coordinates.
+std::vector<unsigned char> sec1(const RefPoint& P, size_t width, bool compressed) {
+    std::vector<unsigned char> out(1, compressed ? (P.y.testBit(0) ? 0x03 : 0x02) : 0x04);
+    for (const BigInt* v : {&P.x, &P.y}) {
+        std::vector<unsigned char> le(width);
+        v->toBytes(le.data(), width);
+        out.insert(out.end(), le.rbegin(), le.rend());
+        if (compressed) break;
+    }
+    return out;
+}
+
+bool rejected(const std::vector<unsigned char>& bytes, CurveId id) {
+    try {
+        Ecc_Point::fromBytes(bytes, id);
+    } catch (const std::invalid_argument&) {
+        return true;
+    }
+    return false;
+}
+
+void testEncoding() {
+    for (CurveId id : CURVES) {
+        const CurveParameters& c = CurveContext::instance(id).params();
+        const size_t width = (c.p.bitSize() + 7) / 8;
+        check(Ecc_Point::encodedSize(id, true) == 1 + width && Ecc_Point::encodedSize(id, false) == 1 + 2 * width,
+              "SEC1 encoding sizes");
+
+        const RefPoint G = refOf(Ecc_Point::generator(id));
+        std::vector<RefPoint> points;
+        for (int i = 0; i < 6; ++i) points.push_back(refMul(G, randomBelow(c.n - BigInt(1UL)) + BigInt(1UL), c));
+        bool encodes = true, decodes = true;
+        std::vector<unsigned char> batch;
+        for (const RefPoint& R : points) {
+            const Ecc_Point P(R.x, R.y, id);
+            for (bool compressed : {true, false}) {
+                const std::vector<unsigned char> expected = sec1(R, width, compressed);
+                encodes = encodes && P.toBytes(compressed) == expected;
+                decodes = decodes && same(Ecc_Point::fromBytes(expected, id), R);
+            }
+            const std::vector<unsigned char> compressed = sec1(R, width, true);
+            batch.insert(batch.end(), compressed.begin(), compressed.end());
+        }
+        check(encodes, "SEC1 encoding against the reference");
+        check(decodes, "SEC1 decoding and decompression");
+        check(Ecc_Point(id).toBytes() == std::vector<unsigned char>(1, 0x00) &&
+                  Ecc_Point::fromBytes(std::vector<unsigned char>(1, 0x00), id).isInfinity,
+              "SEC1 encoding of the point at infinity");
+
+        for (unsigned threads : {1u, 0u}) {
+            const std::vector<Ecc_Point> decoded = decompressPoints(batch, id, threads);
+            bool all = decoded.size() == points.size();
+            for (size_t i = 0; i < points.size() && all; ++i) all = same(decoded[i], points[i]);
+            check(all, "decompressPoints()");
+        }
+
+        // an x with x^3 + ax + b a non-residue, by Euler's criterion
+        const BigInt minusOne = c.p - BigInt(1UL);
+        RefPoint missing = {BigInt(), BigInt(), false};
+        do {
+            missing.x = randomBelow(c.p);
+            const BigInt rhs = addMod(mulMod(addMod(mulMod(missing.x, missing.x, c.p), c.a, c.p), missing.x, c.p),
+                                      c.b, c.p);
+            missing.y = rhs.modPow(minusOne.rightShift(1), c.p);
+        } while (!(missing.y == minusOne));
+        missing.y = BigInt();
+
+        const RefPoint& R = points[0];
+        std::vector<unsigned char> bytes = sec1(R, width, true);
+        bytes[0] = 0x05;
+        check(rejected(bytes, id), "an unknown SEC1 tag is rejected");
+        check(rejected(sec1(missing, width, true), id), "an x without a point is rejected");
+        const RefPoint high = {c.p, R.y, false};
+        check(rejected(sec1(high, width, true), id), "x >= p is rejected");
+        const RefPoint shifted = {R.x, addMod(R.y, BigInt(1UL), c.p), false};
+        check(rejected(sec1(shifted, width, false), id), "an uncompressed point off the curve is rejected");
+        const RefPoint tooHigh = {R.x, c.p, false};
+        check(rejected(sec1(tooHigh, width, false), id), "y >= p is rejected");
+        bytes = sec1(R, width, true);
+        bytes.pop_back();
+        check(rejected(bytes, id), "a short compressed encoding is rejected");
+        bytes = sec1(R, width, false);
+        bytes[0] = 0x02;
+        check(rejected(bytes, id), "a compressed tag on an uncompressed encoding is rejected");
+        check(rejected(std::vector<unsigned char>(2, 0x00), id), "a long encoding of infinity is rejected");
+        check(rejected(std::vector<unsigned char>(), id), "an empty encoding is rejected");
+
+        bool thrown = false;
+        try {
+            decompressPoints(std::vector<unsigned char>(batch.begin(), batch.end() - 1), id, 1);
+        } catch (const std::invalid_argument&) {
+            thrown = true;
+        }
+        check(thrown, "decompressPoints() rejects a partial encoding");
+        thrown = false;
+        std::vector<unsigned char> withMissing = batch;
+        const std::vector<unsigned char> none = sec1(missing, width, true);
+        std::copy(none.begin(), none.end(), withMissing.begin() + 2 * (1 + width));
+        try {
+            decompressPoints(withMissing, id, 0);
+        } catch (const std::invalid_argument&) {
+            thrown = true;
+        }
+        check(thrown, "decompressPoints() rejects an x without a point");
+    }
+}
+
+} // namespace
+
+int main() {
+    testCoordinates();
+    testConstantTimeMultiplication();
+    testBatchVerify();
+    testEncoding();
+    return testResult("ecc tests");
+}
@@ -0,0 +1,176 @@
+#include "../include/interpolation.hpp"
+#include "../include/polynomial.hpp"
+#include "test_common.hpp"
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Subproduct-tree interpolation, multipoint evaluation and barycentric evaluation against Horner's
+// rule and the O(n^2) Lagrange interpolate(), on random point sets on both sides of the leaf and
+// direct-weight thresholds.
+
+namespace {
+
+const char* const BN254_R = "30644e72e131a029b85045b68181585d2833e84879b9709143e1f593f0000001"; // NTT-friendly
+const char* const P256_P = "ffffffff00000001000000000000000000000000ffffffffffffffffffffffff";  // not NTT-friendly
+
+BigInt horner(const std::vector<BigInt>& coefficients, const BigInt& x, const BigInt& mod) {
+    BigInt acc;
+    for (size_t i = coefficients.size(); i-- > 0;) acc = addMod(mulMod(acc, x, mod), coefficients[i], mod);
+    return acc;
+}
+
+std::vector<BigInt> coefficientsOf(const Polynomial& f) {
+    std::vector<BigInt> c(f.size());
+    for (size_t i = 0; i < f.size(); ++i) c[i] = f.coefficient(i);
+    return c;
+}
+
+// Distinct random x-coordinates.
+std::vector<BigInt> distinctPoints(size_t n, const BigInt& mod) {
+    std::vector<BigInt> xs;
+    while (xs.size() < n) {
+        const BigInt x = randomBelow(mod);
+        bool fresh = true;
+        for (const BigInt& seen : xs) fresh = fresh && !(seen == x);
+        if (fresh) xs.push_back(x);
+    }
+    return xs;
+}
+
+std::vector<Data> dataOf(const std::vector<BigInt>& xs, const std::vector<BigInt>& ys, const BigInt& mod) {
+    std::vector<Data> data;
+    const std::string modStr = mod.toString(10);
+    for (size_t i = 0; i < xs.size(); ++i) data.push_back(Data(xs[i].toString(10), ys[i].toString(10), modStr));
+    return data;
+}
+
+void checkPointSet(const BigInt& mod, size_t n) {
+    const std::vector<BigInt> xs = distinctPoints(n, mod), ys = randomVector(n, mod);
+    const Interpolator interpolator(xs, mod, 1);
+
+    // prod (X - x_i) by one linear factor at a time
+    std::vector<BigInt> vanishing(1, BigInt(1UL));
+    for (const BigInt& x : xs) {
+        std::vector<BigInt> next(vanishing.size() + 1);
+        for (size_t i = 0; i < vanishing.size(); ++i) {
+            next[i + 1] = addMod(next[i + 1], vanishing[i], mod);
+            next[i] = subMod(next[i], mulMod(vanishing[i], x, mod), mod);
+        }
+        vanishing.swap(next);
+    }
+    check(coefficientsOf(interpolator.vanishing()) == vanishing, "vanishing polynomial of the tree");
+
+    const Polynomial f = interpolator.interpolate(ys);
+    const std::vector<BigInt> c = coefficientsOf(f);
+    check(f.size() == n, "size of the interpolating polynomial");
+    bool through = true;
+    for (size_t i = 0; i < n; ++i) through = through && horner(c, xs[i], mod) == ys[i];
+    check(through, "interpolating polynomial passes through every point");
+
+    const std::vector<Data> data = dataOf(xs, ys, mod);
+    const std::string modStr = mod.toString(10);
+    const BigInt z = randomBelow(mod);
+    check(horner(c, z, mod) == interpolate(data, z, modStr), "tree interpolation matches Lagrange interpolate()");
+    check(coefficientsOf(interpolator.interpolate(data)) == c, "interpolation from Data points");
+    check(coefficientsOf(Interpolator(xs, mod, 4).interpolate(ys)) == c, "interpolation on four threads");
+
+    // a polynomial larger than the tree is reduced by the root first
+    const std::vector<BigInt> g = randomVector(2 * n + 3, mod);
+    const Polynomial pg(g, mod);
+    std::vector<BigInt> expected(n);
+    for (size_t i = 0; i < n; ++i) expected[i] = horner(g, xs[i], mod);
+    check(interpolator.evaluate(pg) == expected, "multipoint evaluation by the tree");
+    check(multipointEvaluate(pg, xs) == expected, "multipointEvaluate()");
+}
+
+// Evaluations of a domain at random positions and at its own points, against interpolate().
+void checkDomain(const LagrangeDomain& domain, const std::vector<BigInt>& xs, const BigInt& mod, const char* what) {
+    const size_t n = xs.size();
+    const std::vector<BigInt> ys = randomVector(n, mod);
+    const std::vector<Data> data = dataOf(xs, ys, mod);
+    const std::string modStr = mod.toString(10);
+    bool matches = true, basisSums = true;
+    for (int trial = 0; trial < 3; ++trial) {
+        const BigInt z = randomBelow(mod);
+        matches = matches && domain.evaluate(ys, z) == interpolate(data, z, modStr);
+        const std::vector<BigInt> basis = domain.basis(z);
+        BigInt sum, dot;
+        for (size_t i = 0; i < n; ++i) {
+            sum = addMod(sum, basis[i], mod);
+            dot = addMod(dot, mulMod(basis[i], ys[i], mod), mod);
+        }
+        basisSums = basisSums && sum == BigInt(1UL) && dot == domain.evaluate(ys, z);
+    }
+    check(matches, what);
+    check(basisSums, what);
+    bool atPoints = true;
+    for (size_t i = 0; i < n; i += 1 + n / 8) atPoints = atPoints && domain.evaluate(ys, xs[i]) == ys[i];
+    check(atPoints, what);
+}
+
+void testLagrangeDomain() {
+    const BigInt bn(BN254_R, 16);
+    for (size_t n : {1, 40, 300}) {
+        const std::vector<BigInt> xs = distinctPoints(n, bn);
+        const LagrangeDomain domain(xs, bn, 1);
+        bool weights = true;
+        for (size_t i = 0; i < n; i += 1 + n / 8) {
+            BigInt product(1UL);
+            for (size_t j = 0; j < n; ++j) {
+                if (j != i) product = mulMod(product, subMod(xs[i], xs[j], bn), bn);
+            }
+            weights = weights && mulMod(domain.weight(i), product, bn) == BigInt(1UL);
+        }
+        check(weights, "barycentric weights are 1 / prod (x_i - x_j)");
+        checkDomain(domain, xs, bn, "barycentric evaluation over arbitrary points");
+    }
+
+    // a primitive 64th root of unity: c^((r - 1) / 64) with c^((r - 1) / 2) = -1
+    const size_t n = 64;
+    const BigInt minusOne = bn - BigInt(1UL);
+    BigInt c(5UL);
+    while (!(c.modPow(minusOne.rightShift(1), bn) == minusOne)) c = c + BigInt(1UL);
+    const BigInt omega = c.modPow(minusOne / BigInt(static_cast<unsigned long int>(n)), bn);
+    const LagrangeDomain domain(n, omega, bn);
+    std::vector<BigInt> xs(n, BigInt(1UL));
+    for (size_t i = 1; i < n; ++i) xs[i] = mulMod(xs[i - 1], omega, bn);
+    bool points = true;
+    for (size_t i = 0; i < n; ++i) points = points && domain.point(i) == xs[i];
+    check(points, "roots of unity domain points");
+    checkDomain(domain, xs, bn, "barycentric evaluation over roots of unity");
+
+    bool thrown = false;
+    try {
+        LagrangeDomain squared(n, mulMod(omega, omega, bn), bn);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    check(thrown, "a root of unity of smaller order is rejected");
+}
+
+void testInterpolation() {
+    const BigInt bn(BN254_R, 16), p256(P256_P, 16);
+    for (size_t n : {1, 2, 31, 33, 300}) {
+        checkPointSet(bn, n);
+        checkPointSet(p256, n);
+    }
+
+    std::vector<BigInt> repeated = randomVector(5, bn);
+    repeated.push_back(repeated[2] + bn);
+    bool thrown = false;
+    try {
+        Interpolator interpolator(repeated, bn);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    check(thrown, "x-coordinates that coincide modulo the modulus are rejected");
+}
+
+} // namespace
+
+int main() {
+    testInterpolation();
+    testLagrangeDomain();
+    return testResult("interpolation tests");
+}
@@ -0,0 +1,69 @@
+#include "../include/field.hpp"
+#include "../include/ntt.hpp"
+#include "../include/thread_pool.hpp"
+#include "test_common.hpp"
+#include <vector>
+
+// NttDomain transforms below and above NTT_BLOCKED_MIN_SIZE, serially and on a pool, against a direct DFT.
+
+namespace {
+
+typedef MontgomeryField<4> Field;
+typedef Field::Element Element;
+
+const char* const BN254_R = "30644e72e131a029b85045b68181585d2833e84879b9709143e1f593f0000001";
+
+// Outputs compared with the direct sum, spread over the whole transform.
+const size_t SAMPLES = 24;
+
+// sum_i a_i w^(ik) with BigInt arithmetic.
+BigInt directDft(const std::vector<BigInt>& a, const BigInt& w, size_t k, const BigInt& mod) {
+    const BigInt step = w.modPow(BigInt(static_cast<unsigned long int>(k)), mod);
+    BigInt sum, power(1UL);
+    for (size_t i = 0; i < a.size(); ++i) {
+        sum = addMod(sum, mulMod(a[i], power, mod), mod);
+        power = mulMod(power, step, mod);
+    }
+    return sum;
+}
+
+void checkTransform(const Field& field, size_t n, ThreadPool* pool, const char* what) {
+    const BigInt& mod = field.getMod();
+    const NttDomain<Field> domain(field, n);
+    const std::vector<BigInt> input = randomVector(n, mod);
+    std::vector<Element> a(n);
+    for (size_t i = 0; i < n; ++i) a[i] = field.fromBigInt(input[i]);
+
+    domain.forward(a.data(), pool);
+    unsigned bits = 0;
+    while ((static_cast<size_t>(1) << bits) < n) ++bits;
+    const BigInt w = field.toBigInt(domain.root());
+    bool matches = true;
+    for (size_t s = 0; s < SAMPLES; ++s) {
+        const size_t k = s * (n / SAMPLES) + s % 3;
+        matches = matches && field.toBigInt(a[bitReverse(k, bits)]) == directDft(input, w, k, mod);
+    }
+    check(matches, what);
+
+    domain.inverse(a.data(), pool);
+    bool restored = true;
+    for (size_t i = 0; i < n; ++i) restored = restored && field.toBigInt(a[i]) == input[i];
+    check(restored, what);
+}
+
+void testTransforms() {
+    const Field field(BigInt(BN254_R, 16));
+    ThreadPool pool(4);
+    checkTransform(field, 1 << 10, nullptr, "unblocked transform");
+    checkTransform(field, 1 << 10, &pool, "unblocked transform on a pool");
+    checkTransform(field, NTT_BLOCKED_MIN_SIZE, nullptr, "blocked transform at the threshold");
+    checkTransform(field, 1 << 15, nullptr, "blocked transform");
+    checkTransform(field, 1 << 15, &pool, "blocked transform on a pool");
+}
+
+} // namespace
+
+int main() {
+    testTransforms();
+    return testResult("ntt tests");
+}
@@ -0,0 +1,92 @@
+#include "../include/pairing.hpp"
+#include "../include/thread_pool.hpp"
+#include "test_common.hpp"
+#include <vector>
+
+// Bilinearity, non-degeneracy and the order of the optimal ate pairing of BN254 and BLS12-381, with
+// powers in GT taken by plain square and multiply instead of cyclotomic squaring.
+
+namespace {
+
+template <class F>
+typename PairingEngine<F>::GT powerOf(const PairingEngine<F>& engine, const typename PairingEngine<F>::GT& a,
+                                      const BigInt& e) {
+    typename PairingEngine<F>::GT acc = engine.fp12().one();
+    for (size_t i = e.bitSize(); i-- > 0;) {
+        engine.fp12().mul(acc, acc, acc);
+        if (e.testBit(i)) engine.fp12().mul(acc, acc, a);
+    }
+    return acc;
+}
+
+template <class Tag>
+void checkPairing() {
+    typedef typename PairingCurve<Tag>::Field F;
+    typedef PairingEngine<F> Engine;
+    const Engine& engine = PairingCurve<Tag>::engine();
+    const BigInt& r = engine.order();
+    const typename Engine::G1& P = engine.g1Generator();
+    const typename Engine::G2& Q = engine.g2Generator();
+    const typename Engine::GT& one = engine.fp12().one();
+
+    check(engine.onCurve(P) && engine.onCurve(Q), "generators are on the curves");
+    check(engine.inSubgroup(Q), "the G2 generator is in the subgroup");
+    typename Engine::G1 offCurve = P;
+    engine.field().add(offCurve.y, offCurve.y, engine.field().one());
+    check(!engine.onCurve(offCurve), "a G1 point off the curve");
+    typename Engine::G2 offTwist = Q;
+    engine.fp2().add(offTwist.y, offTwist.y, engine.fp2().one());
+    check(!engine.onCurve(offTwist) && !engine.inSubgroup(offTwist), "a G2 point off the twist");
+
+    typename Engine::GT e;
+    engine.pairing(e, P, Q);
+    check(!(e == one), "e(P, Q) is not 1");
+    check(powerOf(engine, e, r) == one, "e(P, Q)^r = 1");
+
+    const BigInt a = randomBelow(r), b = randomBelow(r);
+    typename Engine::G1 aP;
+    typename Engine::G2 bQ, aQ;
+    engine.mul(aP, P, a);
+    engine.mul(bQ, Q, b);
+    engine.mul(aQ, Q, a);
+    typename Engine::GT lhs, swapped;
+    engine.pairing(lhs, aP, bQ);
+    check(lhs == powerOf(engine, e, mulMod(a, b, r)), "e(aP, bQ) = e(P, Q)^(ab)");
+    engine.pairing(lhs, aP, Q);
+    engine.pairing(swapped, P, aQ);
+    check(lhs == swapped && lhs == powerOf(engine, e, a), "e(aP, Q) = e(P, aQ) = e(P, Q)^a");
+
+    typename Engine::GT cyclotomic;
+    engine.fp12().cyclotomicPow(cyclotomic, e, a);
+    check(cyclotomic == powerOf(engine, e, a), "cyclotomic power against square and multiply");
+
+    typename Engine::G1 infinity = P;
+    infinity.infinity = true;
+    engine.pairing(lhs, infinity, Q);
+    check(lhs == one, "pairing with the point at infinity");
+
+    // e(aP, bQ) e(-abP, Q) = 1, serially and on a pool
+    typename Engine::G1 minusAbP;
+    engine.mul(minusAbP, P, mulMod(a, b, r));
+    engine.field().neg(minusAbP.y, minusAbP.y);
+    const typename Engine::G1 g1[] = {aP, minusAbP};
+    const typename Engine::Prepared g2[] = {engine.prepare(bQ), engine.prepare(Q)};
+    ThreadPool pool(2);
+    check(engine.pairingProductIsOne(g1, g2, 2) && engine.pairingProductIsOne(g1, g2, 2, &pool),
+          "e(aP, bQ) e(-abP, Q) = 1");
+    const typename Engine::G1 wrong[] = {aP, aP};
+    check(!engine.pairingProductIsOne(wrong, g2, 2), "a wrong pairing product is not 1");
+
+    const typename Engine::G2 unprepared[] = {bQ, Q};
+    typename Engine::GT product;
+    engine.multiPairing(product, g1, unprepared, 2, &pool);
+    check(product == one, "multiPairing() of unprepared points");
+}
+
+} // namespace
+
+int main() {
+    checkPairing<BN254>();
+    checkPairing<BLS12_381>();
+    return testResult("pairing tests");
+}
@@ -0,0 +1,184 @@
+#include "../include/polynomial.hpp"
+#include "test_common.hpp"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// Polynomial arithmetic on random inputs, checked against schoolbook BigInt references.
+
+namespace {
+
+const char* const NTT_PRIME = "998244353"; // 119 * 2^23 + 1
+const char* const BN254_R = "30644e72e131a029b85045b68181585d2833e84879b9709143e1f593f0000001"; // 2^28 | r - 1
+const char* const P256_P = "ffffffff00000001000000000000000000000000ffffffffffffffffffffffff"; // p = 3 mod 4
+
+BigInt coefficientOrZero(const Polynomial& f, size_t i) {
+    return i < f.size() ? f.coefficient(i) : BigInt();
+}
+
+bool sameCoefficients(const Polynomial& f, const std::vector<BigInt>& expected) {
+    for (size_t i = 0; i < std::max(f.size(), expected.size()); ++i) {
+        const BigInt e = i < expected.size() ? expected[i] : BigInt();
+        if (!(coefficientOrZero(f, i) == e)) return false;
+    }
+    return true;
+}
+
+std::vector<BigInt> schoolbook(const std::vector<BigInt>& a, const std::vector<BigInt>& b, const BigInt& mod) {
+    std::vector<BigInt> r(a.size() + b.size() - 1);
+    for (size_t i = 0; i < a.size(); ++i) {
+        for (size_t j = 0; j < b.size(); ++j) r[i + j] = addMod(r[i + j], mulMod(a[i], b[j], mod), mod);
+    }
+    return r;
+}
+
+// Both factor orders, serially and on four threads.
+void checkProduct(const BigInt& mod, size_t na, size_t nb, const char* what) {
+    const std::vector<BigInt> a = randomVector(na, mod), b = randomVector(nb, mod);
+    const std::vector<BigInt> expected = schoolbook(a, b, mod);
+    const Polynomial pa(a, mod), pb(b, mod);
+    Polynomial product(static_cast<size_t>(0), mod);
+    multiplyPolynomials(product, pa, pb);
+    check(sameCoefficients(product, expected), what);
+    multiplyPolynomials(product, pb, pa);
+    check(sameCoefficients(product, expected), what);
+    multiplyPolynomials(product, pa, pb, 4);
+    check(sameCoefficients(product, expected), what);
+}
+
+void testProducts() {
+    const BigInt small(NTT_PRIME, 10), bn(BN254_R, 16), p256(P256_P, 16);
+    checkProduct(small, 5, 9, "schoolbook product of short factors");
+    checkProduct(bn, 17, 40, "Kronecker product below the NTT threshold");
+    // 1200 + 849 - 1 = 2048 coefficients, the smallest NTT product
+    checkProduct(small, 1200, 849, "NTT product over a one-limb prime");
+    checkProduct(bn, 1200, 849, "NTT product over the BN254 scalar field");
+    checkProduct(p256, 1200, 849, "Kronecker product over a prime without roots of unity");
+    checkProduct(bn, 2000, 1, "product by a constant");
+
+    Polynomial empty(static_cast<size_t>(0), bn), product(static_cast<size_t>(0), bn);
+    multiplyPolynomials(product, empty, Polynomial(randomVector(10, bn), bn));
+    check(product.size() == 0, "product with the empty polynomial");
+}
+
+BigInt horner(const std::vector<BigInt>& coefficients, const BigInt& x, const BigInt& mod) {
+    BigInt acc;
+    for (size_t i = coefficients.size(); i-- > 0;) acc = addMod(mulMod(acc, x, mod), coefficients[i], mod);
+    return acc;
+}
+
+std::vector<BigInt> coefficientsOf(const Polynomial& f) {
+    std::vector<BigInt> c(f.size());
+    for (size_t i = 0; i < f.size(); ++i) c[i] = f.coefficient(i);
+    return c;
+}
+
+void checkEvaluation(const BigInt& mod, size_t size, const char* what) {
+    const std::vector<BigInt> c = randomVector(size, mod);
+    const Polynomial f(c, mod);
+    // 37 points leave a partial block of interleaved Horner steps; one is not reduced
+    std::vector<BigInt> xs = randomVector(37, mod);
+    xs[5] = xs[5] + mod;
+    const std::vector<BigInt> values = f.evaluate(xs);
+    bool matches = values.size() == xs.size();
+    for (size_t i = 0; i < xs.size() && matches; ++i) {
+        const BigInt expected = horner(c, xs[i] % mod, mod);
+        matches = values[i] == expected && f.evaluate(xs[i]) == expected;
+    }
+    check(matches, what);
+}
+
+void testEvaluation() {
+    const BigInt bn(BN254_R, 16);
+    checkEvaluation(bn, 1, "evaluation of a constant");
+    checkEvaluation(bn, 50, "Horner evaluation in Montgomery form");
+    checkEvaluation(bn, 1000, "Horner evaluation of a long polynomial");
+    checkEvaluation(BigInt(1UL).leftShift(100), 50, "Horner evaluation modulo a power of two");
+}
+
+void testLinearDivision() {
+    const BigInt bn(BN254_R, 16);
+    for (size_t size : {1, 2, 300}) {
+        const std::vector<BigInt> c = randomVector(size, bn);
+        const BigInt z = randomBelow(bn);
+        Polynomial quotient(static_cast<size_t>(0), bn);
+        BigInt remainder;
+        dividePolynomialByLinear(quotient, remainder, Polynomial(c, bn), z);
+        check(remainder == horner(c, z, bn), "remainder of the division by X - z is the value at z");
+
+        // quotient * (X - z) + remainder
+        std::vector<BigInt> back(size);
+        const std::vector<BigInt> q = coefficientsOf(quotient);
+        check(q.size() + 1 == size, "size of the quotient by X - z");
+        back[0] = remainder;
+        for (size_t i = 0; i < q.size(); ++i) {
+            back[i + 1] = addMod(back[i + 1], q[i], bn);
+            back[i] = subMod(back[i], mulMod(q[i], z, bn), bn);
+        }
+        check(back == c, "quotient and remainder of the division by X - z");
+    }
+}
+
+void testVanishingDivision() {
+    const BigInt bn(BN254_R, 16);
+    const std::vector<BigInt> c = randomVector(1000, bn);
+    for (size_t n : {1, 64, 999, 1000, 1500}) {
+        Polynomial quotient(static_cast<size_t>(0), bn), remainder(static_cast<size_t>(0), bn);
+        dividePolynomialByVanishing(quotient, remainder, Polynomial(c, bn), n);
+        check(remainder.size() == n, "size of the remainder by X^n - 1");
+        check(quotient.size() == (c.size() > n ? c.size() - n : 0), "size of the quotient by X^n - 1");
+
+        // quotient * (X^n - 1) + remainder
+        std::vector<BigInt> back(std::max(c.size(), n));
+        const std::vector<BigInt> q = coefficientsOf(quotient);
+        for (size_t i = 0; i < n; ++i) back[i] = remainder.coefficient(i);
+        for (size_t i = 0; i < q.size(); ++i) {
+            back[i + n] = addMod(back[i + n], q[i], bn);
+            back[i] = subMod(back[i], q[i], bn);
+        }
+        back.resize(c.size() > n ? c.size() : n);
+        std::vector<BigInt> padded = c;
+        padded.resize(back.size());
+        check(back == padded, "quotient and remainder of the division by X^n - 1");
+    }
+}
+
+// Long division by a monic-scaled divisor, the reference for dividePolynomials().
+void longDivision(std::vector<BigInt>& q, std::vector<BigInt>& r, const std::vector<BigInt>& a,
+                  const std::vector<BigInt>& b, const BigInt& mod) {
+    r = a;
+    q.assign(a.size() - b.size() + 1, BigInt());
+    const BigInt leadInv = b.back().modInverse(mod);
+    for (size_t k = q.size(); k-- > 0;) {
+        q[k] = mulMod(r[k + b.size() - 1], leadInv, mod);
+        for (size_t j = 0; j < b.size(); ++j) r[k + j] = subMod(r[k + j], mulMod(q[k], b[j], mod), mod);
+    }
+    r.resize(b.size() - 1);
+}
+
+void testDivision() {
+    const BigInt bn(BN254_R, 16), p256(P256_P, 16);
+    const size_t shapes[][2] = {{60, 20}, {40, 39}, {400, 150}, {3000, 1100}};
+    for (const BigInt& mod : {bn, p256}) {
+        for (const size_t* shape : shapes) {
+            std::vector<BigInt> a = randomVector(shape[0], mod), b = randomVector(shape[1], mod);
+            if (b.back() == BigInt()) b.back() = BigInt(1UL);
+            std::vector<BigInt> q, r;
+            longDivision(q, r, a, b, mod);
+            Polynomial quotient(static_cast<size_t>(0), mod), remainder(static_cast<size_t>(0), mod);
+            dividePolynomials(quotient, remainder, Polynomial(a, mod), Polynomial(b, mod));
+            check(sameCoefficients(quotient, q) && sameCoefficients(remainder, r), "division with remainder");
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    testProducts();
+    testEvaluation();
+    testLinearDivision();
+    testVanishingDivision();
+    testDivision();
+    return testResult("polynomial tests");
+}
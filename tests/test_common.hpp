@@ -0,0 +1,83 @@
+/**
+ * @file test_common.hpp
+ * @brief Checks and deterministic inputs shared by the regression tests.
+ *
+ * Every test draws its operands from a fixed-seed generator, so a failure
+ * reproduces on every run, and reports each failed check on stderr instead
+ * of stopping at the first one.
+ */
+
+#ifndef TEST_COMMON_HPP
+#define TEST_COMMON_HPP
+
+#include "../include/bigint.hpp"
+#include <gmp.h>
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <vector>
+
+/**
+ * @brief Get the number of failed checks so far.
+ * @return The failure counter of the test program.
+ */
+inline int& testFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+/**
+ * @brief Records a failure if a condition does not hold.
+ * @param ok The condition.
+ * @param what What was checked, printed on failure.
+ */
+inline void check(bool ok, const char* what) {
+    if (!ok) {
+        std::cerr << "FAILED: " << what << std::endl;
+        ++testFailures();
+    }
+}
+
+/**
+ * @brief Reports the outcome of a test program.
+ * @param name The name of the test.
+ * @return The exit code for main(), 0 if every check passed.
+ */
+inline int testResult(const char* name) {
+    if (testFailures() == 0) std::cout << name << " passed" << std::endl;
+    return testFailures() == 0 ? 0 : 1;
+}
+
+/**
+ * @brief Get the generator all test inputs come from.
+ * @return A Mersenne Twister with a fixed seed.
+ */
+inline std::mt19937_64& testRng() {
+    static std::mt19937_64 rng(0x7e57);
+    return rng;
+}
+
+/**
+ * @brief A random number below a modulus.
+ * @param modulus The bound, positive.
+ * @return A value in [0, modulus), close to uniform.
+ */
+inline BigInt randomBelow(const BigInt& modulus) {
+    std::vector<mp_limb_t> limbs((modulus.bitSize() + 63) / 64 + 1);
+    for (size_t i = 0; i < limbs.size(); ++i) limbs[i] = testRng()();
+    return BigInt::fromLimbs(limbs.data(), limbs.size()) % modulus;
+}
+
+/**
+ * @brief Random values below a modulus.
+ * @param count Number of values.
+ * @param modulus The bound, positive.
+ * @return count values in [0, modulus).
+ */
+inline std::vector<BigInt> randomVector(size_t count, const BigInt& modulus) {
+    std::vector<BigInt> values(count);
+    for (size_t i = 0; i < count; ++i) values[i] = randomBelow(modulus);
+    return values;
+}
+
+#endif // TEST_COMMON_HPP